@@ -35,6 +35,7 @@
 #include "smoke_script.h"
 
 #include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
 #include "BLI_path_util.h"
 #include "BLI_utildefines.h"
 
@@ -180,6 +181,11 @@ MANTA::MANTA(int *res, FluidModifierData *fmd)
   mMeshFromFile = false;
   mParticlesFromFile = false;
 
+  /* Cache read-ahead, the thread is only started once the first frame is prefetched. */
+  mPrefetchFrame = 0;
+  mPrefetchRequest = false;
+  mPrefetchExit = false;
+
   /* Setup Mantaflow in Python. */
   initializeMantaflow();
 
@@ -560,6 +566,16 @@ MANTA::~MANTA()
     cout << "~FLUID: " << mCurrentID << " with res(" << mResX << ", " << mResY << ", " << mResZ
          << ")" << endl;
 
+  /* Stop reading ahead before the solver goes away. */
+  if (mPrefetchThread.joinable()) {
+    {
+      std::lock_guard<mutex> lock(mPrefetchMutex);
+      mPrefetchExit = true;
+    }
+    mPrefetchCondition.notify_one();
+    mPrefetchThread.join();
+  }
+
   /* Destruction string for Python. */
   string tmpString = "";
   vector<string> pythonCommands;
@@ -1426,6 +1442,166 @@ bool MANTA::readGuiding(FluidModifierData *fmd, int framenr, bool sourceDomain)
   return runPythonString(pythonCommands);
 }
 
+/* Upper bounds of the read-ahead window. Files are only read into the file system cache, so
+ * the bounds mainly keep prefetching from evicting the frames that are currently played back. */
+#define FLUID_PREFETCH_FRAMES 8
+#define FLUID_PREFETCH_MAX_BYTES (size_t(1) << 30)
+#define FLUID_PREFETCH_CHUNK_SIZE (size_t(1) << 20)
+
+struct FluidCacheFile {
+  string path;
+  size_t size;
+};
+
+/* Cache files of all prefetched directories, by frame. */
+typedef unordered_map<int, vector<FluidCacheFile>> FluidCacheIndex;
+
+/* Cache files are named `<name>_<frame><extension>`, see `fluid_cache_get_framenr_formatted`. */
+static bool prefetchFrameFromFilename(const string &filename, int *r_framenr)
+{
+  size_t dot = filename.find('.');
+  if (dot == string::npos) {
+    return false;
+  }
+  size_t sep = filename.rfind('_', dot);
+  if (sep == string::npos || sep + 1 == dot) {
+    return false;
+  }
+  size_t start = (filename[sep + 1] == '-') ? sep + 2 : sep + 1;
+  if (start == dot) {
+    return false;
+  }
+  for (size_t i = start; i < dot; i++) {
+    if (filename[i] < '0' || filename[i] > '9') {
+      return false;
+    }
+  }
+  *r_framenr = atoi(filename.c_str() + sep + 1);
+  return true;
+}
+
+static void prefetchIndexBuild(const vector<string> &directories, FluidCacheIndex &index)
+{
+  index.clear();
+  for (const string &directory : directories) {
+    struct direntry *files;
+    unsigned int totfile = BLI_filelist_dir_contents(directory.c_str(), &files);
+    for (unsigned int i = 0; i < totfile; i++) {
+      int framenr;
+      if ((files[i].type & S_IFDIR) || !prefetchFrameFromFilename(files[i].relname, &framenr)) {
+        continue;
+      }
+      index[framenr].push_back({files[i].path, size_t(files[i].s.st_size)});
+    }
+    BLI_filelist_free(files, totfile);
+  }
+}
+
+void MANTA::prefetchThread()
+{
+  FluidCacheIndex index;
+  vector<string> directories;
+  vector<char> buffer(FLUID_PREFETCH_CHUNK_SIZE);
+
+  /* Range of frames that have been read ahead already. */
+  int warm_start = 0, warm_end = -1;
+
+  std::unique_lock<mutex> lock(mPrefetchMutex);
+  while (true) {
+    mPrefetchCondition.wait(lock, [this] { return mPrefetchRequest || mPrefetchExit; });
+    if (mPrefetchExit) {
+      break;
+    }
+    mPrefetchRequest = false;
+    const int framenr = mPrefetchFrame;
+    if (directories != mPrefetchDirectories) {
+      directories = mPrefetchDirectories;
+      index.clear();
+      warm_end = warm_start - 1;
+    }
+    lock.unlock();
+
+    /* Frames missing from the index may have been baked after it was built. */
+    if (index.find(framenr + 1) == index.end()) {
+      prefetchIndexBuild(directories, index);
+    }
+
+    /* Jumping around the timeline invalidates the range that has been read ahead. */
+    if (framenr < warm_start - 1 || framenr > warm_end) {
+      warm_start = framenr + 1;
+      warm_end = framenr;
+    }
+
+    size_t window_size = 0;
+    for (int frame = framenr + 1; frame <= framenr + FLUID_PREFETCH_FRAMES; frame++) {
+      FluidCacheIndex::const_iterator files = index.find(frame);
+      if (files == index.end()) {
+        break;
+      }
+      for (const FluidCacheFile &file : files->second) {
+        window_size += file.size;
+      }
+      if (window_size > FLUID_PREFETCH_MAX_BYTES && frame > framenr + 1) {
+        break;
+      }
+      if (frame <= warm_end) {
+        continue;
+      }
+
+      for (const FluidCacheFile &file : files->second) {
+        FILE *fp = BLI_fopen(file.path.c_str(), "rb");
+        if (!fp) {
+          continue;
+        }
+        while (!mPrefetchRequest && !mPrefetchExit &&
+               fread(buffer.data(), 1, buffer.size(), fp) == buffer.size()) {
+          /* Pass. */
+        }
+        fclose(fp);
+      }
+
+      /* Newer requests take priority, a partially read frame is read again later on. */
+      if (mPrefetchRequest || mPrefetchExit) {
+        break;
+      }
+      warm_end = frame;
+      if (with_debug)
+        cout << "Fluid: Prefetched frame " << frame << endl;
+    }
+
+    lock.lock();
+  }
+}
+
+void MANTA::prefetchCache(FluidModifierData *fmd, int framenr)
+{
+  if (with_debug)
+    cout << "MANTA::prefetchCache()" << endl;
+
+  vector<string> directories;
+  directories.push_back(getDirectory(fmd, FLUID_DOMAIN_DIR_DATA));
+  if (mUsingNoise) {
+    directories.push_back(getDirectory(fmd, FLUID_DOMAIN_DIR_NOISE));
+  }
+  if (mUsingMesh) {
+    directories.push_back(getDirectory(fmd, FLUID_DOMAIN_DIR_MESH));
+  }
+  if (mUsingDrops || mUsingBubbles || mUsingFloats || mUsingTracers) {
+    directories.push_back(getDirectory(fmd, FLUID_DOMAIN_DIR_PARTICLES));
+  }
+
+  {
+    std::lock_guard<mutex> lock(mPrefetchMutex);
+    mPrefetchDirectories = directories;
+    mPrefetchFrame = framenr;
+    mPrefetchRequest = true;
+  }
+  if (!mPrefetchThread.joinable()) {
+    mPrefetchThread = thread(&MANTA::prefetchThread, this);
+  }
+  mPrefetchCondition.notify_one();
+}
+
 bool MANTA::bakeData(FluidModifierData *fmd, int framenr)
 {
   if (with_debug)
@@ -26,12 +26,18 @@
 
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 using std::atomic;
+using std::condition_variable;
+using std::mutex;
 using std::string;
+using std::thread;
 using std::unordered_map;
 using std::vector;
 
@@ -94,6 +100,9 @@ struct MANTA {
   bool readParticles(FluidModifierData *fmd, int framenr, bool resumable);
   bool readGuiding(FluidModifierData *fmd, int framenr, bool sourceDomain);
 
+  /* Read ahead cache files of the frames following framenr (in a background thread). */
+  void prefetchCache(FluidModifierData *fmd, int framenr);
+
   /* Propagate variable changes from RNA to Python. */
   bool updateVariables(FluidModifierData *fmd);
 
@@ -773,6 +782,15 @@ struct MANTA {
   bool mSmokeFromFile;
   bool mNoiseFromFile;
 
+  /* Cache read-ahead, requests are passed from #prefetchCache() to #prefetchThread(). */
+  thread mPrefetchThread;
+  mutex mPrefetchMutex;
+  condition_variable mPrefetchCondition;
+  vector<string> mPrefetchDirectories;
+  int mPrefetchFrame;
+  atomic<bool> mPrefetchRequest;
+  atomic<bool> mPrefetchExit;
+
   int mResX;
   int mResY;
   int mResZ;
@@ -876,6 +894,7 @@ struct MANTA {
   bool initSmokeNoise(struct FluidModifierData *doRnaRefresh = nullptr);
   void initializeMantaflow();
   void terminateMantaflow();
+  void prefetchThread();
   bool runPythonString(vector<string> commands);
   string getRealValue(const string &varName);
   string parseLine(const string &line);
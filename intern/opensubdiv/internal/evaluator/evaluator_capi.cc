@@ -112,6 +112,18 @@ void evaluatePatchesLimit(OpenSubdiv_Evaluator *evaluator,
       patch_coords, num_patch_coords, P, dPdu, dPdv);
 }
 
+void evaluateLimitStencils(OpenSubdiv_Evaluator *evaluator,
+                           const OpenSubdiv_LimitStencils *limit_stencils,
+                           const int start_stencil_index,
+                           const int num_stencils,
+                           float *P,
+                           float *dPdu,
+                           float *dPdv)
+{
+  evaluator->impl->eval_output->evaluateLimitStencils(
+      limit_stencils->limit_stencil_table, start_stencil_index, num_stencils, P, dPdu, dPdv);
+}
+
 void evaluateVarying(OpenSubdiv_Evaluator *evaluator,
                      const int ptex_face_index,
                      float face_u,
@@ -149,6 +161,7 @@ void assignFunctionPointers(OpenSubdiv_Evaluator *evaluator)
   evaluator->evaluateFaceVarying = evaluateFaceVarying;
 
   evaluator->evaluatePatchesLimit = evaluatePatchesLimit;
+  evaluator->evaluateLimitStencils = evaluateLimitStencils;
 }
 
 }  // namespace
@@ -167,3 +180,16 @@ void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator *evaluator)
   openSubdiv_deleteEvaluatorInternal(evaluator->impl);
   OBJECT_GUARDED_DELETE(evaluator, OpenSubdiv_Evaluator);
 }
+
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencils(
+    OpenSubdiv_TopologyRefiner *topology_refiner,
+    const OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords)
+{
+  return openSubdiv_createLimitStencilsInternal(topology_refiner, patch_coords, num_patch_coords);
+}
+
+void openSubdiv_deleteLimitStencils(OpenSubdiv_LimitStencils *limit_stencils)
+{
+  openSubdiv_deleteLimitStencilsInternal(limit_stencils);
+}
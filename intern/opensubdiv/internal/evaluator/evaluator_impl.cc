@@ -28,6 +28,7 @@
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
 #include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/stencilTableFactory.h>
 #include <opensubdiv/osd/cpuEvaluator.h>
 #include <opensubdiv/osd/cpuPatchTable.h>
 #include <opensubdiv/osd/cpuVertexBuffer.h>
@@ -41,6 +42,9 @@
 #include "internal/topology/topology_refiner_impl.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
+using OpenSubdiv::Far::Index;
+using OpenSubdiv::Far::LimitStencilTable;
+using OpenSubdiv::Far::LimitStencilTableFactory;
 using OpenSubdiv::Far::PatchMap;
 using OpenSubdiv::Far::PatchTable;
 using OpenSubdiv::Far::PatchTableFactory;
@@ -519,6 +523,59 @@ class VolatileEvalOutput {
         patch_coord, num_patch_coords, face_varying);
   }
 
+  // NOTE: P must point to a memory of at least float[3]*num_stencils, dPdu and dPdv are either
+  // NULL or point to a memory of the same size.
+  void evalLimitStencils(const LimitStencilTable *limit_stencil_table,
+                         const int start_stencil_index,
+                         const int num_stencils,
+                         float *P,
+                         float *dPdu,
+                         float *dPdv)
+  {
+    // Limit stencils are factorized down to the coarse vertices, which are stored at the
+    // beginning of the source buffer.
+    const float *src = src_data_->BindCpuBuffer();
+    const int *sizes = limit_stencil_table->GetSizes().data();
+    const Index *offsets = limit_stencil_table->GetOffsets().data();
+    const Index *indices = limit_stencil_table->GetControlIndices().data();
+    const float *weights = limit_stencil_table->GetWeights().data();
+    const float *du_weights = limit_stencil_table->GetDuWeights().data();
+    const float *dv_weights = limit_stencil_table->GetDvWeights().data();
+    const bool do_derivatives = (dPdu != NULL && dPdv != NULL);
+    for (int i = 0; i < num_stencils; ++i) {
+      const int stencil_index = start_stencil_index + i;
+      const int size = sizes[stencil_index];
+      const Index offset = offsets[stencil_index];
+      float p[3] = {0.0f, 0.0f, 0.0f};
+      for (int j = 0; j < size; ++j) {
+        const float *co = &src[indices[offset + j] * 3];
+        const float weight = weights[offset + j];
+        p[0] += weight * co[0];
+        p[1] += weight * co[1];
+        p[2] += weight * co[2];
+      }
+      memcpy(&P[i * 3], p, sizeof(p));
+      if (!do_derivatives) {
+        continue;
+      }
+      float du[3] = {0.0f, 0.0f, 0.0f};
+      float dv[3] = {0.0f, 0.0f, 0.0f};
+      for (int j = 0; j < size; ++j) {
+        const float *co = &src[indices[offset + j] * 3];
+        const float du_weight = du_weights[offset + j];
+        const float dv_weight = dv_weights[offset + j];
+        du[0] += du_weight * co[0];
+        du[1] += du_weight * co[1];
+        du[2] += du_weight * co[2];
+        dv[0] += dv_weight * co[0];
+        dv[1] += dv_weight * co[1];
+        dv[2] += dv_weight * co[2];
+      }
+      memcpy(&dPdu[i * 3], du, sizeof(du));
+      memcpy(&dPdv[i * 3], dv, sizeof(dv));
+    }
+  }
+
  private:
   SRC_VERTEX_BUFFER *src_data_;
   SRC_VERTEX_BUFFER *src_varying_data_;
@@ -747,6 +804,19 @@ void CpuEvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_c
   }
 }
 
+void CpuEvalOutputAPI::evaluateLimitStencils(const LimitStencilTable *limit_stencil_table,
+                                             const int start_stencil_index,
+                                             const int num_stencils,
+                                             float *P,
+                                             float *dPdu,
+                                             float *dPdv)
+{
+  assert(start_stencil_index >= 0);
+  assert(start_stencil_index + num_stencils <= limit_stencil_table->GetNumStencils());
+  implementation_->evalLimitStencils(
+      limit_stencil_table, start_stencil_index, num_stencils, P, dPdu, dPdv);
+}
+
 }  // namespace opensubdiv
 }  // namespace blender
 
@@ -890,3 +960,61 @@ void openSubdiv_deleteEvaluatorInternal(OpenSubdiv_EvaluatorImpl *evaluator)
 {
   delete evaluator;
 }
+
+OpenSubdiv_LimitStencils::OpenSubdiv_LimitStencils() : limit_stencil_table(NULL)
+{
+}
+
+OpenSubdiv_LimitStencils::~OpenSubdiv_LimitStencils()
+{
+  delete limit_stencil_table;
+}
+
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencilsInternal(
+    OpenSubdiv_TopologyRefiner *topology_refiner,
+    const OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords)
+{
+  using blender::opensubdiv::vector;
+  TopologyRefiner *refiner = topology_refiner->impl->topology_refiner;
+  if (refiner == NULL || num_patch_coords == 0) {
+    return NULL;
+  }
+  // Group consecutive coordinates of the same ptex face into a single location array.
+  vector<float> s(num_patch_coords), t(num_patch_coords);
+  LimitStencilTableFactory::LocationArrayVec location_arrays;
+  for (int i = 0; i < num_patch_coords; ++i) {
+    s[i] = patch_coords[i].u;
+    t[i] = patch_coords[i].v;
+    if (location_arrays.empty() || location_arrays.back().ptexIdx != patch_coords[i].ptex_face) {
+      LimitStencilTableFactory::LocationArray location_array;
+      location_array.ptexIdx = patch_coords[i].ptex_face;
+      location_array.numLocations = 0;
+      location_array.s = &s[i];
+      location_array.t = &t[i];
+      location_arrays.push_back(location_array);
+    }
+    ++location_arrays.back().numLocations;
+  }
+  LimitStencilTableFactory::Options options;
+  options.generate1stDerivatives = true;
+  const LimitStencilTable *limit_stencil_table = LimitStencilTableFactory::Create(
+      *refiner, location_arrays, NULL, NULL, options);
+  if (limit_stencil_table == NULL) {
+    return NULL;
+  }
+  // Coordinates outside of any patch are skipped by OpenSubdiv, which breaks the one to one
+  // mapping between coordinates and stencils.
+  if (limit_stencil_table->GetNumStencils() != num_patch_coords) {
+    delete limit_stencil_table;
+    return NULL;
+  }
+  OpenSubdiv_LimitStencils *limit_stencils = new OpenSubdiv_LimitStencils();
+  limit_stencils->limit_stencil_table = limit_stencil_table;
+  return limit_stencils;
+}
+
+void openSubdiv_deleteLimitStencilsInternal(OpenSubdiv_LimitStencils *limit_stencils)
+{
+  delete limit_stencils;
+}
@@ -25,6 +25,7 @@
 
 #include <opensubdiv/far/patchMap.h>
 #include <opensubdiv/far/patchTable.h>
+#include <opensubdiv/far/stencilTable.h>
 
 #include "internal/base/memory.h"
 
@@ -130,6 +131,16 @@ class CpuEvalOutputAPI {
                             float *dPdu,
                             float *dPdv);
 
+  // Evaluate limit surface at a range of coordinates of the given limit stencils.
+  //
+  // NOTE: Output arrays must point to a memory of size float[3]*num_stencils.
+  void evaluateLimitStencils(const OpenSubdiv::Far::LimitStencilTable *limit_stencil_table,
+                             const int start_stencil_index,
+                             const int num_stencils,
+                             float *P,
+                             float *dPdu,
+                             float *dPdv);
+
  protected:
   CpuEvalOutput *implementation_;
   OpenSubdiv::Far::PatchMap *patch_map_;
@@ -155,4 +166,21 @@ OpenSubdiv_EvaluatorImpl *openSubdiv_createEvaluatorInternal(
 
 void openSubdiv_deleteEvaluatorInternal(OpenSubdiv_EvaluatorImpl *evaluator);
 
+struct OpenSubdiv_LimitStencils {
+ public:
+  OpenSubdiv_LimitStencils();
+  ~OpenSubdiv_LimitStencils();
+
+  const OpenSubdiv::Far::LimitStencilTable *limit_stencil_table;
+
+  MEM_CXX_CLASS_ALLOC_FUNCS("OpenSubdiv_LimitStencils");
+};
+
+OpenSubdiv_LimitStencils *openSubdiv_createLimitStencilsInternal(
+    struct OpenSubdiv_TopologyRefiner *topology_refiner,
+    const struct OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords);
+
+void openSubdiv_deleteLimitStencilsInternal(OpenSubdiv_LimitStencils *limit_stencils);
+
 #endif  // OPENSUBDIV_EVALUATOR_IMPL_H_
@@ -24,6 +24,7 @@ extern "C" {
 #endif
 
 struct OpenSubdiv_EvaluatorInternal;
+struct OpenSubdiv_LimitStencils;
 struct OpenSubdiv_PatchCoord;
 struct OpenSubdiv_TopologyRefiner;
 
@@ -122,6 +123,20 @@ typedef struct OpenSubdiv_Evaluator {
                                float *dPdu,
                                float *dPdv);
 
+  // Evaluate limit surface at a range of coordinates the given limit stencils were created for.
+  // This is a sparse matrix multiplication of the stencil weights with coarse positions, which
+  // avoids patch lookup and basis evaluation for coordinates which are evaluated over and over
+  // again.
+  //
+  // NOTE: Output arrays must point to a memory of size float[3]*num_stencils.
+  void (*evaluateLimitStencils)(struct OpenSubdiv_Evaluator *evaluator,
+                                const struct OpenSubdiv_LimitStencils *limit_stencils,
+                                const int start_stencil_index,
+                                const int num_stencils,
+                                float *P,
+                                float *dPdu,
+                                float *dPdv);
+
   // Implementation of the evaluator.
   struct OpenSubdiv_EvaluatorImpl *impl;
 } OpenSubdiv_Evaluator;
@@ -131,6 +146,17 @@ OpenSubdiv_Evaluator *openSubdiv_createEvaluatorFromTopologyRefiner(
 
 void openSubdiv_deleteEvaluator(OpenSubdiv_Evaluator *evaluator);
 
+// Create limit stencils for the given patch coordinates, expressed in weights of the coarse
+// vertices. The topology refiner is expected to be refined by an evaluator already.
+//
+// Returns NULL if stencils could not be created for all coordinates.
+struct OpenSubdiv_LimitStencils *openSubdiv_createLimitStencils(
+    struct OpenSubdiv_TopologyRefiner *topology_refiner,
+    const struct OpenSubdiv_PatchCoord *patch_coords,
+    const int num_patch_coords);
+
+void openSubdiv_deleteLimitStencils(struct OpenSubdiv_LimitStencils *limit_stencils);
+
 #ifdef __cplusplus
 }
 #endif
@@ -90,6 +90,24 @@ void RB_dworld_step_simulation(rbDynamicsWorld *world,
                                int maxSubSteps,
                                float timeSubStep);
 
+/* Bulk Transforms ------------------ */
+
+/* Get position and orientation of several bodies of the world in one pass,
+ * in the same format as RB_body_get_position() and RB_body_get_orientation() */
+void RB_dworld_get_body_transforms(rbDynamicsWorld *world,
+                                   rbRigidBody **bodies,
+                                   int num_bodies,
+                                   float (*r_loc)[3],
+                                   float (*r_rot)[4]);
+/* Set location and rotation of several bodies of the world in one pass like
+ * RB_body_set_loc_rot(), activating them when requested */
+void RB_dworld_set_body_transforms(rbDynamicsWorld *world,
+                                   rbRigidBody **bodies,
+                                   int num_bodies,
+                                   const float (*loc)[3],
+                                   const float (*rot)[4],
+                                   int activate);
+
 /* Export -------------------------- */
 
 /* Exports the dynamics world to physics simulator's serialisation format */
@@ -214,6 +214,48 @@ void RB_dworld_step_simulation(rbDynamicsWorld *world,
   world->dynamicsWorld->stepSimulation(timeStep, maxSubSteps, timeSubStep);
 }
 
+/* Bulk Transforms ------------------ */
+
+/* The bodies are accessed directly, the world is only part of the interface to make clear they
+ * must belong to it. Different bodies can be read or written from several threads at once. */
+
+void RB_dworld_get_body_transforms(rbDynamicsWorld * /*world*/,
+                                   rbRigidBody **bodies,
+                                   int num_bodies,
+                                   float (*r_loc)[3],
+                                   float (*r_rot)[4])
+{
+  for (int i = 0; i < num_bodies; i++) {
+    const btTransform &trans = bodies[i]->body->getWorldTransform();
+
+    copy_v3_btvec3(r_loc[i], trans.getOrigin());
+    copy_quat_btquat(r_rot[i], trans.getRotation());
+  }
+}
+
+void RB_dworld_set_body_transforms(rbDynamicsWorld * /*world*/,
+                                   rbRigidBody **bodies,
+                                   int num_bodies,
+                                   const float (*loc)[3],
+                                   const float (*rot)[4],
+                                   int activate)
+{
+  for (int i = 0; i < num_bodies; i++) {
+    btRigidBody *body = bodies[i]->body;
+
+    if (activate) {
+      body->setActivationState(ACTIVE_TAG);
+    }
+
+    btTransform trans;
+    trans.setIdentity();
+    trans.setOrigin(btVector3(loc[i][0], loc[i][1], loc[i][2]));
+    trans.setRotation(btQuaternion(rot[i][1], rot[i][2], rot[i][3], rot[i][0]));
+
+    body->getMotionState()->setWorldTransform(trans);
+  }
+}
+
 /* Export -------------------------- */
 
 /**
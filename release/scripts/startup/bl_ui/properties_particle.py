@@ -384,6 +384,7 @@ class PARTICLE_PT_hair_dynamics(ParticleButtonsPanel, Panel):
 
         col = layout.column()
         col.prop(cloth, "quality", text="Quality Steps", slider=True)
+        col.prop(cloth, "solver_type", text="Solver")
 
         layout.separator()
 
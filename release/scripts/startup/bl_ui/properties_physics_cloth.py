@@ -73,6 +73,8 @@ class PHYSICS_PT_cloth(PhysicButtonsPanel, Panel):
         col.prop(cloth, "quality", text="Quality Steps")
         col = flow.column()
         col.prop(cloth, "time_scale", text="Speed Multiplier")
+        col = flow.column()
+        col.prop(cloth, "solver_type", text="Solver")
 
 
 class PHYSICS_PT_cloth_physical_properties(PhysicButtonsPanel, Panel):
@@ -396,6 +398,9 @@ class PHYSICS_PT_cloth_self_collision(PhysicButtonsPanel, Panel):
         col = flow.column()
         col.prop(cloth, "self_impulse_clamp")
 
+        col = flow.column()
+        col.prop(cloth, "self_collision_broadphase", text="Broadphase")
+
         col = flow.column()
         col.prop_search(cloth, "vertex_group_self_collisions", ob, "vertex_groups", text="Vertex Group")
 
@@ -87,8 +87,9 @@ typedef struct Cloth {
   unsigned char old_solver_type; /* unused, only 1 solver here */
   unsigned char pad2;
   short pad3;
-  struct BVHTree *bvhtree;     /* collision tree for this cloth object */
-  struct BVHTree *bvhselftree; /* collision tree for this cloth object */
+  struct BVHTree *bvhtree;         /* collision tree for this cloth object */
+  struct BVHTree *bvhselftree;     /* collision tree for this cloth object */
+  struct ClothSelfHash *self_hash; /* spatial hash for self collisions, created on demand */
   struct MVertTri *tri;
   struct Implicit_Data *implicit; /* our implicit solver connects to this pointer */
   struct EdgeSet *edgeset;        /* used for selfcollisions */
@@ -232,6 +233,8 @@ int cloth_bvh_collision(struct Depsgraph *depsgraph,
                         float step,
                         float dt);
 
+void cloth_self_hash_free(struct ClothSelfHash *self_hash);
+
 ////////////////////////////////////////////////
 
 /////////////////////////////////////////////////
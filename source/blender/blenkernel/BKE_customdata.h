@@ -33,6 +33,7 @@
 extern "C" {
 #endif
 
+struct BMHeader;
 struct BMesh;
 struct BlendDataReader;
 struct BlendWriter;
@@ -264,6 +265,14 @@ void CustomData_copy_data_named(const struct CustomData *source,
                                 int source_index,
                                 int dest_index,
                                 int count);
+/* Gathers `count` elements from the source indices into consecutive elements starting at
+ * `dest_index`, layers are matched like in #CustomData_copy_data. Source and dest may be the
+ * same CustomData as long as the source and dest elements don't overlap. */
+void CustomData_copy_data_indices(const struct CustomData *source,
+                                  struct CustomData *dest,
+                                  const int *src_indices,
+                                  int dest_index,
+                                  int count);
 void CustomData_copy_elements(int type, void *src_data_ofs, void *dst_data_ofs, int count);
 void CustomData_bmesh_copy_data(const struct CustomData *source,
                                 struct CustomData *dest,
@@ -424,6 +433,18 @@ void CustomData_from_bmesh_block(const struct CustomData *source,
                                  void *src_block,
                                  int dest_index);
 
+/* bulk versions of the above for arrays of elements, copying one layer at a time */
+void CustomData_to_bmesh_elems(const struct CustomData *source,
+                               struct CustomData *dest,
+                               int src_index,
+                               struct BMHeader **elems,
+                               int count);
+void CustomData_from_bmesh_elems(const struct CustomData *source,
+                                 struct CustomData *dest,
+                                 struct BMHeader *const *elems,
+                                 int dest_index,
+                                 int count);
+
 /* query info over types */
 void CustomData_file_write_info(int type, const char **r_struct_name, int *r_struct_num);
 int CustomData_sizeof(int type);
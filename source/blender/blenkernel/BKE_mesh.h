@@ -335,6 +335,8 @@ void BKE_mesh_calc_normals_poly(struct MVert *mverts,
                                 float (*r_polyNors)[3],
                                 const bool only_face_normals);
 void BKE_mesh_calc_normals(struct Mesh *me);
+void BKE_mesh_normals_tag_dirty(struct Mesh *mesh);
+void BKE_mesh_normals_tag_dirty_from_coords(struct Mesh *mesh, const float (*vert_coords)[3]);
 void BKE_mesh_ensure_normals(struct Mesh *me);
 void BKE_mesh_ensure_normals_for_display(struct Mesh *mesh);
 void BKE_mesh_calc_normals_looptri(struct MVert *mverts,
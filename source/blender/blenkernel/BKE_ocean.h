@@ -27,6 +27,7 @@ extern "C" {
 #endif
 
 struct OceanModifierData;
+struct TaskPool;
 
 typedef struct OceanResult {
   float disp[3];
@@ -68,6 +69,10 @@ typedef struct OceanCache {
   int resolution_y;
 
   int baked;
+
+  /* Loads the maps of the frame after the last evaluated one in the background. */
+  struct TaskPool *prefetch_pool;
+  int prefetch_frame;
 } OceanCache;
 
 struct Ocean *BKE_ocean_add(void);
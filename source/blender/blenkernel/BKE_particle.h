@@ -36,6 +36,7 @@ extern "C" {
 #endif
 
 struct ParticleKey;
+struct ParticleSPHGrid;
 struct ParticleSettings;
 struct ParticleSystem;
 struct ParticleSystemModifierData;
@@ -431,7 +432,8 @@ void psys_apply_child_modifiers(struct ParticleThreadContext *ctx,
 
 void psys_sph_init(struct ParticleSimulationData *sim, struct SPHData *sphdata);
 void psys_sph_finalize(struct SPHData *sphdata);
-void psys_sph_density(struct BVHTree *tree, struct SPHData *data, float co[3], float vars[2]);
+void psys_sph_density(struct SPHData *data, float co[3], float vars[2]);
+void psys_sph_grid_free(struct ParticleSPHGrid *grid);
 
 /* for anim.c */
 void psys_get_dupli_texture(struct ParticleSystem *psys,
@@ -77,6 +77,7 @@ extern "C" {
 #define PTCACHE_READ_OLD 3
 
 /* Structs */
+struct BLI_mmap_file;
 struct BlendDataReader;
 struct BlendWriter;
 struct ClothModifierData;
@@ -107,6 +108,9 @@ typedef struct PTCacheData {
 
 typedef struct PTCacheFile {
   FILE *fp;
+  /* Files opened for reading are memory mapped when possible, `fp` is NULL then. */
+  struct BLI_mmap_file *mmap_file;
+  size_t mmap_size, mmap_offset;
 
   int frame, old_format;
   unsigned int totpoint, type;
@@ -190,6 +194,10 @@ typedef struct PTCacheBaker {
   int render;
   int anim_init;
   int quick_step;
+  /* When baking all caches, the number of independent caches baked at the same time, each on its
+   * own depsgraph. Zero or one bakes all caches together on `depsgraph`. With concurrent bakes
+   * `update_progress` is called from the bake threads, though never at the same time. */
+  int concurrent_bakes;
   struct PTCacheID pid;
 
   void (*update_progress)(void *data, float progress, int *cancel);
@@ -329,6 +337,17 @@ int BKE_ptcache_mem_pointers_seek(int point_index,
                                   struct PTCacheMem *pm,
                                   void *cur[BPHYS_TOT_DATA]);
 
+/* Delta filter of cache data that is compressed with #PTCACHE_COMPRESS_DELTA. `stride` is the
+ * size of one element in bytes, `in` and `out` must not overlap. */
+void BKE_ptcache_delta_encode(const unsigned char *in,
+                              unsigned char *out,
+                              size_t len,
+                              size_t stride);
+void BKE_ptcache_delta_decode(const unsigned char *in,
+                              unsigned char *out,
+                              size_t len,
+                              size_t stride);
+
 /* Main cache reading call. */
 int BKE_ptcache_read(PTCacheID *pid, float cfra, bool no_extrapolate_old);
 
@@ -97,6 +97,8 @@ typedef enum eSubdivStatsValue {
   SUBDIV_STATS_SUBDIV_TO_CCG,
   SUBDIV_STATS_SUBDIV_TO_CCG_ELEMENTS,
   SUBDIV_STATS_TOPOLOGY_COMPARE,
+  SUBDIV_STATS_LIMIT_STENCILS_CREATE,
+  SUBDIV_STATS_LIMIT_STENCILS_EVALUATE,
 
   NUM_SUBDIV_STATS_VALUES,
 } eSubdivStatsValue;
@@ -122,6 +124,10 @@ typedef struct SubdivStats {
       double subdiv_to_ccg_elements_time;
       /* Time spent on CCG elements evaluation/initialization. */
       double topology_compare_time;
+      /* Time spent on creating limit stencils for a fixed set of coordinates. */
+      double limit_stencils_creation_time;
+      /* Time spent on batched evaluation of limit stencils. */
+      double limit_stencils_evaluation_time;
     };
     double values_[NUM_SUBDIV_STATS_VALUES];
   };
@@ -190,6 +196,14 @@ typedef struct Subdiv {
     /* Indexed by base face index, element indicates total number of ptex
      * faces created for preceding base faces. */
     int *face_ptex_offset;
+    /* Edges, loops and polygons of the last mesh created by #BKE_subdiv_to_mesh,
+     * reused while only coarse vertices change. */
+    struct SubdivMeshTopologyCache *mesh_topology;
+    /* Limit stencils for the grid elements of #BKE_subdiv_to_ccg. They are only created once
+     * grids of the same size are evaluated for a second time. */
+    struct SubdivLimitStencils *ccg_limit_stencils;
+    int ccg_limit_stencils_grid_size;
+    int ccg_num_evaluations;
   } cache_;
 } Subdiv;
 
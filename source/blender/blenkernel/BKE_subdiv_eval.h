@@ -30,7 +30,9 @@ extern "C" {
 #endif
 
 struct Mesh;
+struct OpenSubdiv_PatchCoord;
 struct Subdiv;
+struct SubdivLimitStencils;
 
 /* Returns true if evaluator is ready for use. */
 bool BKE_subdiv_eval_begin(struct Subdiv *subdiv);
@@ -145,6 +147,26 @@ void BKE_subdiv_eval_limit_patch_resolution_point_and_short_normal(struct Subdiv
                                                                    const int normal_offset,
                                                                    const int normal_stride);
 
+/* Limit stencils.
+ *
+ * Weights of coarse vertices for a fixed set of ptex coordinates. Once created for a topology
+ * they evaluate all coordinates for new coarse positions as one batched sparse matrix
+ * multiplication, avoiding per-point patch lookup and basis evaluation. Creation is expensive,
+ * so they are only worth it for coordinates which are evaluated over and over again. */
+
+/* Takes ownership of patch_coords. Returns NULL if stencils can not be created. */
+struct SubdivLimitStencils *BKE_subdiv_eval_limit_stencils_create(
+    struct Subdiv *subdiv, struct OpenSubdiv_PatchCoord *patch_coords, const int num_patch_coords);
+void BKE_subdiv_eval_limit_stencils_free(struct SubdivLimitStencils *limit_stencils);
+
+/* Evaluate limit points of all coordinates of the stencils, derivatives are optional.
+ * The output arrays must have one element per coordinate. */
+void BKE_subdiv_eval_limit_stencils(struct Subdiv *subdiv,
+                                    const struct SubdivLimitStencils *limit_stencils,
+                                    float (*r_P)[3],
+                                    float (*r_dPdu)[3],
+                                    float (*r_dPdv)[3]);
+
 #ifdef __cplusplus
 }
 #endif
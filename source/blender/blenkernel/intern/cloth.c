@@ -483,6 +483,10 @@ void cloth_free_modifier(ClothModifierData *clmd)
       BLI_bvhtree_free(cloth->bvhselftree);
     }
 
+    if (cloth->self_hash) {
+      cloth_self_hash_free(cloth->self_hash);
+    }
+
     /* we save our faces for collision objects */
     if (cloth->tri) {
       MEM_freeN(cloth->tri);
@@ -565,6 +569,10 @@ void cloth_free_modifier_extern(ClothModifierData *clmd)
       BLI_bvhtree_free(cloth->bvhselftree);
     }
 
+    if (cloth->self_hash) {
+      cloth_self_hash_free(cloth->self_hash);
+    }
+
     /* we save our faces for collision objects */
     if (cloth->tri) {
       MEM_freeN(cloth->tri);
@@ -1562,6 +1562,374 @@ static bool cloth_bvh_self_overlap_cb(void *userdata, int index_a, int index_b,
   return false;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Self Collision Spatial Hash
+ *
+ * Alternative to overlapping the self collision BVH with itself: triangle bounds are put in a
+ * uniform grid, hashed into buckets, and candidate pairs are found per triangle in parallel.
+ * Buffers are kept on the cloth between steps, so a step doesn't allocate once they are large
+ * enough.
+ * \{ */
+
+/* Triangles per task when finding pairs, pairs are concatenated in chunk order. */
+#define SELF_HASH_CHUNK_SIZE 256
+/* Cells per axis at most, cell coordinates are clamped to this range. */
+#define SELF_HASH_AXIS_CELLS_MAX 1024
+/* Cells per triangle on average at most, larger cells are used when exceeded. */
+#define SELF_HASH_TRI_CELLS_MAX 16
+
+typedef struct ClothSelfHashEntry {
+  int tri;
+  int cell[3];
+} ClothSelfHashEntry;
+
+typedef struct ClothSelfHashChunk {
+  BVHTreeOverlap *pairs;
+  int pairs_len, pairs_alloc;
+} ClothSelfHashChunk;
+
+typedef struct ClothSelfHash {
+  /* Per triangle bounds and cell range, inflated by the self collision distance. */
+  float (*tri_bounds)[2][3];
+  int (*tri_cells)[2][3];
+  int tri_num;
+
+  float origin[3];
+  float cell_size_inv;
+  /* Largest cell coordinate on each axis, the smallest is zero. */
+  float cell_max[3];
+
+  /* Entries sorted by bucket, `bucket_offsets` has `bucket_num + 1` items. */
+  ClothSelfHashEntry *entries;
+  int entries_num, entries_alloc;
+  int *bucket_offsets;
+  int bucket_num;
+
+  ClothSelfHashChunk *chunks;
+  int chunk_num;
+
+  BVHTreeOverlap *pairs;
+  int pairs_alloc;
+} ClothSelfHash;
+
+typedef struct SelfHashTaskData {
+  ClothModifierData *clmd;
+  ClothSelfHash *hash;
+  float epsilon;
+} SelfHashTaskData;
+
+BLI_INLINE uint self_hash_bucket(const ClothSelfHash *hash, const int cell[3])
+{
+  const uint h = ((uint)cell[0] * 73856093u) ^ ((uint)cell[1] * 19349663u) ^
+                 ((uint)cell[2] * 83492791u);
+  return h & (uint)(hash->bucket_num - 1);
+}
+
+static void self_hash_tri_bounds_cb(void *__restrict userdata,
+                                    const int i,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SelfHashTaskData *data = userdata;
+  const Cloth *cloth = data->clmd->clothObject;
+  const MVertTri *vt = &cloth->tri[i];
+  float(*bounds)[3] = data->hash->tri_bounds[i];
+
+  INIT_MINMAX(bounds[0], bounds[1]);
+  for (int j = 0; j < 3; j++) {
+    minmax_v3v3_v3(bounds[0], bounds[1], cloth->verts[vt->tri[j]].tx);
+  }
+  add_v3_fl(bounds[0], -data->epsilon);
+  add_v3_fl(bounds[1], data->epsilon);
+}
+
+static void self_hash_tri_cells_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SelfHashTaskData *data = userdata;
+  ClothSelfHash *hash = data->hash;
+  const float(*bounds)[3] = hash->tri_bounds[i];
+  int(*cells)[3] = hash->tri_cells[i];
+
+  /* Clamp before converting to int, so extreme or non-finite positions can't overflow. */
+  for (int j = 0; j < 3; j++) {
+    const float lo = floorf((bounds[0][j] - hash->origin[j]) * hash->cell_size_inv);
+    const float hi = floorf((bounds[1][j] - hash->origin[j]) * hash->cell_size_inv);
+    cells[0][j] = (lo > 0.0f) ? (int)min_ff(lo, hash->cell_max[j]) : 0;
+    cells[1][j] = (hi > 0.0f) ? (int)min_ff(hi, hash->cell_max[j]) : 0;
+  }
+}
+
+static int64_t self_hash_entries_count(const ClothSelfHash *hash)
+{
+  int64_t entries_num = 0;
+  for (int i = 0; i < hash->tri_num; i++) {
+    const int(*cells)[3] = hash->tri_cells[i];
+    entries_num += (int64_t)(cells[1][0] - cells[0][0] + 1) * (cells[1][1] - cells[0][1] + 1) *
+                   (cells[1][2] - cells[0][2] + 1);
+  }
+  return entries_num;
+}
+
+BLI_INLINE bool self_hash_bounds_overlap(const float a[2][3], const float b[2][3])
+{
+  return (a[0][0] <= b[1][0] && b[0][0] <= a[1][0]) && (a[0][1] <= b[1][1] && b[0][1] <= a[1][1]) &&
+         (a[0][2] <= b[1][2] && b[0][2] <= a[1][2]);
+}
+
+static void self_hash_chunk_pair_add(ClothSelfHashChunk *chunk, int tri_a, int tri_b)
+{
+  if (chunk->pairs_len == chunk->pairs_alloc) {
+    chunk->pairs_alloc = max_ii(chunk->pairs_alloc * 2, SELF_HASH_CHUNK_SIZE);
+    chunk->pairs = MEM_reallocN(chunk->pairs, sizeof(*chunk->pairs) * (size_t)chunk->pairs_alloc);
+  }
+  chunk->pairs[chunk->pairs_len].indexA = tri_a;
+  chunk->pairs[chunk->pairs_len].indexB = tri_b;
+  chunk->pairs_len++;
+}
+
+static void self_hash_pairs_cb(void *__restrict userdata,
+                               const int chunk_index,
+                               const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SelfHashTaskData *data = userdata;
+  ClothModifierData *clmd = data->clmd;
+  const Cloth *cloth = clmd->clothObject;
+  const ClothSelfHash *hash = data->hash;
+  ClothSelfHashChunk *chunk = &hash->chunks[chunk_index];
+
+  const int tri_start = chunk_index * SELF_HASH_CHUNK_SIZE;
+  const int tri_end = min_ii(tri_start + SELF_HASH_CHUNK_SIZE, hash->tri_num);
+
+  chunk->pairs_len = 0;
+
+  for (int a = tri_start; a < tri_end; a++) {
+    const float(*bounds_a)[3] = hash->tri_bounds[a];
+    const int(*cells_a)[3] = hash->tri_cells[a];
+    int cell[3];
+
+    for (cell[0] = cells_a[0][0]; cell[0] <= cells_a[1][0]; cell[0]++) {
+      for (cell[1] = cells_a[0][1]; cell[1] <= cells_a[1][1]; cell[1]++) {
+        for (cell[2] = cells_a[0][2]; cell[2] <= cells_a[1][2]; cell[2]++) {
+          const uint bucket = self_hash_bucket(hash, cell);
+          for (int k = hash->bucket_offsets[bucket]; k < hash->bucket_offsets[bucket + 1]; k++) {
+            const ClothSelfHashEntry *entry = &hash->entries[k];
+            const int b = entry->tri;
+
+            /* No need for equal combinations (eg. (0,1) & (1,0)), skip other cells sharing
+             * the bucket. */
+            if (b <= a || !equals_v3v3_int(entry->cell, cell)) {
+              continue;
+            }
+
+            const float(*bounds_b)[3] = hash->tri_bounds[b];
+            if (!self_hash_bounds_overlap(bounds_a, bounds_b)) {
+              continue;
+            }
+
+            /* Triangles spanning several cells meet in more than one, only report the pair in
+             * the cell containing the minimum of their overlap. */
+            bool is_first_cell = true;
+            for (int j = 0; j < 3; j++) {
+              const int cell_min = max_ii(cells_a[0][j], hash->tri_cells[b][0][j]);
+              if (cell[j] != cell_min) {
+                is_first_cell = false;
+                break;
+              }
+            }
+            if (!is_first_cell) {
+              continue;
+            }
+
+            if (cloth_bvh_selfcollision_is_active(
+                    clmd, cloth, &cloth->tri[a], &cloth->tri[b])) {
+              self_hash_chunk_pair_add(chunk, a, b);
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+static void self_hash_ensure_size(ClothSelfHash *hash, int tri_num)
+{
+  if (hash->tri_num == tri_num) {
+    return;
+  }
+
+  MEM_SAFE_FREE(hash->tri_bounds);
+  MEM_SAFE_FREE(hash->tri_cells);
+  for (int i = 0; i < hash->chunk_num; i++) {
+    MEM_SAFE_FREE(hash->chunks[i].pairs);
+  }
+  MEM_SAFE_FREE(hash->chunks);
+
+  hash->tri_num = tri_num;
+  hash->tri_bounds = MEM_mallocN(sizeof(*hash->tri_bounds) * (size_t)tri_num, __func__);
+  hash->tri_cells = MEM_mallocN(sizeof(*hash->tri_cells) * (size_t)tri_num, __func__);
+  hash->chunk_num = (int)divide_ceil_u((uint)tri_num, SELF_HASH_CHUNK_SIZE);
+  hash->chunks = MEM_callocN(sizeof(*hash->chunks) * (size_t)hash->chunk_num, __func__);
+}
+
+/**
+ * Find the candidate pairs of triangles for self collisions.
+ *
+ * \return An array owned by the hash, valid until the next call.
+ */
+static BVHTreeOverlap *cloth_self_hash_overlap(ClothModifierData *clmd, uint *r_overlap_num)
+{
+  Cloth *cloth = clmd->clothObject;
+  const int tri_num = (int)cloth->primitive_num;
+
+  *r_overlap_num = 0;
+
+  if (tri_num == 0) {
+    return NULL;
+  }
+
+  if (cloth->self_hash == NULL) {
+    cloth->self_hash = MEM_callocN(sizeof(*cloth->self_hash), __func__);
+  }
+  ClothSelfHash *hash = cloth->self_hash;
+  self_hash_ensure_size(hash, tri_num);
+
+  SelfHashTaskData data = {
+      .clmd = clmd,
+      .hash = hash,
+      .epsilon = clmd->coll_parms->selfepsilon,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, tri_num, &data, self_hash_tri_bounds_cb, &settings);
+
+  /* Cells twice the mean triangle size, so a few large triangles don't make the cells of all
+   * others large too, they are inserted in every cell they overlap instead. */
+  float min[3], max[3];
+  double size_sum = 0.0;
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < tri_num; i++) {
+    const float(*bounds)[3] = hash->tri_bounds[i];
+    minmax_v3v3_v3(min, max, bounds[0]);
+    minmax_v3v3_v3(min, max, bounds[1]);
+    size_sum += max_fff(bounds[1][0] - bounds[0][0],
+                        bounds[1][1] - bounds[0][1],
+                        bounds[1][2] - bounds[0][2]);
+  }
+  float extent[3];
+  sub_v3_v3v3(extent, max, min);
+  const float extent_max = max_fff(extent[0], extent[1], extent[2]);
+  float cell_size = max_fff(
+      2.0f * (float)(size_sum / tri_num), extent_max / SELF_HASH_AXIS_CELLS_MAX, FLT_EPSILON);
+  copy_v3_v3(hash->origin, min);
+
+  /* Grow the cells when large triangles overlap too many of them. */
+  int64_t entries_num;
+  while (true) {
+    hash->cell_size_inv = 1.0f / cell_size;
+    for (int j = 0; j < 3; j++) {
+      hash->cell_max[j] = floorf(min_ff(extent[j] * hash->cell_size_inv,
+                                        (float)SELF_HASH_AXIS_CELLS_MAX));
+    }
+    BLI_task_parallel_range(0, tri_num, &data, self_hash_tri_cells_cb, &settings);
+
+    entries_num = self_hash_entries_count(hash);
+    if (entries_num <= (int64_t)tri_num * SELF_HASH_TRI_CELLS_MAX) {
+      break;
+    }
+    cell_size *= 2.0f;
+  }
+
+  /* Size the bucket table to about twice the number of entries. */
+  const int bucket_num = (int)power_of_2_max_u((uint)entries_num * 2);
+  if (hash->bucket_num != bucket_num) {
+    MEM_SAFE_FREE(hash->bucket_offsets);
+    hash->bucket_offsets = MEM_mallocN(sizeof(int) * (size_t)(bucket_num + 1), __func__);
+    hash->bucket_num = bucket_num;
+  }
+  if (hash->entries_alloc < entries_num) {
+    MEM_SAFE_FREE(hash->entries);
+    hash->entries = MEM_mallocN(sizeof(*hash->entries) * (size_t)entries_num, __func__);
+    hash->entries_alloc = (int)entries_num;
+  }
+  hash->entries_num = (int)entries_num;
+
+  /* Counting sort of the entries into buckets, in triangle order. */
+  int *bucket_offsets = hash->bucket_offsets;
+  memset(bucket_offsets, 0, sizeof(int) * (size_t)(bucket_num + 1));
+  for (int i = 0; i < tri_num; i++) {
+    const int(*cells)[3] = hash->tri_cells[i];
+    int cell[3];
+    for (cell[0] = cells[0][0]; cell[0] <= cells[1][0]; cell[0]++) {
+      for (cell[1] = cells[0][1]; cell[1] <= cells[1][1]; cell[1]++) {
+        for (cell[2] = cells[0][2]; cell[2] <= cells[1][2]; cell[2]++) {
+          bucket_offsets[self_hash_bucket(hash, cell) + 1]++;
+        }
+      }
+    }
+  }
+  for (int i = 0; i < bucket_num; i++) {
+    bucket_offsets[i + 1] += bucket_offsets[i];
+  }
+  for (int i = 0; i < tri_num; i++) {
+    const int(*cells)[3] = hash->tri_cells[i];
+    int cell[3];
+    for (cell[0] = cells[0][0]; cell[0] <= cells[1][0]; cell[0]++) {
+      for (cell[1] = cells[0][1]; cell[1] <= cells[1][1]; cell[1]++) {
+        for (cell[2] = cells[0][2]; cell[2] <= cells[1][2]; cell[2]++) {
+          /* Offsets are shifted back by one while filling. */
+          const uint bucket = self_hash_bucket(hash, cell);
+          ClothSelfHashEntry *entry = &hash->entries[bucket_offsets[bucket]++];
+          entry->tri = i;
+          copy_v3_v3_int(entry->cell, cell);
+        }
+      }
+    }
+  }
+  memmove(bucket_offsets + 1, bucket_offsets, sizeof(int) * (size_t)bucket_num);
+  bucket_offsets[0] = 0;
+
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, hash->chunk_num, &data, self_hash_pairs_cb, &settings);
+
+  int pairs_num = 0;
+  for (int i = 0; i < hash->chunk_num; i++) {
+    pairs_num += hash->chunks[i].pairs_len;
+  }
+  if (hash->pairs_alloc < pairs_num) {
+    MEM_SAFE_FREE(hash->pairs);
+    hash->pairs = MEM_mallocN(sizeof(*hash->pairs) * (size_t)pairs_num, __func__);
+    hash->pairs_alloc = pairs_num;
+  }
+  BVHTreeOverlap *pairs = hash->pairs;
+  for (int i = 0; i < hash->chunk_num; i++) {
+    const ClothSelfHashChunk *chunk = &hash->chunks[i];
+    memcpy(pairs, chunk->pairs, sizeof(*pairs) * (size_t)chunk->pairs_len);
+    pairs += chunk->pairs_len;
+  }
+
+  *r_overlap_num = (uint)pairs_num;
+  return hash->pairs;
+}
+
+void cloth_self_hash_free(ClothSelfHash *self_hash)
+{
+  for (int i = 0; i < self_hash->chunk_num; i++) {
+    MEM_SAFE_FREE(self_hash->chunks[i].pairs);
+  }
+  MEM_SAFE_FREE(self_hash->chunks);
+  MEM_SAFE_FREE(self_hash->tri_bounds);
+  MEM_SAFE_FREE(self_hash->tri_cells);
+  MEM_SAFE_FREE(self_hash->entries);
+  MEM_SAFE_FREE(self_hash->bucket_offsets);
+  MEM_SAFE_FREE(self_hash->pairs);
+  MEM_freeN(self_hash);
+}
+
+/** \} */
+
 int cloth_bvh_collision(
     Depsgraph *depsgraph, Object *ob, ClothModifierData *clmd, float step, float dt)
 {
@@ -1577,6 +1945,7 @@ int cloth_bvh_collision(
   BVHTreeOverlap **overlap_obj = NULL;
   uint coll_count_self = 0;
   BVHTreeOverlap *overlap_self = NULL;
+  BVHTreeOverlap *overlap_self_shared = NULL;
 
   if ((clmd->sim_parms->flags & CLOTH_SIMSETTINGS_FLAG_COLLOBJ) || cloth_bvh == NULL) {
     return 0;
@@ -1623,10 +1992,20 @@ int cloth_bvh_collision(
   }
 
   if (clmd->coll_parms->flags & CLOTH_COLLSETTINGS_FLAG_SELF) {
-    bvhtree_update_from_cloth(clmd, false, true);
+    if (clmd->coll_parms->self_broadphase == CLOTH_SELF_BROADPHASE_HASH) {
+      /* Owned by the hash, not freed here. */
+      overlap_self_shared = cloth_self_hash_overlap(clmd, &coll_count_self);
+      overlap_self = overlap_self_shared;
+    }
+    else {
+      bvhtree_update_from_cloth(clmd, false, true);
 
-    overlap_self = BLI_bvhtree_overlap(
-        cloth->bvhselftree, cloth->bvhselftree, &coll_count_self, cloth_bvh_self_overlap_cb, clmd);
+      overlap_self = BLI_bvhtree_overlap(cloth->bvhselftree,
+                                         cloth->bvhselftree,
+                                         &coll_count_self,
+                                         cloth_bvh_self_overlap_cb,
+                                         clmd);
+    }
   }
 
   do {
@@ -1723,7 +2102,9 @@ int cloth_bvh_collision(
 
   MEM_SAFE_FREE(coll_counts_obj);
 
-  MEM_SAFE_FREE(overlap_self);
+  if (overlap_self != overlap_self_shared) {
+    MEM_SAFE_FREE(overlap_self);
+  }
 
   BKE_collision_objects_free(collobjs);
 
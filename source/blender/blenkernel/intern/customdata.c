@@ -34,6 +34,7 @@
 #include "DNA_hair_types.h"
 #include "DNA_meshdata_types.h"
 
+#include "BLI_alloca.h"
 #include "BLI_bitmap.h"
 #include "BLI_endian_switch.h"
 #include "BLI_math.h"
@@ -42,6 +43,7 @@
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utils.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
@@ -2977,6 +2979,113 @@ void CustomData_copy_data(
   }
 }
 
+/* Gather elements of a fixed size, so the copies compile to plain loads and stores. */
+#define CUSTOMDATA_GATHER_FIXED_SIZE(size) \
+  for (int i = 0; i < count; i++) { \
+    memcpy(POINTER_OFFSET(dst_data, (size_t)i * (size)), \
+           POINTER_OFFSET(src_data, (size_t)src_indices[i] * (size)), \
+           (size)); \
+  } \
+  ((void)0)
+
+static void customdata_copy_data_layer_indices(const CustomData *source,
+                                               CustomData *dest,
+                                               int src_layer_index,
+                                               int dst_layer_index,
+                                               const int *src_indices,
+                                               int dest_index,
+                                               int count)
+{
+  const LayerTypeInfo *typeInfo = layerType_getInfo(source->layers[src_layer_index].type);
+
+  const void *src_data = source->layers[src_layer_index].data;
+  void *dst_data = dest->layers[dst_layer_index].data;
+
+  if (!src_data || !dst_data) {
+    if (!(src_data == NULL && dst_data == NULL)) {
+      CLOG_WARN(&LOG,
+                "null data for %s type (%p --> %p), skipping",
+                layerType_getName(source->layers[src_layer_index].type),
+                (void *)src_data,
+                (void *)dst_data);
+    }
+    return;
+  }
+
+  const size_t size = (size_t)typeInfo->size;
+  dst_data = POINTER_OFFSET(dst_data, (size_t)dest_index * size);
+
+  if (typeInfo->copy == NULL) {
+    /* Plain data layers, the common sizes are copied without a size dependent memcpy call. */
+    switch (size) {
+      case 1:
+        CUSTOMDATA_GATHER_FIXED_SIZE(1);
+        return;
+      case 2:
+        CUSTOMDATA_GATHER_FIXED_SIZE(2);
+        return;
+      case 4:
+        CUSTOMDATA_GATHER_FIXED_SIZE(4);
+        return;
+      case 8:
+        CUSTOMDATA_GATHER_FIXED_SIZE(8);
+        return;
+      case 12:
+        CUSTOMDATA_GATHER_FIXED_SIZE(12);
+        return;
+      case 16:
+        CUSTOMDATA_GATHER_FIXED_SIZE(16);
+        return;
+    }
+  }
+
+  /* Copy runs of consecutive source elements at once. */
+  for (int i = 0; i < count;) {
+    int run = 1;
+    while ((i + run < count) && (src_indices[i + run] == src_indices[i] + run)) {
+      run++;
+    }
+
+    const void *src = POINTER_OFFSET(src_data, (size_t)src_indices[i] * size);
+    void *dst = POINTER_OFFSET(dst_data, (size_t)i * size);
+    if (typeInfo->copy) {
+      typeInfo->copy(src, dst, run);
+    }
+    else {
+      memcpy(dst, src, (size_t)run * size);
+    }
+    i += run;
+  }
+}
+
+#undef CUSTOMDATA_GATHER_FIXED_SIZE
+
+void CustomData_copy_data_indices(
+    const CustomData *source, CustomData *dest, const int *src_indices, int dest_index, int count)
+{
+  if (count <= 0) {
+    return;
+  }
+
+  /* Matches layers like #CustomData_copy_data. */
+  int dest_i = 0;
+  for (int src_i = 0; src_i < source->totlayer; src_i++) {
+    while (dest_i < dest->totlayer && dest->layers[dest_i].type < source->layers[src_i].type) {
+      dest_i++;
+    }
+
+    if (dest_i >= dest->totlayer) {
+      return;
+    }
+
+    if (dest->layers[dest_i].type == source->layers[src_i].type) {
+      customdata_copy_data_layer_indices(
+          source, dest, src_i, dest_i, src_indices, dest_index, count);
+      dest_i++;
+    }
+  }
+}
+
 void CustomData_copy_layer_type_data(const CustomData *source,
                                      CustomData *destination,
                                      int type,
@@ -4207,6 +4316,199 @@ void CustomData_from_bmesh_block(const CustomData *source,
   }
 }
 
+/* -------------------------------------------------------------------- */
+/* Versions of #CustomData_to_bmesh_block and #CustomData_from_bmesh_block for arrays of
+ * elements. The layer lookup is done once, then every layer is copied for a chunk of elements
+ * at a time, with the chunks distributed over threads. */
+
+/* Number of elements copied one layer at a time by a single task. */
+#define CD_BMESH_ELEMS_CHUNK_SIZE 1024
+
+/**
+ * For every layer in \a dest, find the layer of the same type in \a source it is copied
+ * from, or -1. Matches the layer order of #CustomData_to_bmesh_block.
+ */
+static void customdata_bmesh_layer_map(const CustomData *source,
+                                       const CustomData *dest,
+                                       int *r_layer_map)
+{
+  int dest_i = 0;
+  for (int src_i = 0; src_i < source->totlayer && dest_i < dest->totlayer; src_i++) {
+    while (dest_i < dest->totlayer && dest->layers[dest_i].type < source->layers[src_i].type) {
+      r_layer_map[dest_i++] = -1;
+    }
+    if (dest_i < dest->totlayer && dest->layers[dest_i].type == source->layers[src_i].type) {
+      r_layer_map[dest_i++] = src_i;
+    }
+  }
+  while (dest_i < dest->totlayer) {
+    r_layer_map[dest_i++] = -1;
+  }
+}
+
+typedef struct BMeshElemsTaskData {
+  const CustomData *source;
+  CustomData *dest;
+  const int *layer_map;
+  BMHeader *const *elems;
+  /* Index in the mesh layers of the first element. */
+  int index;
+  int count;
+} BMeshElemsTaskData;
+
+static void customdata_to_bmesh_elems_task(void *__restrict userdata,
+                                           const int chunk,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMeshElemsTaskData *data = userdata;
+  const CustomData *dest = data->dest;
+  BMHeader *const *elems = data->elems;
+  const int start = chunk * CD_BMESH_ELEMS_CHUNK_SIZE;
+  const int end = min_ii(start + CD_BMESH_ELEMS_CHUNK_SIZE, data->count);
+
+  for (int dest_i = 0; dest_i < dest->totlayer; dest_i++) {
+    const int src_i = data->layer_map[dest_i];
+    const LayerTypeInfo *typeInfo = layerType_getInfo(dest->layers[dest_i].type);
+    const int offset = dest->layers[dest_i].offset;
+
+    if (src_i == -1) {
+      for (int i = start; i < end; i++) {
+        if (elems[i] == NULL) {
+          continue;
+        }
+        void *dest_data = POINTER_OFFSET(elems[i]->data, offset);
+        if (typeInfo->set_default) {
+          typeInfo->set_default(dest_data, 1);
+        }
+        else {
+          memset(dest_data, 0, typeInfo->size);
+        }
+      }
+      continue;
+    }
+
+    const void *src_data = data->source->layers[src_i].data;
+    for (int i = start; i < end; i++) {
+      if (elems[i] == NULL) {
+        continue;
+      }
+      const void *src = POINTER_OFFSET(src_data, (size_t)(data->index + i) * typeInfo->size);
+      void *dest_data = POINTER_OFFSET(elems[i]->data, offset);
+      if (typeInfo->copy) {
+        typeInfo->copy(src, dest_data, 1);
+      }
+      else {
+        memcpy(dest_data, src, typeInfo->size);
+      }
+    }
+  }
+}
+
+static void customdata_from_bmesh_elems_task(void *__restrict userdata,
+                                             const int chunk,
+                                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMeshElemsTaskData *data = userdata;
+  const CustomData *source = data->source;
+  const CustomData *dest = data->dest;
+  BMHeader *const *elems = data->elems;
+  const int start = chunk * CD_BMESH_ELEMS_CHUNK_SIZE;
+  const int end = min_ii(start + CD_BMESH_ELEMS_CHUNK_SIZE, data->count);
+
+  for (int dest_i = 0; dest_i < dest->totlayer; dest_i++) {
+    const int src_i = data->layer_map[dest_i];
+    if (src_i == -1) {
+      continue;
+    }
+    const LayerTypeInfo *typeInfo = layerType_getInfo(dest->layers[dest_i].type);
+    const int offset = source->layers[src_i].offset;
+    void *dest_data = dest->layers[dest_i].data;
+
+    for (int i = start; i < end; i++) {
+      const void *src = POINTER_OFFSET(elems[i]->data, offset);
+      void *dst = POINTER_OFFSET(dest_data, (size_t)(data->index + i) * typeInfo->size);
+      if (typeInfo->copy) {
+        typeInfo->copy(src, dst, 1);
+      }
+      else {
+        memcpy(dst, src, typeInfo->size);
+      }
+    }
+  }
+}
+
+static void customdata_bmesh_elems_parallel(BMeshElemsTaskData *data, TaskParallelRangeFunc func)
+{
+  const int num_chunks = (data->count + CD_BMESH_ELEMS_CHUNK_SIZE - 1) /
+                         CD_BMESH_ELEMS_CHUNK_SIZE;
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, num_chunks, data, func, &settings);
+}
+
+/**
+ * Allocate the blocks of \a elems and fill them from the elements starting at \a src_index in
+ * \a source. Layers without data in \a source are initialized to their defaults, as with
+ * `use_default_init` in #CustomData_to_bmesh_block.
+ *
+ * \param elems: Elements to fill, NULL items are skipped (the source element is unused).
+ */
+void CustomData_to_bmesh_elems(
+    const CustomData *source, CustomData *dest, int src_index, BMHeader **elems, int count)
+{
+  /* Block allocation uses the memory pool, so it can't be threaded. */
+  for (int i = 0; i < count; i++) {
+    if (elems[i] != NULL) {
+      CustomData_bmesh_alloc_block(dest, &elems[i]->data);
+    }
+  }
+
+  if (dest->totlayer == 0 || count == 0) {
+    return;
+  }
+
+  int *layer_map = BLI_array_alloca(layer_map, dest->totlayer);
+  customdata_bmesh_layer_map(source, dest, layer_map);
+
+  BMeshElemsTaskData data = {
+      .source = source,
+      .dest = dest,
+      .layer_map = layer_map,
+      .elems = elems,
+      .index = src_index,
+      .count = count,
+  };
+  customdata_bmesh_elems_parallel(&data, customdata_to_bmesh_elems_task);
+}
+
+/**
+ * Copy the blocks of \a elems into the elements starting at \a dest_index in \a dest.
+ */
+void CustomData_from_bmesh_elems(const CustomData *source,
+                                 CustomData *dest,
+                                 BMHeader *const *elems,
+                                 int dest_index,
+                                 int count)
+{
+  if (dest->totlayer == 0 || count == 0) {
+    return;
+  }
+
+  int *layer_map = BLI_array_alloca(layer_map, dest->totlayer);
+  customdata_bmesh_layer_map(source, dest, layer_map);
+
+  BMeshElemsTaskData data = {
+      .source = source,
+      .dest = dest,
+      .layer_map = layer_map,
+      .elems = elems,
+      .index = dest_index,
+      .count = count,
+  };
+  customdata_bmesh_elems_parallel(&data, customdata_from_bmesh_elems_task);
+}
+
 void CustomData_file_write_info(int type, const char **r_struct_name, int *r_struct_num)
 {
   const LayerTypeInfo *typeInfo = layerType_getInfo(type);
@@ -170,13 +170,6 @@ typedef struct Vec3f {
   float v[3];
 } Vec3f;
 
-typedef struct BakeAdjPoint {
-  /** vector pointing towards this neighbor */
-  float dir[3];
-  /** distance to */
-  float dist;
-} BakeAdjPoint;
-
 /** Surface data used while processing a frame */
 typedef struct PaintBakeNormal {
   /** current pixel world-space inverted normal */
@@ -199,8 +192,10 @@ typedef struct PaintBakeData {
   float dim[3];
 
   /* adjacency info */
-  /** current global neighbor distances and directions, if required */
-  BakeAdjPoint *bNeighs;
+  /** current global neighbor directions and distances, if required,
+   * kept apart since most effects only read the distances */
+  Vec3f *bNeighDir;
+  float *bNeighDist;
   double average_dist;
   /* space partitioning */
   /** space partitioning grid to optimize brush checks */
@@ -913,8 +908,11 @@ static void free_bakeData(PaintSurfaceData *data)
     if (bData->realCoord) {
       MEM_freeN(bData->realCoord);
     }
-    if (bData->bNeighs) {
-      MEM_freeN(bData->bNeighs);
+    if (bData->bNeighDir) {
+      MEM_freeN(bData->bNeighDir);
+    }
+    if (bData->bNeighDist) {
+      MEM_freeN(bData->bNeighDist);
     }
     if (bData->grid) {
       freeGrid(data);
@@ -2070,7 +2068,7 @@ static Mesh *dynamicPaint_Modifier_apply(DynamicPaintModifierData *pmd, Object *
     }
 
     if (update_normals) {
-      result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+      BKE_mesh_normals_tag_dirty(result);
     }
   }
   /* make a copy of mesh to use as brush data */
@@ -4834,7 +4832,8 @@ static void dynamic_paint_prepare_adjacency_cb(void *__restrict userdata,
 {
   PaintSurfaceData *sData = userdata;
   PaintBakeData *bData = sData->bData;
-  BakeAdjPoint *bNeighs = bData->bNeighs;
+  Vec3f *bNeighDir = bData->bNeighDir;
+  float *bNeighDist = bData->bNeighDist;
   PaintAdjData *adj_data = sData->adj_data;
   Vec3f *realCoord = bData->realCoord;
 
@@ -4845,11 +4844,11 @@ static void dynamic_paint_prepare_adjacency_cb(void *__restrict userdata,
     const int t_index = adj_data->n_target[n_index];
 
     /* dir vec */
-    sub_v3_v3v3(bNeighs[n_index].dir,
+    sub_v3_v3v3(bNeighDir[n_index].v,
                 realCoord[bData->s_pos[t_index]].v,
                 realCoord[bData->s_pos[index]].v);
     /* dist */
-    bNeighs[n_index].dist = normalize_v3(bNeighs[n_index].dir);
+    bNeighDist[n_index] = normalize_v3(bNeighDir[n_index].v);
   }
 }
 
@@ -4857,7 +4856,7 @@ static void dynamicPaint_prepareAdjacencyData(DynamicPaintSurface *surface, cons
 {
   PaintSurfaceData *sData = surface->data;
   PaintBakeData *bData = sData->bData;
-  BakeAdjPoint *bNeighs;
+  float *bNeighDist;
   PaintAdjData *adj_data = sData->adj_data;
 
   int index;
@@ -4866,12 +4865,15 @@ static void dynamicPaint_prepareAdjacencyData(DynamicPaintSurface *surface, cons
     return;
   }
 
-  if (bData->bNeighs) {
-    MEM_freeN(bData->bNeighs);
-  }
-  bNeighs = bData->bNeighs = MEM_mallocN(sData->adj_data->total_targets * sizeof(*bNeighs),
-                                         "PaintEffectBake");
-  if (!bNeighs) {
+  MEM_SAFE_FREE(bData->bNeighDir);
+  MEM_SAFE_FREE(bData->bNeighDist);
+  bData->bNeighDir = MEM_mallocN(sData->adj_data->total_targets * sizeof(*bData->bNeighDir),
+                                 "PaintEffectBakeDir");
+  bNeighDist = bData->bNeighDist = MEM_mallocN(
+      sData->adj_data->total_targets * sizeof(*bNeighDist), "PaintEffectBakeDist");
+  if (!bData->bNeighDir || !bNeighDist) {
+    MEM_SAFE_FREE(bData->bNeighDir);
+    MEM_SAFE_FREE(bData->bNeighDist);
     return;
   }
 
@@ -4889,7 +4891,7 @@ static void dynamicPaint_prepareAdjacencyData(DynamicPaintSurface *surface, cons
     int numOfNeighs = adj_data->n_num[index];
 
     for (int i = 0; i < numOfNeighs; i++) {
-      bData->average_dist += (double)bNeighs[adj_data->n_index[index] + i].dist;
+      bData->average_dist += (double)bNeighDist[adj_data->n_index[index] + i];
     }
   }
   bData->average_dist /= adj_data->total_targets;
@@ -4903,7 +4905,7 @@ static void surface_determineForceTargetPoints(const PaintSurfaceData *sData,
                                                float closest_d[2],
                                                int closest_id[2])
 {
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
+  const Vec3f *bNeighDir = sData->bData->bNeighDir;
   const int numOfNeighs = sData->adj_data->n_num[index];
 
   closest_id[0] = closest_id[1] = -1;
@@ -4912,7 +4914,7 @@ static void surface_determineForceTargetPoints(const PaintSurfaceData *sData,
   /* find closest neigh */
   for (int i = 0; i < numOfNeighs; i++) {
     const int n_index = sData->adj_data->n_index[index] + i;
-    const float dir_dot = dot_v3v3(bNeighs[n_index].dir, force);
+    const float dir_dot = dot_v3v3(bNeighDir[n_index].v, force);
 
     if (dir_dot > closest_d[0] && dir_dot > 0.0f) {
       closest_d[0] = dir_dot;
@@ -4932,8 +4934,8 @@ static void surface_determineForceTargetPoints(const PaintSurfaceData *sData,
       continue;
     }
 
-    const float dir_dot = dot_v3v3(bNeighs[n_index].dir, force);
-    const float closest_dot = dot_v3v3(bNeighs[n_index].dir, bNeighs[closest_id[0]].dir);
+    const float dir_dot = dot_v3v3(bNeighDir[n_index].v, force);
+    const float closest_dot = dot_v3v3(bNeighDir[n_index].v, bNeighDir[closest_id[0]].v);
 
     /* only accept neighbor at "other side" of the first one in relation to force dir
      * so make sure angle between this and closest neigh is greater than first angle. */
@@ -4949,20 +4951,20 @@ static void surface_determineForceTargetPoints(const PaintSurfaceData *sData,
     float force_proj[3];
     float tangent[3];
     const float neigh_diff = acosf(
-        dot_v3v3(bNeighs[closest_id[0]].dir, bNeighs[closest_id[1]].dir));
+        dot_v3v3(bNeighDir[closest_id[0]].v, bNeighDir[closest_id[1]].v));
     float force_intersect;
     float temp;
 
     /* project force vector on the plane determined by these two neighbor points
      * and calculate relative force angle from it. */
-    cross_v3_v3v3(tangent, bNeighs[closest_id[0]].dir, bNeighs[closest_id[1]].dir);
+    cross_v3_v3v3(tangent, bNeighDir[closest_id[0]].v, bNeighDir[closest_id[1]].v);
     normalize_v3(tangent);
     force_intersect = dot_v3v3(force, tangent);
     madd_v3_v3v3fl(force_proj, force, tangent, (-1.0f) * force_intersect);
     normalize_v3(force_proj);
 
     /* get drip factor based on force dir in relation to angle between those neighbors */
-    temp = dot_v3v3(bNeighs[closest_id[0]].dir, force_proj);
+    temp = dot_v3v3(bNeighDir[closest_id[0]].v, force_proj);
     CLAMP(temp, -1.0f, 1.0f); /* float precision might cause values > 1.0f that return infinite */
     closest_d[1] = acosf(temp) / neigh_diff;
     closest_d[0] = 1.0f - closest_d[1];
@@ -4984,7 +4986,7 @@ static void dynamicPaint_doSmudge(DynamicPaintSurface *surface,
 {
   PaintSurfaceData *sData = surface->data;
   PaintBakeData *bData = sData->bData;
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
+  const float *bNeighDist = sData->bData->bNeighDist;
   float max_velocity = 0.0f;
 
   if (!sData->adj_data) {
@@ -5028,7 +5030,7 @@ static void dynamicPaint_doSmudge(DynamicPaintSurface *surface,
         int n_index = closest_id[i];
         if (n_index != -1 && closest_d[i] > 0.0f) {
           float dir_dot = closest_d[i], dir_factor;
-          float speed_scale = eff_scale * smudge_str / bNeighs[n_index].dist;
+          float speed_scale = eff_scale * smudge_str / bNeighDist[n_index];
           PaintPoint *ePoint = &(
               (PaintPoint *)sData->type_data)[sData->adj_data->n_target[n_index]];
 
@@ -5067,6 +5069,8 @@ typedef struct DynamicPaintEffectData {
   float *force;
   ListBase *effectors;
   const void *prevPoint;
+  /** Points written by double buffered effects, #prevPoint is the other buffer. */
+  void *nextPoint;
   const float eff_scale;
 
   uint8_t *point_locks;
@@ -5217,14 +5221,18 @@ static void dynamic_paint_effect_spread_cb(void *__restrict userdata,
   const DynamicPaintSurface *surface = data->surface;
   const PaintSurfaceData *sData = surface->data;
 
+  const PaintPoint *prevPoint = data->prevPoint;
+  PaintPoint *pPoint = &((PaintPoint *)data->nextPoint)[index];
+
+  /* Start from the unmodified point, border pixels are only copied. */
+  *pPoint = prevPoint[index];
+
   if (sData->adj_data->flags[index] & ADJ_BORDER_PIXEL) {
     return;
   }
 
   const int numOfNeighs = sData->adj_data->n_num[index];
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
-  PaintPoint *pPoint = &((PaintPoint *)sData->type_data)[index];
-  const PaintPoint *prevPoint = data->prevPoint;
+  const float *bNeighDist = sData->bData->bNeighDist;
   const float eff_scale = data->eff_scale;
 
   const int *n_index = sData->adj_data->n_index;
@@ -5235,8 +5243,8 @@ static void dynamic_paint_effect_spread_cb(void *__restrict userdata,
     const int n_idx = n_index[index] + i;
     float w_factor;
     const PaintPoint *pPoint_prev = &prevPoint[n_target[n_idx]];
-    const float speed_scale = (bNeighs[n_idx].dist < eff_scale) ? 1.0f :
-                                                                  eff_scale / bNeighs[n_idx].dist;
+    const float speed_scale = (bNeighDist[n_idx] < eff_scale) ? 1.0f :
+                                                              eff_scale / bNeighDist[n_idx];
     const float color_mix = min_fff(pPoint_prev->wetness, pPoint->wetness, 1.0f) * 0.25f *
                             surface->color_spread_speed;
 
@@ -5276,14 +5284,18 @@ static void dynamic_paint_effect_shrink_cb(void *__restrict userdata,
   const DynamicPaintSurface *surface = data->surface;
   const PaintSurfaceData *sData = surface->data;
 
+  const PaintPoint *prevPoint = data->prevPoint;
+  PaintPoint *pPoint = &((PaintPoint *)data->nextPoint)[index];
+
+  /* Start from the unmodified point, border pixels are only copied. */
+  *pPoint = prevPoint[index];
+
   if (sData->adj_data->flags[index] & ADJ_BORDER_PIXEL) {
     return;
   }
 
   const int numOfNeighs = sData->adj_data->n_num[index];
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
-  PaintPoint *pPoint = &((PaintPoint *)sData->type_data)[index];
-  const PaintPoint *prevPoint = data->prevPoint;
+  const float *bNeighDist = sData->bData->bNeighDist;
   const float eff_scale = data->eff_scale;
   float totalAlpha = 0.0f;
 
@@ -5293,8 +5305,8 @@ static void dynamic_paint_effect_shrink_cb(void *__restrict userdata,
   /* Loop through neighboring points */
   for (int i = 0; i < numOfNeighs; i++) {
     const int n_idx = n_index[index] + i;
-    const float speed_scale = (bNeighs[n_idx].dist < eff_scale) ? 1.0f :
-                                                                  eff_scale / bNeighs[n_idx].dist;
+    const float speed_scale = (bNeighDist[n_idx] < eff_scale) ? 1.0f :
+                                                              eff_scale / bNeighDist[n_idx];
     const PaintPoint *pPoint_prev = &prevPoint[n_target[n_idx]];
     float a_factor, ea_factor, w_factor;
 
@@ -5341,7 +5353,7 @@ static void dynamic_paint_effect_drip_cb(void *__restrict userdata,
     return;
   }
 
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
+  const float *bNeighDist = sData->bData->bNeighDist;
   PaintPoint *pPoint = &((PaintPoint *)sData->type_data)[index];
   const PaintPoint *prevPoint = data->prevPoint;
   const PaintPoint *pPoint_prev = &prevPoint[index];
@@ -5379,7 +5391,7 @@ static void dynamic_paint_effect_drip_cb(void *__restrict userdata,
       }
 
       float dir_factor, a_factor;
-      const float speed_scale = eff_scale * force[index * 4 + 3] / bNeighs[n_idx].dist;
+      const float speed_scale = eff_scale * force[index * 4 + 3] / bNeighDist[n_idx];
 
       const unsigned int n_trgt = (unsigned int)n_target[n_idx];
 
@@ -5459,7 +5471,7 @@ static void dynamicPaint_doEffectStep(
     /* Cannot be const, because it is assigned to non-const variable.
      * NOLINTNEXTLINE: readability-non-const-parameter. */
     float *force,
-    PaintPoint *prevPoint,
+    PaintPoint **prevPoint,
     float timescale,
     float steps)
 {
@@ -5479,12 +5491,12 @@ static void dynamicPaint_doEffectStep(
     const float eff_scale = distance_scale * EFF_MOVEMENT_PER_FRAME * surface->spread_speed *
                             timescale;
 
-    /* Copy current surface to the previous points array to read unmodified values */
-    memcpy(prevPoint, sData->type_data, sData->total_points * sizeof(struct PaintPoint));
-
+    /* Read unmodified values from the current surface and write to the other buffer, which
+     * becomes the surface afterwards. Saves copying the whole surface before every step. */
     DynamicPaintEffectData data = {
         .surface = surface,
-        .prevPoint = prevPoint,
+        .prevPoint = sData->type_data,
+        .nextPoint = *prevPoint,
         .eff_scale = eff_scale,
     };
     TaskParallelSettings settings;
@@ -5492,6 +5504,9 @@ static void dynamicPaint_doEffectStep(
     settings.use_threading = (sData->total_points > 1000);
     BLI_task_parallel_range(
         0, sData->total_points, &data, dynamic_paint_effect_spread_cb, &settings);
+
+    SWAP(void *, sData->type_data, data.nextPoint);
+    *prevPoint = data.nextPoint;
   }
 
   /*
@@ -5501,12 +5516,12 @@ static void dynamicPaint_doEffectStep(
     const float eff_scale = distance_scale * EFF_MOVEMENT_PER_FRAME * surface->shrink_speed *
                             timescale;
 
-    /* Copy current surface to the previous points array to read unmodified values */
-    memcpy(prevPoint, sData->type_data, sData->total_points * sizeof(struct PaintPoint));
-
+    /* Read unmodified values from the current surface and write to the other buffer, which
+     * becomes the surface afterwards. Saves copying the whole surface before every step. */
     DynamicPaintEffectData data = {
         .surface = surface,
-        .prevPoint = prevPoint,
+        .prevPoint = sData->type_data,
+        .nextPoint = *prevPoint,
         .eff_scale = eff_scale,
     };
     TaskParallelSettings settings;
@@ -5514,6 +5529,9 @@ static void dynamicPaint_doEffectStep(
     settings.use_threading = (sData->total_points > 1000);
     BLI_task_parallel_range(
         0, sData->total_points, &data, dynamic_paint_effect_shrink_cb, &settings);
+
+    SWAP(void *, sData->type_data, data.nextPoint);
+    *prevPoint = data.nextPoint;
   }
 
   /*
@@ -5526,12 +5544,13 @@ static void dynamicPaint_doEffectStep(
     const size_t point_locks_size = (sData->total_points / 8) + 1;
     uint8_t *point_locks = MEM_callocN(sizeof(*point_locks) * point_locks_size, __func__);
 
-    /* Copy current surface to the previous points array to read unmodified values */
-    memcpy(prevPoint, sData->type_data, sData->total_points * sizeof(struct PaintPoint));
+    /* Copy current surface to the previous points array to read unmodified values,
+     * dripping moves paint to other points so it can't write to the other buffer only. */
+    memcpy(*prevPoint, sData->type_data, sData->total_points * sizeof(struct PaintPoint));
 
     DynamicPaintEffectData data = {
         .surface = surface,
-        .prevPoint = prevPoint,
+        .prevPoint = *prevPoint,
         .eff_scale = eff_scale,
         .force = force,
         .point_locks = point_locks,
@@ -5634,7 +5653,7 @@ static void dynamic_paint_wave_step_cb(void *__restrict userdata,
 
   const DynamicPaintSurface *surface = data->surface;
   const PaintSurfaceData *sData = surface->data;
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
+  const float *bNeighDist = sData->bData->bNeighDist;
   const PaintWavePoint *prevPoint = data->prevPoint;
 
   const float wave_speed = data->wave_speed;
@@ -5661,7 +5680,7 @@ static void dynamic_paint_wave_step_cb(void *__restrict userdata,
   /* calculate force from surrounding points */
   for (int i = 0; i < numOfNeighs; i++) {
     const int n_idx = n_index[index] + i;
-    float dist = bNeighs[n_idx].dist * wave_scale;
+    float dist = bNeighDist[n_idx] * wave_scale;
     const PaintWavePoint *tPoint = &prevPoint[n_target[n_idx]];
 
     if (!dist || tPoint->state > 0) {
@@ -5728,7 +5747,7 @@ static void dynamic_paint_wave_step_cb(void *__restrict userdata,
 static void dynamicPaint_doWaveStep(DynamicPaintSurface *surface, float timescale)
 {
   PaintSurfaceData *sData = surface->data;
-  BakeAdjPoint *bNeighs = sData->bData->bNeighs;
+  const float *bNeighDist = sData->bData->bNeighDist;
   int index;
   int steps, ss;
   float dt, min_dist, damp_factor;
@@ -5751,7 +5770,7 @@ static void dynamicPaint_doWaveStep(DynamicPaintSurface *surface, float timescal
     int numOfNeighs = sData->adj_data->n_num[index];
 
     for (int i = 0; i < numOfNeighs; i++) {
-      average_dist += (double)bNeighs[sData->adj_data->n_index[index] + i].dist;
+      average_dist += (double)bNeighDist[sData->adj_data->n_index[index] + i];
     }
   }
   average_dist *= (double)wave_scale / sData->adj_data->total_targets;
@@ -6258,7 +6277,7 @@ static int dynamicPaint_doStep(Depsgraph *depsgraph,
             if (!sData->adj_data) {
               dynamicPaint_initAdjacencyData(surface, true);
             }
-            if (!bData->bNeighs) {
+            if (!bData->bNeighDist) {
               dynamicPaint_prepareAdjacencyData(surface, true);
             }
           }
@@ -6333,7 +6352,7 @@ static int dynamicPaint_doStep(Depsgraph *depsgraph,
   }
 
   /* surfaces operations that use adjacency data */
-  if (sData->adj_data && bData->bNeighs) {
+  if (sData->adj_data && bData->bNeighDist) {
     /* wave type surface simulation step */
     if (surface->type == MOD_DPAINT_SURFACE_T_WAVE) {
       dynamicPaint_doWaveStep(surface, timescale);
@@ -6345,7 +6364,8 @@ static int dynamicPaint_doStep(Depsgraph *depsgraph,
       PaintPoint *prevPoint;
       float *force = NULL;
 
-      /* Allocate memory for surface previous points to read unchanged values from */
+      /* Allocate memory for surface previous points to read unchanged values from,
+       * effect steps may swap it with the surface points */
       prevPoint = MEM_mallocN(sData->total_points * sizeof(struct PaintPoint),
                               "PaintSurfaceDataCopy");
       if (!prevPoint) {
@@ -6355,7 +6375,7 @@ static int dynamicPaint_doStep(Depsgraph *depsgraph,
       /* Prepare effects and get number of required steps */
       steps = dynamicPaint_prepareEffectStep(depsgraph, surface, scene, ob, &force, timescale);
       for (s = 0; s < steps; s++) {
-        dynamicPaint_doEffectStep(surface, force, prevPoint, timescale, (float)steps);
+        dynamicPaint_doEffectStep(surface, force, &prevPoint, timescale, (float)steps);
       }
 
       /* Free temporary effect data */
@@ -3574,7 +3574,7 @@ static Mesh *create_smoke_geometry(FluidDomainSettings *fds, Mesh *orgmesh, Obje
   }
 
   BKE_mesh_calc_edges(result, false, false);
-  result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+  BKE_mesh_normals_tag_dirty(result);
   return result;
 }
 
@@ -4099,6 +4099,11 @@ static void BKE_fluid_modifier_processDomain(FluidModifierData *fmd,
       break;
   }
 
+  /* Only playing back the cache, read ahead the frames that follow. */
+  if (read_cache && !bake_cache && has_data) {
+    manta_prefetch_cache(fds->fluid, fmd, data_frame);
+  }
+
   /* Trigger bake calls individually */
   if (bake_cache) {
     /* Ensure fresh variables at every animation step */
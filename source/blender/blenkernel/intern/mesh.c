@@ -142,6 +142,12 @@ static void mesh_copy_data(Main *bmain, ID *id_dst, const ID *id_src, const int
 
   BKE_mesh_update_customdata_pointers(mesh_dst, do_tessface);
 
+  if (flag & LIB_ID_COPY_CD_REFERENCE) {
+    /* Copies for evaluation share topology with their source (e.g. before deform modifiers),
+     * avoid computing the same triangulation again for every evaluation. */
+    BKE_mesh_runtime_looptri_reuse(mesh_dst, mesh_src);
+  }
+
   mesh_dst->edit_mesh = NULL;
 
   mesh_dst->mselect = MEM_dupallocN(mesh_dst->mselect);
@@ -1771,10 +1777,11 @@ void BKE_mesh_vert_coords_apply(Mesh *mesh, const float (*vert_coords)[3])
   /* This will just return the pointer if it wasn't a referenced layer. */
   MVert *mv = CustomData_duplicate_referenced_layer(&mesh->vdata, CD_MVERT, mesh->totvert);
   mesh->mvert = mv;
+  /* Keep track of moved vertices, so only normals around them need to be updated. */
+  BKE_mesh_normals_tag_dirty_from_coords(mesh, vert_coords);
   for (int i = 0; i < mesh->totvert; i++, mv++) {
     copy_v3_v3(mv->co, vert_coords[i]);
   }
-  mesh->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
 }
 
 void BKE_mesh_vert_coords_apply_with_mat4(Mesh *mesh,
@@ -1787,7 +1794,7 @@ void BKE_mesh_vert_coords_apply_with_mat4(Mesh *mesh,
   for (int i = 0; i < mesh->totvert; i++, mv++) {
     mul_v3_m4v3(mv->co, mat, vert_coords[i]);
   }
-  mesh->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+  BKE_mesh_normals_tag_dirty(mesh);
 }
 
 void BKE_mesh_vert_normals_apply(Mesh *mesh, const short (*vert_normals)[3])
@@ -297,6 +297,23 @@ Mesh *BKE_mesh_mirror_apply_mirror_on_axis_for_modifier(MirrorModifierData *mmd,
     me->v2 += maxVerts;
   }
 
+  /* reverse the loops, but we keep the first vertex in the face the same,
+   * to ensure that quads are split the same way as on the other side */
+  {
+    int *loop_src_indices = MEM_malloc_arrayN(maxLoops, sizeof(*loop_src_indices), __func__);
+    mp = result->mpoly + maxPolys;
+    for (i = 0; i < maxPolys; i++, mp++) {
+      int *src_indices = &loop_src_indices[mp->loopstart];
+      src_indices[0] = mp->loopstart;
+      for (int j = 1; j < mp->totloop; j++) {
+        src_indices[j] = mp->loopstart + mp->totloop - j;
+      }
+    }
+    CustomData_copy_data_indices(
+        &result->ldata, &result->ldata, loop_src_indices, maxLoops, maxLoops);
+    MEM_freeN(loop_src_indices);
+  }
+
   /* adjust mirrored poly loopstart indices, and reverse loop order (normals) */
   mp = result->mpoly + maxPolys;
   ml = result->mloop;
@@ -304,19 +321,6 @@ Mesh *BKE_mesh_mirror_apply_mirror_on_axis_for_modifier(MirrorModifierData *mmd,
     MLoop *ml2;
     int j, e;
 
-    /* reverse the loop, but we keep the first vertex in the face the same,
-     * to ensure that quads are split the same way as on the other side */
-    CustomData_copy_data(
-        &result->ldata, &result->ldata, mp->loopstart, mp->loopstart + maxLoops, 1);
-
-    for (j = 1; j < mp->totloop; j++) {
-      CustomData_copy_data(&result->ldata,
-                           &result->ldata,
-                           mp->loopstart + j,
-                           mp->loopstart + maxLoops + mp->totloop - j,
-                           1);
-    }
-
     ml2 = ml + mp->loopstart + maxLoops;
     e = ml2[0].e;
     for (j = 0; j < mp->totloop - 1; j++) {
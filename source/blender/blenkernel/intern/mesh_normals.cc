@@ -25,6 +25,7 @@
  * \see bmesh_mesh_normals.c for the equivalent #BMesh functionality.
  */
 
+#include <algorithm>
 #include <climits>
 
 #include "CLG_log.h"
@@ -35,15 +36,21 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_alloca.h"
+#include "BLI_array.hh"
 #include "BLI_bitmap.h"
+#include "BLI_enumerable_thread_specific.hh"
 
 #include "BLI_linklist.h"
 #include "BLI_linklist_stack.h"
+#include "BLI_map.hh"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_span.hh"
 #include "BLI_stack.h"
 #include "BLI_task.h"
+#include "BLI_task.hh"
 #include "BLI_utildefines.h"
+#include "BLI_vector.hh"
 
 #include "BKE_customdata.h"
 #include "BKE_editmesh_cache.h"
@@ -206,6 +213,17 @@ struct MeshCalcNormalsData {
   float (*pnors)[3];
   float (*lnors_weighted)[3];
   float (*vnors)[3];
+  /**
+   * Optional, when set the tasks iterate over these polygons instead of all of them,
+   * and #loop_offsets gives the start of each polygon's loops in #lnors_weighted.
+   */
+  const int *poly_indices;
+  const int *loop_offsets;
+  /**
+   * Optional, when set the tasks iterate over these vertices instead of all of them,
+   * and #vnors is indexed like this array.
+   */
+  const int *vert_indices;
 };
 
 static void mesh_calc_normals_poly_cb(void *__restrict userdata,
@@ -219,11 +237,13 @@ static void mesh_calc_normals_poly_cb(void *__restrict userdata,
 }
 
 static void mesh_calc_normals_poly_prepare_cb(void *__restrict userdata,
-                                              const int pidx,
+                                              const int index,
                                               const TaskParallelTLS *__restrict UNUSED(tls))
 {
   MeshCalcNormalsData *data = (MeshCalcNormalsData *)userdata;
+  const int pidx = data->poly_indices ? data->poly_indices[index] : index;
   const MPoly *mp = &data->mpolys[pidx];
+  const int loopstart = data->loop_offsets ? data->loop_offsets[index] : mp->loopstart;
   const MLoop *ml = &data->mloop[mp->loopstart];
   const MVert *mverts = data->mverts;
 
@@ -266,7 +286,7 @@ static void mesh_calc_normals_poly_prepare_cb(void *__restrict userdata,
     const float *prev_edge = edgevecbuf[nverts - 1];
 
     for (int i = 0; i < nverts; i++) {
-      const int lidx = mp->loopstart + i;
+      const int lidx = loopstart + i;
       const float *cur_edge = edgevecbuf[i];
 
       /* calculate angle between the two poly edges incident on
@@ -282,13 +302,14 @@ static void mesh_calc_normals_poly_prepare_cb(void *__restrict userdata,
 }
 
 static void mesh_calc_normals_poly_finalize_cb(void *__restrict userdata,
-                                               const int vidx,
+                                               const int index,
                                                const TaskParallelTLS *__restrict UNUSED(tls))
 {
   MeshCalcNormalsData *data = (MeshCalcNormalsData *)userdata;
+  const int vidx = data->vert_indices ? data->vert_indices[index] : index;
 
   MVert *mv = &data->mverts[vidx];
-  float *no = data->vnors[vidx];
+  float *no = data->vnors[index];
 
   if (UNLIKELY(normalize_v3(no) == 0.0f)) {
     /* following Mesh convention; we use vertex coordinate itself for normal in this case */
@@ -318,7 +339,7 @@ void BKE_mesh_calc_normals_poly(MVert *mverts,
     BLI_assert((pnors != nullptr) || (numPolys == 0));
     BLI_assert(r_vertnors == nullptr);
 
-    MeshCalcNormalsData data;
+    MeshCalcNormalsData data = {nullptr};
     data.mpolys = mpolys;
     data.mloop = mloop;
     data.mverts = mverts;
@@ -342,7 +363,7 @@ void BKE_mesh_calc_normals_poly(MVert *mverts,
     memset(vnors, 0, sizeof(*vnors) * (size_t)numVerts);
   }
 
-  MeshCalcNormalsData data;
+  MeshCalcNormalsData data = {nullptr};
   data.mpolys = mpolys;
   data.mloop = mloop;
   data.mverts = mverts;
@@ -370,10 +391,221 @@ void BKE_mesh_calc_normals_poly(MVert *mverts,
   MEM_freeN(lnors_weighted);
 }
 
+/**
+ * Indices of the polygons for which \a poly_fn returns true, in ascending order.
+ */
+template<typename PolyFn>
+static blender::Vector<int> mesh_polys_filter(const int numPolys, const PolyFn &poly_fn)
+{
+  using namespace blender;
+  threading::EnumerableThreadSpecific<Vector<int>> polys_local;
+  threading::parallel_for(IndexRange(numPolys), 4096, [&](IndexRange range) {
+    Vector<int> &polys = polys_local.local();
+    for (const int pidx : range) {
+      if (poly_fn(pidx)) {
+        polys.append(pidx);
+      }
+    }
+  });
+
+  Vector<int> polys;
+  for (const Vector<int> &local : polys_local) {
+    polys.extend(local);
+  }
+  std::sort(polys.begin(), polys.end());
+  return polys;
+}
+
+/**
+ * Only recompute the normals of vertices around the moved vertices in \a verts_moved,
+ * i.e. the moved vertices themselves and the vertices of all polygons using at least one of them.
+ * The normals of all other vertices are expected to be valid already.
+ *
+ * Apart from finding the polygons involved, the work and memory used only depend on
+ * the number of affected vertices. The vertex normals are accumulated in the same order as
+ * #BKE_mesh_calc_normals_poly, so the result is the same as recomputing all normals.
+ */
+static void mesh_calc_normals_poly_partial(MVert *mverts,
+                                           int numVerts,
+                                           const MLoop *mloop,
+                                           const MPoly *mpolys,
+                                           int numPolys,
+                                           const BLI_bitmap *verts_moved)
+{
+  using namespace blender;
+
+  const Vector<int> polys_moved = mesh_polys_filter(numPolys, [&](const int pidx) {
+    const MPoly *mp = &mpolys[pidx];
+    for (const MLoop &ml : Span(&mloop[mp->loopstart], mp->totloop)) {
+      if (BLI_BITMAP_TEST(verts_moved, ml.v)) {
+        return true;
+      }
+    }
+    return false;
+  });
+
+  /* Vertices of any polygon using a moved vertex get a new normal. */
+  BLI_bitmap *verts_affected = BLI_BITMAP_NEW(numVerts, __func__);
+  Vector<int> vert_indices;
+  Map<int, int> vert_indices_map;
+  for (const int pidx : polys_moved) {
+    const MPoly *mp = &mpolys[pidx];
+    for (const MLoop &ml : Span(&mloop[mp->loopstart], mp->totloop)) {
+      if (!BLI_BITMAP_TEST(verts_affected, ml.v)) {
+        BLI_BITMAP_ENABLE(verts_affected, ml.v);
+        vert_indices_map.add_new(ml.v, vert_indices.size());
+        vert_indices.append(ml.v);
+      }
+    }
+  }
+  /* Moved vertices which are not used by any polygon get their normal from their position. */
+  for (int vidx = 0; vidx < numVerts; vidx++) {
+    if (BLI_BITMAP_TEST(verts_moved, vidx) && !BLI_BITMAP_TEST(verts_affected, vidx)) {
+      BLI_BITMAP_ENABLE(verts_affected, vidx);
+      vert_indices_map.add_new(vidx, vert_indices.size());
+      vert_indices.append(vidx);
+    }
+  }
+
+  /* All polygons around affected vertices contribute to their normals. */
+  const Vector<int> poly_indices = mesh_polys_filter(numPolys, [&](const int pidx) {
+    const MPoly *mp = &mpolys[pidx];
+    for (const MLoop &ml : Span(&mloop[mp->loopstart], mp->totloop)) {
+      if (BLI_BITMAP_TEST(verts_affected, ml.v)) {
+        return true;
+      }
+    }
+    return false;
+  });
+
+  Array<int> loop_offsets(poly_indices.size());
+  int loops_len = 0;
+  for (const int i : poly_indices.index_range()) {
+    loop_offsets[i] = loops_len;
+    loops_len += mpolys[poly_indices[i]].totloop;
+  }
+
+  float(*vnors)[3] = (float(*)[3])MEM_calloc_arrayN(
+      (size_t)vert_indices.size(), sizeof(*vnors), __func__);
+  float(*lnors_weighted)[3] = (float(*)[3])MEM_malloc_arrayN(
+      (size_t)loops_len, sizeof(*lnors_weighted), __func__);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+
+  MeshCalcNormalsData data = {nullptr};
+  data.mpolys = mpolys;
+  data.mloop = mloop;
+  data.mverts = mverts;
+  data.lnors_weighted = lnors_weighted;
+  data.vnors = vnors;
+
+  /* Prepare weighted loop normals of the relevant polygons only. */
+  data.poly_indices = poly_indices.data();
+  data.loop_offsets = loop_offsets.data();
+  BLI_task_parallel_range(
+      0, (int)poly_indices.size(), &data, mesh_calc_normals_poly_prepare_cb, &settings);
+
+  for (const int i : poly_indices.index_range()) {
+    const MPoly *mp = &mpolys[poly_indices[i]];
+    for (int j = 0; j < mp->totloop; j++) {
+      const uint vidx = mloop[mp->loopstart + j].v;
+      if (BLI_BITMAP_TEST(verts_affected, vidx)) {
+        add_v3_v3(vnors[vert_indices_map.lookup(vidx)], lnors_weighted[loop_offsets[i] + j]);
+      }
+    }
+  }
+
+  data.poly_indices = nullptr;
+  data.loop_offsets = nullptr;
+  data.vert_indices = vert_indices.data();
+  BLI_task_parallel_range(
+      0, (int)vert_indices.size(), &data, mesh_calc_normals_poly_finalize_cb, &settings);
+
+  MEM_freeN(vnors);
+  MEM_freeN(lnors_weighted);
+  MEM_freeN(verts_affected);
+}
+
+/**
+ * Tag vertex normals dirty, in case vertex positions have been changed
+ * without going through #BKE_mesh_normals_tag_dirty_from_coords.
+ *
+ * \note Always use this instead of setting #CD_MASK_NORMAL in `cd_dirty_vert` directly,
+ * otherwise a pending partial update would leave the normals of other vertices outdated.
+ */
+void BKE_mesh_normals_tag_dirty(Mesh *mesh)
+{
+  mesh->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+  MEM_SAFE_FREE(mesh->runtime.vert_normals_dirty_map);
+  mesh->runtime.vert_normals_dirty_len = 0;
+}
+
+/* Above this fraction of moved vertices, recomputing all normals is cheaper. */
+#define MESH_NORMALS_PARTIAL_UPDATE_MAX_FACTOR 8
+
+/**
+ * Tag vertex normals dirty before replacing the mesh vertex positions with \a vert_coords,
+ * keeping track of which vertices actually moved, so that a following
+ * #BKE_mesh_ensure_normals only has to update the normals around them.
+ */
+void BKE_mesh_normals_tag_dirty_from_coords(Mesh *mesh, const float (*vert_coords)[3])
+{
+  Mesh_Runtime *runtime = &mesh->runtime;
+  const int max_moved_len = mesh->totvert / MESH_NORMALS_PARTIAL_UPDATE_MAX_FACTOR;
+
+  if (runtime->cd_dirty_vert & CD_MASK_NORMAL) {
+    if (runtime->vert_normals_dirty_map == nullptr) {
+      /* Normals are already dirty for unknown vertices, nothing to track. */
+      return;
+    }
+  }
+  else {
+    runtime->cd_dirty_vert |= CD_MASK_NORMAL;
+    if (max_moved_len == 0) {
+      BKE_mesh_normals_tag_dirty(mesh);
+      return;
+    }
+    if (runtime->vert_normals_dirty_map == nullptr) {
+      runtime->vert_normals_dirty_map = BLI_BITMAP_NEW(mesh->totvert, __func__);
+    }
+    else {
+      BLI_bitmap_set_all(runtime->vert_normals_dirty_map, false, mesh->totvert);
+    }
+    runtime->vert_normals_dirty_len = 0;
+  }
+
+  BLI_bitmap *verts_moved = runtime->vert_normals_dirty_map;
+  const MVert *mv = mesh->mvert;
+  for (int i = 0; i < mesh->totvert; i++, mv++) {
+    if (!equals_v3v3(mv->co, vert_coords[i]) && !BLI_BITMAP_TEST(verts_moved, i)) {
+      BLI_BITMAP_ENABLE(verts_moved, i);
+      if (++runtime->vert_normals_dirty_len > max_moved_len) {
+        BKE_mesh_normals_tag_dirty(mesh);
+        return;
+      }
+    }
+  }
+}
+
 void BKE_mesh_ensure_normals(Mesh *mesh)
 {
   if (mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL) {
-    BKE_mesh_calc_normals(mesh);
+    if (mesh->runtime.vert_normals_dirty_map != nullptr) {
+      mesh_calc_normals_poly_partial(mesh->mvert,
+                                     mesh->totvert,
+                                     mesh->mloop,
+                                     mesh->mpoly,
+                                     mesh->totpoly,
+                                     mesh->runtime.vert_normals_dirty_map);
+      mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
+    }
+    else {
+      BKE_mesh_calc_normals(mesh);
+    }
+    MEM_SAFE_FREE(mesh->runtime.vert_normals_dirty_map);
+    mesh->runtime.vert_normals_dirty_len = 0;
   }
   BLI_assert((mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL) == 0);
 }
@@ -410,6 +642,11 @@ void BKE_mesh_ensure_normals_for_display(Mesh *mesh)
           (size_t)mesh->totpoly, sizeof(*poly_nors), __func__);
     }
 
+    /* When only a few vertices moved, the polygon normals still have to be computed,
+     * but vertex normals only need an update around the moved vertices. */
+    const bool do_vert_normals_partial = do_vert_normals &&
+                                         (mesh->runtime.vert_normals_dirty_map != nullptr);
+
     /* calculate poly/vert normals */
     BKE_mesh_calc_normals_poly(mesh->mvert,
                                nullptr,
@@ -419,7 +656,16 @@ void BKE_mesh_ensure_normals_for_display(Mesh *mesh)
                                mesh->totloop,
                                mesh->totpoly,
                                poly_nors,
-                               !do_vert_normals);
+                               !do_vert_normals || do_vert_normals_partial);
+
+    if (do_vert_normals_partial) {
+      mesh_calc_normals_poly_partial(mesh->mvert,
+                                     mesh->totvert,
+                                     mesh->mloop,
+                                     mesh->mpoly,
+                                     mesh->totpoly,
+                                     mesh->runtime.vert_normals_dirty_map);
+    }
 
     if (do_add_poly_nors_cddata) {
       CustomData_add_layer(&mesh->pdata, CD_NORMAL, CD_ASSIGN, poly_nors, mesh->totpoly);
@@ -427,6 +673,8 @@ void BKE_mesh_ensure_normals_for_display(Mesh *mesh)
 
     mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
     mesh->runtime.cd_dirty_poly &= ~CD_MASK_NORMAL;
+    MEM_SAFE_FREE(mesh->runtime.vert_normals_dirty_map);
+    mesh->runtime.vert_normals_dirty_len = 0;
   }
 }
 
@@ -450,6 +698,8 @@ void BKE_mesh_calc_normals(Mesh *mesh)
   TIMEIT_END_AVERAGED(BKE_mesh_calc_normals);
 #endif
   mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
+  MEM_SAFE_FREE(mesh->runtime.vert_normals_dirty_map);
+  mesh->runtime.vert_normals_dirty_len = 0;
 }
 
 void BKE_mesh_calc_normals_looptri(MVert *mverts,
@@ -1307,36 +1557,54 @@ static void loop_split_worker_do(LoopSplitTaskDataCommon *common_data,
   }
 }
 
-static void loop_split_worker(TaskPool *__restrict pool, void *taskdata)
+/**
+ * Process all the fans gathered by #loop_split_generator, using a single temporary edge vectors
+ * stack per range of tasks.
+ */
+static void loop_split_worker(LoopSplitTaskDataCommon *common_data,
+                              blender::MutableSpan<LoopSplitTaskData> tasks)
 {
-  LoopSplitTaskDataCommon *common_data = (LoopSplitTaskDataCommon *)BLI_task_pool_user_data(pool);
-  LoopSplitTaskData *data = (LoopSplitTaskData *)taskdata;
-
-  /* Temp edge vectors stack, only used when computing lnor spacearr. */
-  BLI_Stack *edge_vectors = common_data->lnors_spacearr ?
-                                BLI_stack_new(sizeof(float[3]), __func__) :
-                                nullptr;
+  blender::threading::parallel_for(
+      tasks.index_range(), LOOP_SPLIT_TASK_BLOCK_SIZE, [&](blender::IndexRange range) {
+        /* Temp edge vectors stack, only used when computing lnor spacearr. */
+        BLI_Stack *edge_vectors = common_data->lnors_spacearr ?
+                                      BLI_stack_new(sizeof(float[3]), __func__) :
+                                      nullptr;
 
 #ifdef DEBUG_TIME
-  TIMEIT_START_AVERAGED(loop_split_worker);
+        TIMEIT_START_AVERAGED(loop_split_worker);
 #endif
 
-  for (int i = 0; i < LOOP_SPLIT_TASK_BLOCK_SIZE; i++, data++) {
-    /* A nullptr ml_curr is used to tag ended data! */
-    if (data->ml_curr == nullptr) {
-      break;
-    }
-
-    loop_split_worker_do(common_data, data, edge_vectors);
-  }
+        for (const int i : range) {
+          loop_split_worker_do(common_data, &tasks[i], edge_vectors);
+        }
 
-  if (edge_vectors) {
-    BLI_stack_free(edge_vectors);
-  }
+        if (edge_vectors) {
+          BLI_stack_free(edge_vectors);
+        }
 
 #ifdef DEBUG_TIME
-  TIMEIT_END_AVERAGED(loop_split_worker);
+        TIMEIT_END_AVERAGED(loop_split_worker);
 #endif
+      });
+}
+
+/**
+ * Allocate the lnor spaces of all gathered fans as a single block,
+ * instead of one arena allocation per fan.
+ */
+static void loop_split_lnor_spaces_create(MLoopNorSpaceArray *lnors_spacearr,
+                                          blender::MutableSpan<LoopSplitTaskData> tasks)
+{
+  if (tasks.is_empty()) {
+    return;
+  }
+  MLoopNorSpace *lnor_spaces = (MLoopNorSpace *)BLI_memarena_calloc(
+      lnors_spacearr->mem, sizeof(MLoopNorSpace) * (size_t)tasks.size());
+  lnors_spacearr->num_spaces += (int)tasks.size();
+  for (const int i : tasks.index_range()) {
+    tasks[i].lnor_space = &lnor_spaces[i];
+  }
 }
 
 /**
@@ -1414,9 +1682,14 @@ static bool loop_split_generator_check_cyclic_smooth_fan(const MLoop *mloops,
   }
 }
 
-static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common_data)
+/**
+ * Gather one task per smooth fan (or single sharp loop) in \a r_tasks.
+ * This has to be done serially since cyclic smooth fans are detected by tagging their loops,
+ * the actual computation of the fans is then done in parallel by #loop_split_worker.
+ */
+static void loop_split_generator(LoopSplitTaskDataCommon *common_data,
+                                 blender::Vector<LoopSplitTaskData> &r_tasks)
 {
-  MLoopNorSpaceArray *lnors_spacearr = common_data->lnors_spacearr;
   float(*loopnors)[3] = common_data->loopnors;
 
   const MLoop *mloops = common_data->mloops;
@@ -1436,22 +1709,12 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
 
   BLI_bitmap *skip_loops = BLI_BITMAP_NEW(numLoops, __func__);
 
-  LoopSplitTaskData *data_buff = nullptr;
-  int data_idx = 0;
-
-  /* Temp edge vectors stack, only used when computing lnor spacearr
-   * (and we are not multi-threading). */
-  BLI_Stack *edge_vectors = nullptr;
-
 #ifdef DEBUG_TIME
   TIMEIT_START_AVERAGED(loop_split_generator);
 #endif
 
-  if (!pool) {
-    if (lnors_spacearr) {
-      edge_vectors = BLI_stack_new(sizeof(float[3]), __func__);
-    }
-  }
+  /* There is roughly one fan per vertex, which is usually about the number of polygons. */
+  r_tasks.reserve(numPolys);
 
   /* We now know edges that can be smoothed (with their vector, and their two loops),
    * and edges that will be hard! Now, time to generate the normals.
@@ -1504,35 +1767,20 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
         //              printf("SKIPPING!\n");
       }
       else {
-        LoopSplitTaskData *data, data_local;
+        LoopSplitTaskData data = {nullptr};
 
         //              printf("PROCESSING!\n");
 
-        if (pool) {
-          if (data_idx == 0) {
-            data_buff = (LoopSplitTaskData *)MEM_calloc_arrayN(
-                LOOP_SPLIT_TASK_BLOCK_SIZE, sizeof(*data_buff), __func__);
-          }
-          data = &data_buff[data_idx];
-        }
-        else {
-          data = &data_local;
-          memset(data, 0, sizeof(*data));
-        }
-
         if (IS_EDGE_SHARP(e2l_curr) && IS_EDGE_SHARP(e2l_prev)) {
-          data->lnor = lnors;
-          data->ml_curr = ml_curr;
-          data->ml_prev = ml_prev;
-          data->ml_curr_index = ml_curr_index;
+          data.lnor = lnors;
+          data.ml_curr = ml_curr;
+          data.ml_prev = ml_prev;
+          data.ml_curr_index = ml_curr_index;
 #if 0 /* Not needed for 'single' loop. */
-          data->ml_prev_index = ml_prev_index;
-          data->e2l_prev = nullptr; /* Tag as 'single' task. */
+          data.ml_prev_index = ml_prev_index;
+          data.e2l_prev = nullptr; /* Tag as 'single' task. */
 #endif
-          data->mp_index = mp_index;
-          if (lnors_spacearr) {
-            data->lnor_space = BKE_lnor_space_create(lnors_spacearr);
-          }
+          data.mp_index = mp_index;
         }
         /* We *do not need* to check/tag loops as already computed!
          * Due to the fact a loop only links to one of its two edges,
@@ -1545,29 +1793,17 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
          */
         else {
 #if 0 /* Not needed for 'fan' loops. */
-          data->lnor = lnors;
+          data.lnor = lnors;
 #endif
-          data->ml_curr = ml_curr;
-          data->ml_prev = ml_prev;
-          data->ml_curr_index = ml_curr_index;
-          data->ml_prev_index = ml_prev_index;
-          data->e2l_prev = e2l_prev; /* Also tag as 'fan' task. */
-          data->mp_index = mp_index;
-          if (lnors_spacearr) {
-            data->lnor_space = BKE_lnor_space_create(lnors_spacearr);
-          }
+          data.ml_curr = ml_curr;
+          data.ml_prev = ml_prev;
+          data.ml_curr_index = ml_curr_index;
+          data.ml_prev_index = ml_prev_index;
+          data.e2l_prev = e2l_prev; /* Also tag as 'fan' task. */
+          data.mp_index = mp_index;
         }
 
-        if (pool) {
-          data_idx++;
-          if (data_idx == LOOP_SPLIT_TASK_BLOCK_SIZE) {
-            BLI_task_pool_push(pool, loop_split_worker, data_buff, true, nullptr);
-            data_idx = 0;
-          }
-        }
-        else {
-          loop_split_worker_do(common_data, data, edge_vectors);
-        }
+        r_tasks.append(data);
       }
 
       ml_prev = ml_curr;
@@ -1575,15 +1811,6 @@ static void loop_split_generator(TaskPool *pool, LoopSplitTaskDataCommon *common
     }
   }
 
-  /* Last block of data... Since it is calloc'ed and we use first nullptr item as stopper,
-   * everything is fine. */
-  if (pool && data_idx) {
-    BLI_task_pool_push(pool, loop_split_worker, data_buff, true, nullptr);
-  }
-
-  if (edge_vectors) {
-    BLI_stack_free(edge_vectors);
-  }
   MEM_freeN(skip_loops);
 
 #ifdef DEBUG_TIME
@@ -1705,20 +1932,18 @@ void BKE_mesh_normals_loop_split(const MVert *mverts,
   /* This first loop check which edges are actually smooth, and compute edge vectors. */
   mesh_edges_sharp_tag(&common_data, check_angle, split_angle, false);
 
-  if (numLoops < LOOP_SPLIT_TASK_BLOCK_SIZE * 8) {
-    /* Not enough loops to be worth the whole threading overhead... */
-    loop_split_generator(nullptr, &common_data);
-  }
-  else {
-    TaskPool *task_pool = BLI_task_pool_create(&common_data, TASK_PRIORITY_HIGH);
-
-    loop_split_generator(task_pool, &common_data);
-
-    BLI_task_pool_work_and_wait(task_pool);
+  /* All fans are stored in a single flat array, which avoids allocating task data per block of
+   * fans, and lets the lnor spaces be allocated all at once. */
+  blender::Vector<LoopSplitTaskData> tasks;
+  loop_split_generator(&common_data, tasks);
 
-    BLI_task_pool_free(task_pool);
+  if (r_lnors_spacearr) {
+    loop_split_lnor_spaces_create(r_lnors_spacearr, tasks);
   }
 
+  /* Small meshes are handled by a single range, without threading overhead. */
+  loop_split_worker(&common_data, tasks);
+
   MEM_freeN(edge_to_loops);
   if (!r_loop_to_poly) {
     MEM_freeN(loop_to_poly);
@@ -0,0 +1,112 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_mesh.h"
+
+#include "BLI_array.hh"
+#include "BLI_float3.hh"
+#include "BLI_math_vector.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
+namespace blender::bke::tests {
+
+/* Grid of quads in the XY plane, followed by loose vertices. */
+static Mesh *mesh_grid_with_loose_verts(const int grid_size, const int loose_verts_num)
+{
+  const int grid_verts_num = (grid_size + 1) * (grid_size + 1);
+  const int polys_num = grid_size * grid_size;
+  Mesh *mesh = BKE_mesh_new_nomain(
+      grid_verts_num + loose_verts_num, 0, 0, polys_num * 4, polys_num);
+
+  for (int y = 0; y <= grid_size; y++) {
+    for (int x = 0; x <= grid_size; x++) {
+      /* Some height variation, so that vertex normals differ. */
+      const float co[3] = {(float)x, (float)y, 0.1f * (float)((x * 7 + y * 3) % 5)};
+      copy_v3_v3(mesh->mvert[y * (grid_size + 1) + x].co, co);
+    }
+  }
+  for (int i = 0; i < loose_verts_num; i++) {
+    const float co[3] = {-1.0f - (float)i, 2.0f, 3.0f};
+    copy_v3_v3(mesh->mvert[grid_verts_num + i].co, co);
+  }
+
+  for (int y = 0; y < grid_size; y++) {
+    for (int x = 0; x < grid_size; x++) {
+      const int poly_index = y * grid_size + x;
+      const int v = y * (grid_size + 1) + x;
+      const int quad[4] = {v, v + 1, v + grid_size + 2, v + grid_size + 1};
+      MPoly *mp = &mesh->mpoly[poly_index];
+      mp->loopstart = poly_index * 4;
+      mp->totloop = 4;
+      for (int i = 0; i < 4; i++) {
+        mesh->mloop[mp->loopstart + i].v = quad[i];
+      }
+    }
+  }
+  return mesh;
+}
+
+TEST(mesh_normals, partial_update_matches_full)
+{
+  BKE_idtype_init();
+
+  const int grid_size = 8;
+  const int grid_verts_num = (grid_size + 1) * (grid_size + 1);
+  Mesh *mesh = mesh_grid_with_loose_verts(grid_size, 2);
+  BKE_mesh_calc_normals(mesh);
+
+  /* Move a vertex of the grid and a loose vertex. */
+  Array<float3> coords(mesh->totvert);
+  for (const int i : coords.index_range()) {
+    coords[i] = mesh->mvert[i].co;
+  }
+  coords[grid_size + 2] += float3(0.0f, 0.0f, 0.5f);
+  coords[grid_verts_num + 1] = float3(4.0f, -5.0f, 6.0f);
+
+  BKE_mesh_normals_tag_dirty_from_coords(mesh, (const float(*)[3])coords.data());
+  ASSERT_NE(mesh->runtime.vert_normals_dirty_map, nullptr);
+  for (const int i : coords.index_range()) {
+    copy_v3_v3(mesh->mvert[i].co, coords[i]);
+  }
+  BKE_mesh_ensure_normals(mesh);
+
+  Array<short> normals_partial(mesh->totvert * 3);
+  for (const int i : IndexRange(mesh->totvert)) {
+    for (const int j : IndexRange(3)) {
+      normals_partial[i * 3 + j] = mesh->mvert[i].no[j];
+    }
+  }
+
+  BKE_mesh_calc_normals(mesh);
+  for (const int i : IndexRange(mesh->totvert)) {
+    for (const int j : IndexRange(3)) {
+      EXPECT_EQ(normals_partial[i * 3 + j], mesh->mvert[i].no[j]) << "vertex " << i;
+    }
+  }
+
+  BKE_id_free(nullptr, mesh);
+}
+
+}  // namespace blender::bke::tests
@@ -68,6 +68,8 @@ void BKE_mesh_runtime_reset_on_copy(Mesh *mesh, const int UNUSED(flag))
   memset(&runtime->looptris, 0, sizeof(runtime->looptris));
   runtime->bvh_cache = NULL;
   runtime->shrinkwrap_data = NULL;
+  runtime->vert_normals_dirty_map = NULL;
+  runtime->vert_normals_dirty_len = 0;
 
   mesh->runtime.eval_mutex = MEM_mallocN(sizeof(ThreadMutex), "mesh runtime eval_mutex");
   BLI_mutex_init(mesh->runtime.eval_mutex);
@@ -184,6 +186,53 @@ const MLoopTri *BKE_mesh_runtime_looptri_ensure(const Mesh *mesh)
   return looptri;
 }
 
+/**
+ * Reuse the triangulation of \a mesh_src for its copy \a mesh_dst, which has the same topology,
+ * instead of computing it again for every evaluated copy.
+ *
+ * The triangulation of triangles and quads only depends on topology, so it stays valid when
+ * the copy gets deformed. N-gons are tessellated based on vertex positions,
+ * so nothing is reused for meshes that have any.
+ */
+void BKE_mesh_runtime_looptri_reuse(Mesh *mesh_dst, const Mesh *mesh_src)
+{
+  if (mesh_dst->runtime.looptris.array != NULL) {
+    return;
+  }
+  if ((mesh_dst->totpoly != mesh_src->totpoly) || (mesh_dst->totloop != mesh_src->totloop)) {
+    return;
+  }
+
+  /* The source triangulation may be computed concurrently,
+   * see #BKE_mesh_runtime_looptri_ensure. */
+  ThreadMutex *mesh_src_eval_mutex = (ThreadMutex *)mesh_src->runtime.eval_mutex;
+  BLI_mutex_lock(mesh_src_eval_mutex);
+  const bool has_looptri_src = mesh_src->runtime.looptris.array != NULL;
+  BLI_mutex_unlock(mesh_src_eval_mutex);
+  if (!has_looptri_src) {
+    return;
+  }
+
+  const MPoly *mp = mesh_src->mpoly;
+  for (int i = 0; i < mesh_src->totpoly; i++, mp++) {
+    if (mp->totloop > 4) {
+      return;
+    }
+  }
+
+  BLI_mutex_lock(mesh_src_eval_mutex);
+  const MLoopTri *looptri_src = mesh_src->runtime.looptris.array;
+  if (looptri_src != NULL) {
+    const int looptris_len = mesh_src->runtime.looptris.len;
+    MLoopTri *looptri_dst = MEM_malloc_arrayN(looptris_len, sizeof(*looptri_dst), __func__);
+    memcpy(looptri_dst, looptri_src, sizeof(*looptri_dst) * (size_t)looptris_len);
+    mesh_dst->runtime.looptris.array = looptri_dst;
+    mesh_dst->runtime.looptris.len = looptris_len;
+    mesh_dst->runtime.looptris.len_alloc = looptris_len;
+  }
+  BLI_mutex_unlock(mesh_src_eval_mutex);
+}
+
 /* This is a copy of DM_verttri_from_looptri(). */
 void BKE_mesh_runtime_verttri_from_looptri(MVertTri *r_verttri,
                                            const MLoop *mloop,
@@ -242,6 +291,8 @@ void BKE_mesh_runtime_clear_geometry(Mesh *mesh)
     mesh->runtime.bvh_cache = NULL;
   }
   MEM_SAFE_FREE(mesh->runtime.looptris.array);
+  MEM_SAFE_FREE(mesh->runtime.vert_normals_dirty_map);
+  mesh->runtime.vert_normals_dirty_len = 0;
   /* TODO(sergey): Does this really belong here? */
   if (mesh->runtime.subdiv_ccg != NULL) {
     BKE_subdiv_ccg_destroy(mesh->runtime.subdiv_ccg);
@@ -285,6 +285,26 @@ bool multires_reshape_context_create_from_subdiv(MultiresReshapeContext *reshape
   return context_verify_or_free(reshape_context);
 }
 
+typedef struct OriginalGridsTaskData {
+  MDisps *mdisps;
+  GridPaintMask *grid_paint_masks;
+} OriginalGridsTaskData;
+
+static void free_original_grids_task(void *__restrict userdata_v,
+                                     const int grid_index,
+                                     const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  OriginalGridsTaskData *data = userdata_v;
+  if (data->mdisps != NULL) {
+    MDisps *orig_grid = &data->mdisps[grid_index];
+    MEM_SAFE_FREE(orig_grid->disps);
+  }
+  if (data->grid_paint_masks != NULL) {
+    GridPaintMask *orig_paint_mask_grid = &data->grid_paint_masks[grid_index];
+    MEM_SAFE_FREE(orig_paint_mask_grid->data);
+  }
+}
+
 void multires_reshape_free_original_grids(MultiresReshapeContext *reshape_context)
 {
   MDisps *orig_mdisps = reshape_context->orig.mdisps;
@@ -294,17 +314,18 @@ void multires_reshape_free_original_grids(MultiresReshapeContext *reshape_contex
     return;
   }
 
-  const int num_grids = reshape_context->num_grids;
-  for (int grid_index = 0; grid_index < num_grids; grid_index++) {
-    if (orig_mdisps != NULL) {
-      MDisps *orig_grid = &orig_mdisps[grid_index];
-      MEM_SAFE_FREE(orig_grid->disps);
-    }
-    if (orig_grid_paint_masks != NULL) {
-      GridPaintMask *orig_paint_mask_grid = &orig_grid_paint_masks[grid_index];
-      MEM_SAFE_FREE(orig_paint_mask_grid->data);
-    }
-  }
+  OriginalGridsTaskData data;
+  data.mdisps = orig_mdisps;
+  data.grid_paint_masks = orig_grid_paint_masks;
+
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0,
+                          reshape_context->num_grids,
+                          &data,
+                          free_original_grids_task,
+                          &parallel_range_settings);
 
   MEM_SAFE_FREE(orig_mdisps);
   MEM_SAFE_FREE(orig_grid_paint_masks);
@@ -556,42 +577,49 @@ static void ensure_displacement_grid(MDisps *displacement_grid, const int level)
   allocate_displacement_grid(displacement_grid, level);
 }
 
-static void ensure_displacement_grids(Mesh *mesh, const int grid_level)
-{
-  const int num_grids = mesh->totloop;
-  MDisps *mdisps = CustomData_get_layer(&mesh->ldata, CD_MDISPS);
-  for (int grid_index = 0; grid_index < num_grids; grid_index++) {
-    ensure_displacement_grid(&mdisps[grid_index], grid_level);
-  }
-}
+typedef struct EnsureGridsTaskData {
+  MDisps *mdisps;
+  GridPaintMask *grid_paint_masks;
+  int level;
+} EnsureGridsTaskData;
 
-static void ensure_mask_grids(Mesh *mesh, const int level)
+static void ensure_mask_grid(GridPaintMask *grid_paint_mask, const int level)
 {
-  GridPaintMask *grid_paint_masks = CustomData_get_layer(&mesh->ldata, CD_GRID_PAINT_MASK);
-  if (grid_paint_masks == NULL) {
+  if (grid_paint_mask->level >= level) {
     return;
   }
-  const int num_grids = mesh->totloop;
   const int grid_size = BKE_subdiv_grid_size_from_level(level);
   const int grid_area = grid_size * grid_size;
-  for (int grid_index = 0; grid_index < num_grids; grid_index++) {
-    GridPaintMask *grid_paint_mask = &grid_paint_masks[grid_index];
-    if (grid_paint_mask->level >= level) {
-      continue;
-    }
-    grid_paint_mask->level = level;
-    if (grid_paint_mask->data) {
-      MEM_freeN(grid_paint_mask->data);
-    }
-    /* TODO(sergey): Preserve data on the old level. */
-    grid_paint_mask->data = MEM_calloc_arrayN(grid_area, sizeof(float), "gpm.data");
+  grid_paint_mask->level = level;
+  if (grid_paint_mask->data) {
+    MEM_freeN(grid_paint_mask->data);
+  }
+  /* TODO(sergey): Preserve data on the old level. */
+  grid_paint_mask->data = MEM_calloc_arrayN(grid_area, sizeof(float), "gpm.data");
+}
+
+static void ensure_grids_task(void *__restrict userdata_v,
+                              const int grid_index,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  EnsureGridsTaskData *data = userdata_v;
+  ensure_displacement_grid(&data->mdisps[grid_index], data->level);
+  if (data->grid_paint_masks != NULL) {
+    ensure_mask_grid(&data->grid_paint_masks[grid_index], data->level);
   }
 }
 
 void multires_reshape_ensure_grids(Mesh *mesh, const int level)
 {
-  ensure_displacement_grids(mesh, level);
-  ensure_mask_grids(mesh, level);
+  EnsureGridsTaskData data;
+  data.mdisps = CustomData_get_layer(&mesh->ldata, CD_MDISPS);
+  data.grid_paint_masks = CustomData_get_layer(&mesh->ldata, CD_GRID_PAINT_MASK);
+  data.level = level;
+
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, mesh->totloop, &data, ensure_grids_task, &parallel_range_settings);
 }
 
 /** \} */
@@ -600,6 +628,27 @@ void multires_reshape_ensure_grids(Mesh *mesh, const int level)
 /** \name Displacement, space conversion
  * \{ */
 
+static void store_original_grids_task(void *__restrict userdata_v,
+                                      const int grid_index,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  OriginalGridsTaskData *data = userdata_v;
+  MDisps *orig_grid = &data->mdisps[grid_index];
+  /* Ignore possibly invalid/non-allocated original grids. They will be replaced with 0 original
+   * data when accessed during reshape process.
+   * Reshape process will ensure all grids are on top level, but that happens on separate set of
+   * grids which eventually replaces original one. */
+  if (orig_grid->disps != NULL) {
+    orig_grid->disps = MEM_dupallocN(orig_grid->disps);
+  }
+  if (data->grid_paint_masks != NULL) {
+    GridPaintMask *orig_paint_mask_grid = &data->grid_paint_masks[grid_index];
+    if (orig_paint_mask_grid->data != NULL) {
+      orig_paint_mask_grid->data = MEM_dupallocN(orig_paint_mask_grid->data);
+    }
+  }
+}
+
 void multires_reshape_store_original_grids(MultiresReshapeContext *reshape_context)
 {
   const MDisps *mdisps = reshape_context->mdisps;
@@ -611,23 +660,18 @@ void multires_reshape_store_original_grids(MultiresReshapeContext *reshape_conte
     orig_grid_paint_masks = MEM_dupallocN(grid_paint_masks);
   }
 
-  const int num_grids = reshape_context->num_grids;
-  for (int grid_index = 0; grid_index < num_grids; grid_index++) {
-    MDisps *orig_grid = &orig_mdisps[grid_index];
-    /* Ignore possibly invalid/non-allocated original grids. They will be replaced with 0 original
-     * data when accessed during reshape process.
-     * Reshape process will ensure all grids are on top level, but that happens on separate set of
-     * grids which eventually replaces original one. */
-    if (orig_grid->disps != NULL) {
-      orig_grid->disps = MEM_dupallocN(orig_grid->disps);
-    }
-    if (orig_grid_paint_masks != NULL) {
-      GridPaintMask *orig_paint_mask_grid = &orig_grid_paint_masks[grid_index];
-      if (orig_paint_mask_grid->data != NULL) {
-        orig_paint_mask_grid->data = MEM_dupallocN(orig_paint_mask_grid->data);
-      }
-    }
-  }
+  OriginalGridsTaskData data;
+  data.mdisps = orig_mdisps;
+  data.grid_paint_masks = orig_grid_paint_masks;
+
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0,
+                          reshape_context->num_grids,
+                          &data,
+                          store_original_grids_task,
+                          &parallel_range_settings);
 
   reshape_context->orig.mdisps = orig_mdisps;
   reshape_context->orig.grid_paint_masks = orig_grid_paint_masks;
@@ -33,6 +33,7 @@
 
 #include "BLI_gsqueue.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_lib_id.h"
@@ -1177,6 +1178,36 @@ void multires_unsubdivide_context_free(MultiresUnsubdivideContext *context)
   MEM_SAFE_FREE(context->base_mesh_grids);
 }
 
+typedef struct CreateGridsTaskData {
+  MultiresUnsubdivideContext *context;
+  MDisps *mdisps;
+  int totdisp;
+} CreateGridsTaskData;
+
+static void create_grids_task(void *__restrict userdata_v,
+                              const int i,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  CreateGridsTaskData *data = userdata_v;
+  MultiresUnsubdivideContext *context = data->context;
+  MDisps *mdisps = data->mdisps;
+  const int totdisp = data->totdisp;
+
+  float(*disps)[3] = MEM_calloc_arrayN(totdisp, sizeof(float[3]), "multires disps");
+
+  if (mdisps[i].disps) {
+    MEM_freeN(mdisps[i].disps);
+  }
+
+  if (context->base_mesh_grids[i].grid_co) {
+    memcpy(disps, context->base_mesh_grids[i].grid_co, sizeof(float[3]) * totdisp);
+  }
+
+  mdisps[i].disps = disps;
+  mdisps[i].totdisp = totdisp;
+  mdisps[i].level = context->num_total_levels;
+}
+
 /**
  * This function allocates new mdisps with the right size to fit the new extracted grids from the
  * base mesh and copies the data to them.
@@ -1197,23 +1228,15 @@ static void multires_create_grids_in_unsubdivided_base_mesh(MultiresUnsubdivideC
   BLI_assert(base_mesh->totloop == context->num_grids);
 
   /* Allocate the MDISPS grids and copy the extracted data from context. */
-  for (int i = 0; i < totloop; i++) {
-    float(*disps)[3] = MEM_calloc_arrayN(totdisp, sizeof(float[3]), "multires disps");
-
-    if (mdisps[i].disps) {
-      MEM_freeN(mdisps[i].disps);
-    }
-
-    for (int j = 0; j < totdisp; j++) {
-      if (context->base_mesh_grids[i].grid_co) {
-        copy_v3_v3(disps[j], context->base_mesh_grids[i].grid_co[j]);
-      }
-    }
-
-    mdisps[i].disps = disps;
-    mdisps[i].totdisp = totdisp;
-    mdisps[i].level = context->num_total_levels;
-  }
+  CreateGridsTaskData data = {
+      .context = context,
+      .mdisps = mdisps,
+      .totdisp = totdisp,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, totloop, &data, create_grids_task, &settings);
 }
 
 int multiresModifier_rebuild_subdiv(struct Depsgraph *depsgraph,
@@ -1173,6 +1173,11 @@ void BKE_ocean_free_cache(struct OceanCache *och)
     return;
   }
 
+  if (och->prefetch_pool) {
+    BLI_task_pool_work_and_wait(och->prefetch_pool);
+    BLI_task_pool_free(och->prefetch_pool);
+  }
+
   if (och->ibufs_disp) {
     for (i = och->start, f = 0; i <= och->end; i++, f++) {
       if (och->ibufs_disp[f]) {
@@ -1338,13 +1343,49 @@ struct OceanCache *BKE_ocean_init_cache(const char *bakepath,
   och->ibufs_norm = MEM_callocN(sizeof(ImBuf *) * och->duration, "normal imbuf pointer array");
 
   och->time = NULL;
+  och->prefetch_frame = start - 1;
 
   return och;
 }
 
+typedef struct OceanCacheLoad {
+  ImBuf **r_ibuf;
+  char filepath[FILE_MAX];
+} OceanCacheLoad;
+
+static void ocean_cache_load_task(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  OceanCacheLoad *load = taskdata;
+
+  /* Use default color spaces since we know for sure cache
+   * files were saved with default settings too. */
+  *load->r_ibuf = IMB_loadiffname(load->filepath, 0, NULL);
+}
+
+/* Push the loading of the maps of a frame to the pool, `f` is the zero based frame index. */
+static void ocean_cache_load_push(TaskPool *pool, OceanCache *och, int frame, int f)
+{
+  const struct {
+    ImBuf **ibufs;
+    int type;
+  } maps[] = {
+      {och->ibufs_disp, CACHE_TYPE_DISPLACE},
+      {och->ibufs_foam, CACHE_TYPE_FOAM},
+      {och->ibufs_spray, CACHE_TYPE_SPRAY},
+      {och->ibufs_spray_inverse, CACHE_TYPE_SPRAY_INVERSE},
+      {och->ibufs_norm, CACHE_TYPE_NORMAL},
+  };
+
+  for (int i = 0; i < ARRAY_SIZE(maps); i++) {
+    OceanCacheLoad *load = MEM_mallocN(sizeof(*load), __func__);
+    load->r_ibuf = &maps[i].ibufs[f];
+    cache_filename(load->filepath, och->bakepath, och->relbase, frame, maps[i].type);
+    BLI_task_pool_push(pool, ocean_cache_load_task, load, true, NULL);
+  }
+}
+
 void BKE_ocean_simulate_cache(struct OceanCache *och, int frame)
 {
-  char string[FILE_MAX];
   int f = frame;
 
   /* ibufs array is zero based, but filenames are based on frame numbers */
@@ -1352,28 +1393,146 @@ void BKE_ocean_simulate_cache(struct OceanCache *och, int frame)
   CLAMP(frame, och->start, och->end);
   f = frame - och->start; /* shift to 0 based */
 
-  /* if image is already loaded in mem, return */
-  if (och->ibufs_disp[f] != NULL) {
-    return;
+  /* the maps of this frame may be loading in the background */
+  if (och->prefetch_pool) {
+    BLI_task_pool_work_and_wait(och->prefetch_pool);
   }
 
-  /* Use default color spaces since we know for sure cache
-   * files were saved with default settings too. */
+  /* if image is not already loaded in mem, load all its maps at once */
+  if (och->ibufs_disp[f] == NULL) {
+    TaskPool *pool = BLI_task_pool_create(NULL, TASK_PRIORITY_HIGH);
+    ocean_cache_load_push(pool, och, frame, f);
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+
+  /* Read ahead the next frame while this one is evaluated, as frames are mostly played back in
+   * order. Loaded frames stay in memory, so only frames that weren't loaded yet are read. */
+  if (frame < och->end && och->ibufs_disp[f + 1] == NULL && och->prefetch_frame != frame + 1) {
+    if (och->prefetch_pool == NULL) {
+      och->prefetch_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+    }
+    och->prefetch_frame = frame + 1;
+    ocean_cache_load_push(och->prefetch_pool, och, frame + 1, f + 1);
+  }
+}
+
+typedef struct OceanBakeData {
+  Ocean *o;
+  OceanCache *och;
+  /* zero based index of the baked frame */
+  int frame_index;
+  float *prev_foam;
+  ImBuf *ibuf_foam, *ibuf_disp, *ibuf_normal, *ibuf_spray, *ibuf_spray_inverse;
+} OceanBakeData;
+
+static void ocean_bake_row_cb(void *__restrict userdata,
+                              const int y,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  OceanBakeData *obd = userdata;
+  Ocean *o = obd->o;
+  OceanCache *och = obd->och;
+  float *prev_foam = obd->prev_foam;
+  const int res_x = och->resolution_x;
+
+  /* NOTE(campbell): some of these values remain uninitialized unless certain options
+   * are enabled, take care that BKE_ocean_eval_ij() initializes a member
+   * before use. */
+  OceanResult ocr;
+
+  for (int x = 0; x < res_x; x++) {
+
+    BKE_ocean_eval_ij(o, &ocr, x, y);
+
+    /* add to the image */
+    rgb_to_rgba_unit_alpha(&obd->ibuf_disp->rect_float[4 * (res_x * y + x)], ocr.disp);
+
+    if (o->_do_jacobian) {
+      /* TODO(campbell): cleanup unused code. */
+
+      float /* r, */ /* UNUSED */ pr = 0.0f, foam_result;
+      float neg_disp, neg_eplus;
+
+      ocr.foam = BKE_ocean_jminus_to_foam(ocr.Jminus, och->foam_coverage);
+
+      /* accumulate previous value for this cell */
+      if (obd->frame_index > 0) {
+        pr = prev_foam[res_x * y + x];
+      }
+
+      // r = BLI_rng_get_float(rng); /* UNUSED */ /* randomly reduce foam */
+
+      // pr = pr * och->foam_fade; /* overall fade */
+
+      /* Remember ocean coord sys is Y up!
+       * break up the foam where height (Y) is low (wave valley),
+       * and X and Z displacement is greatest. */
+
+      neg_disp = ocr.disp[1] < 0.0f ? 1.0f + ocr.disp[1] : 1.0f;
+      neg_disp = neg_disp < 0.0f ? 0.0f : neg_disp;
+
+      /* foam, 'ocr.Eplus' only initialized with do_jacobian */
+      neg_eplus = ocr.Eplus[2] < 0.0f ? 1.0f + ocr.Eplus[2] : 1.0f;
+      neg_eplus = neg_eplus < 0.0f ? 0.0f : neg_eplus;
+
+      if (pr < 1.0f) {
+        pr *= pr;
+      }
+
+      pr *= och->foam_fade * (0.75f + neg_eplus * 0.25f);
 
-  cache_filename(string, och->bakepath, och->relbase, frame, CACHE_TYPE_DISPLACE);
-  och->ibufs_disp[f] = IMB_loadiffname(string, 0, NULL);
+      /* A full clamping should not be needed! */
+      foam_result = min_ff(pr + ocr.foam, 1.0f);
 
-  cache_filename(string, och->bakepath, och->relbase, frame, CACHE_TYPE_FOAM);
-  och->ibufs_foam[f] = IMB_loadiffname(string, 0, NULL);
+      prev_foam[res_x * y + x] = foam_result;
 
-  cache_filename(string, och->bakepath, och->relbase, frame, CACHE_TYPE_SPRAY);
-  och->ibufs_spray[f] = IMB_loadiffname(string, 0, NULL);
+      // foam_result = min_ff(foam_result, 1.0f);
 
-  cache_filename(string, och->bakepath, och->relbase, frame, CACHE_TYPE_SPRAY_INVERSE);
-  och->ibufs_spray_inverse[f] = IMB_loadiffname(string, 0, NULL);
+      value_to_rgba_unit_alpha(&obd->ibuf_foam->rect_float[4 * (res_x * y + x)], foam_result);
 
-  cache_filename(string, och->bakepath, och->relbase, frame, CACHE_TYPE_NORMAL);
-  och->ibufs_norm[f] = IMB_loadiffname(string, 0, NULL);
+      /* spray map baking */
+      if (o->_do_spray) {
+        rgb_to_rgba_unit_alpha(&obd->ibuf_spray->rect_float[4 * (res_x * y + x)], ocr.Eplus);
+        rgb_to_rgba_unit_alpha(&obd->ibuf_spray_inverse->rect_float[4 * (res_x * y + x)],
+                               ocr.Eminus);
+      }
+    }
+
+    if (o->_do_normals) {
+      rgb_to_rgba_unit_alpha(&obd->ibuf_normal->rect_float[4 * (res_x * y + x)], ocr.normal);
+    }
+  }
+}
+
+typedef struct OceanBakeWrite {
+  ImBuf *ibuf;
+  const char *name;
+  char filepath[FILE_MAX];
+} OceanBakeWrite;
+
+static void ocean_bake_write_task(TaskPool *__restrict pool, void *taskdata)
+{
+  ImageFormatData *imf = BLI_task_pool_user_data(pool);
+  OceanBakeWrite *write = taskdata;
+
+  if (0 == BKE_imbuf_write(write->ibuf, write->filepath, imf)) {
+    printf("Cannot save %s File Output to %s\n", write->name, write->filepath);
+  }
+}
+
+static void ocean_bake_write_push(TaskPool *pool,
+                                  OceanCache *och,
+                                  OceanBakeWrite *write,
+                                  ImBuf *ibuf,
+                                  const char *name,
+                                  int frame,
+                                  int type)
+{
+  write->ibuf = ibuf;
+  write->name = name;
+  cache_filename(write->filepath, och->bakepath, och->relbase, frame, type);
+  BLI_task_pool_push(pool, ocean_bake_write_task, write, false, NULL);
 }
 
 void BKE_ocean_bake(struct Ocean *o,
@@ -1381,21 +1540,14 @@ void BKE_ocean_bake(struct Ocean *o,
                     void (*update_cb)(void *, float progress, int *cancel),
                     void *update_cb_data)
 {
-  /* NOTE(campbell): some of these values remain uninitialized unless certain options
-   * are enabled, take care that BKE_ocean_eval_ij() initializes a member
-   * before use. */
-  OceanResult ocr;
-
   ImageFormatData imf = {0};
 
-  int f, i = 0, x, y, cancel = 0;
+  int f, i = 0, cancel = 0;
   float progress;
 
-  ImBuf *ibuf_foam, *ibuf_disp, *ibuf_normal, *ibuf_spray, *ibuf_spray_inverse;
   float *prev_foam;
   int res_x = och->resolution_x;
   int res_y = och->resolution_y;
-  char string[FILE_MAX];
   // RNG *rng;
 
   if (!o) {
@@ -1416,120 +1568,74 @@ void BKE_ocean_bake(struct Ocean *o,
   imf.depth = R_IMF_CHAN_DEPTH_16;
   imf.exr_codec = R_IMF_EXR_CODEC_ZIP;
 
+  OceanBakeData obd = {
+      .o = o,
+      .och = och,
+      .prev_foam = prev_foam,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (res_y > 16);
+
   for (f = och->start, i = 0; f <= och->end; f++, i++) {
 
     /* create a new imbuf to store image for this frame */
-    ibuf_foam = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
-    ibuf_disp = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
-    ibuf_normal = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
-    ibuf_spray = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
-    ibuf_spray_inverse = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
+    obd.ibuf_foam = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
+    obd.ibuf_disp = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
+    obd.ibuf_normal = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
+    obd.ibuf_spray = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
+    obd.ibuf_spray_inverse = IMB_allocImBuf(res_x, res_y, 32, IB_rectfloat);
+    obd.frame_index = i;
 
     BKE_ocean_simulate(o, och->time[i], och->wave_scale, och->chop_amount);
 
-    /* add new foam */
-    for (y = 0; y < res_y; y++) {
-      for (x = 0; x < res_x; x++) {
-
-        BKE_ocean_eval_ij(o, &ocr, x, y);
-
-        /* add to the image */
-        rgb_to_rgba_unit_alpha(&ibuf_disp->rect_float[4 * (res_x * y + x)], ocr.disp);
-
-        if (o->_do_jacobian) {
-          /* TODO(campbell): cleanup unused code. */
-
-          float /* r, */ /* UNUSED */ pr = 0.0f, foam_result;
-          float neg_disp, neg_eplus;
-
-          ocr.foam = BKE_ocean_jminus_to_foam(ocr.Jminus, och->foam_coverage);
-
-          /* accumulate previous value for this cell */
-          if (i > 0) {
-            pr = prev_foam[res_x * y + x];
-          }
-
-          // r = BLI_rng_get_float(rng); /* UNUSED */ /* randomly reduce foam */
-
-          // pr = pr * och->foam_fade; /* overall fade */
-
-          /* Remember ocean coord sys is Y up!
-           * break up the foam where height (Y) is low (wave valley),
-           * and X and Z displacement is greatest. */
-
-          neg_disp = ocr.disp[1] < 0.0f ? 1.0f + ocr.disp[1] : 1.0f;
-          neg_disp = neg_disp < 0.0f ? 0.0f : neg_disp;
-
-          /* foam, 'ocr.Eplus' only initialized with do_jacobian */
-          neg_eplus = ocr.Eplus[2] < 0.0f ? 1.0f + ocr.Eplus[2] : 1.0f;
-          neg_eplus = neg_eplus < 0.0f ? 0.0f : neg_eplus;
-
-          if (pr < 1.0f) {
-            pr *= pr;
-          }
+    /* add new foam, every cell only depends on its own value of the previous frame */
+    BLI_task_parallel_range(0, res_y, &obd, ocean_bake_row_cb, &settings);
 
-          pr *= och->foam_fade * (0.75f + neg_eplus * 0.25f);
+    /* write the images, each map is compressed on its own thread */
+    OceanBakeWrite writes[5];
+    int writes_num = 0;
+    TaskPool *pool = BLI_task_pool_create(&imf, TASK_PRIORITY_HIGH);
 
-          /* A full clamping should not be needed! */
-          foam_result = min_ff(pr + ocr.foam, 1.0f);
-
-          prev_foam[res_x * y + x] = foam_result;
-
-          // foam_result = min_ff(foam_result, 1.0f);
-
-          value_to_rgba_unit_alpha(&ibuf_foam->rect_float[4 * (res_x * y + x)], foam_result);
-
-          /* spray map baking */
-          if (o->_do_spray) {
-            rgb_to_rgba_unit_alpha(&ibuf_spray->rect_float[4 * (res_x * y + x)], ocr.Eplus);
-            rgb_to_rgba_unit_alpha(&ibuf_spray_inverse->rect_float[4 * (res_x * y + x)],
-                                   ocr.Eminus);
-          }
-        }
-
-        if (o->_do_normals) {
-          rgb_to_rgba_unit_alpha(&ibuf_normal->rect_float[4 * (res_x * y + x)], ocr.normal);
-        }
-      }
-    }
-
-    /* write the images */
-    cache_filename(string, och->bakepath, och->relbase, f, CACHE_TYPE_DISPLACE);
-    if (0 == BKE_imbuf_write(ibuf_disp, string, &imf)) {
-      printf("Cannot save Displacement File Output to %s\n", string);
-    }
+    ocean_bake_write_push(pool,
+                          och,
+                          &writes[writes_num++],
+                          obd.ibuf_disp,
+                          "Displacement",
+                          f,
+                          CACHE_TYPE_DISPLACE);
 
     if (o->_do_jacobian) {
-      cache_filename(string, och->bakepath, och->relbase, f, CACHE_TYPE_FOAM);
-      if (0 == BKE_imbuf_write(ibuf_foam, string, &imf)) {
-        printf("Cannot save Foam File Output to %s\n", string);
-      }
+      ocean_bake_write_push(
+          pool, och, &writes[writes_num++], obd.ibuf_foam, "Foam", f, CACHE_TYPE_FOAM);
 
       if (o->_do_spray) {
-        cache_filename(string, och->bakepath, och->relbase, f, CACHE_TYPE_SPRAY);
-        if (0 == BKE_imbuf_write(ibuf_spray, string, &imf)) {
-          printf("Cannot save Spray File Output to %s\n", string);
-        }
-
-        cache_filename(string, och->bakepath, och->relbase, f, CACHE_TYPE_SPRAY_INVERSE);
-        if (0 == BKE_imbuf_write(ibuf_spray_inverse, string, &imf)) {
-          printf("Cannot save Spray Inverse File Output to %s\n", string);
-        }
+        ocean_bake_write_push(
+            pool, och, &writes[writes_num++], obd.ibuf_spray, "Spray", f, CACHE_TYPE_SPRAY);
+        ocean_bake_write_push(pool,
+                              och,
+                              &writes[writes_num++],
+                              obd.ibuf_spray_inverse,
+                              "Spray Inverse",
+                              f,
+                              CACHE_TYPE_SPRAY_INVERSE);
       }
     }
 
     if (o->_do_normals) {
-      cache_filename(string, och->bakepath, och->relbase, f, CACHE_TYPE_NORMAL);
-      if (0 == BKE_imbuf_write(ibuf_normal, string, &imf)) {
-        printf("Cannot save Normal File Output to %s\n", string);
-      }
+      ocean_bake_write_push(
+          pool, och, &writes[writes_num++], obd.ibuf_normal, "Normal", f, CACHE_TYPE_NORMAL);
     }
 
-    IMB_freeImBuf(ibuf_disp);
-    IMB_freeImBuf(ibuf_foam);
-    IMB_freeImBuf(ibuf_normal);
-    IMB_freeImBuf(ibuf_spray);
-    IMB_freeImBuf(ibuf_spray_inverse);
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+
+    IMB_freeImBuf(obd.ibuf_disp);
+    IMB_freeImBuf(obd.ibuf_foam);
+    IMB_freeImBuf(obd.ibuf_normal);
+    IMB_freeImBuf(obd.ibuf_spray);
+    IMB_freeImBuf(obd.ibuf_spray_inverse);
 
     progress = (f - och->start) / (float)och->duration;
 
@@ -46,7 +46,6 @@
 #include "DNA_scene_types.h"
 
 #include "BLI_blenlib.h"
-#include "BLI_kdopbvh.h"
 #include "BLI_kdtree.h"
 #include "BLI_linklist.h"
 #include "BLI_math.h"
@@ -1129,7 +1128,7 @@ void psys_free(Object *ob, ParticleSystem *psys)
 
     BLI_freelistN(&psys->targets);
 
-    BLI_bvhtree_free(psys->bvhtree);
+    psys_sph_grid_free(psys->sph_grid);
     BLI_kdtree_3d_free(psys->tree);
 
     if (psys->fluid_springs) {
@@ -5376,7 +5375,7 @@ void BKE_particle_system_blend_read_data(BlendDataReader *reader, ListBase *part
     }
 
     psys->tree = NULL;
-    psys->bvhtree = NULL;
+    psys->sph_grid = NULL;
 
     psys->orig_psys = NULL;
     psys->batch_cache = NULL;
@@ -92,7 +92,7 @@
 #  include "manta_fluid_API.h"
 #endif  // WITH_FLUID
 
-static ThreadRWMutex psys_bvhtree_rwlock = BLI_RWLOCK_INITIALIZER;
+static ThreadRWMutex psys_sph_grid_rwlock = BLI_RWLOCK_INITIALIZER;
 
 /************************************************/
 /*          Reacting to system events           */
@@ -1320,56 +1320,283 @@ void psys_get_pointcache_start_end(Scene *scene, ParticleSystem *psys, int *sfra
   *efra = min_ii((int)(part->end + part->lifetime + 1.0f), max_ii(scene->r.pefra, scene->r.efra));
 }
 
-/* BVH tree balancing inside a mutex lock must be run in isolation. Balancing
- * is multithreaded, and we do not want the current thread to start another task
- * that may involve acquiring the same mutex lock that it is waiting for. */
-static void bvhtree_balance_isolated(void *userdata)
+/************************************************/
+/*          SPH Neighbor Grid                   */
+/************************************************/
+
+/**
+ * Cell grid of the alive particles of a system, to find SPH neighbors.
+ *
+ * Cells are hashed into a power of two number of buckets. Particles are counting-sorted by bucket
+ * in index order, and their positions are stored sorted too, so the particles of a cell are read
+ * from contiguous memory. Entries keep their cell, to skip other cells sharing a bucket.
+ */
+typedef struct ParticleSPHGrid {
+  float cell_size_inv;
+  /* Bounds of the cells containing particles, inclusive. */
+  int cell_min[3], cell_max[3];
+
+  /* `bucket_num + 1` offsets into the sorted arrays. */
+  int *bucket_offsets;
+  int bucket_num;
+
+  /* Sorted by bucket, `tot` items. */
+  int *index;
+  int (*cell)[3];
+  float (*co)[3];
+  int tot, alloc;
+} ParticleSPHGrid;
+
+typedef struct SPHGridBuildData {
+  ParticleSPHGrid *grid;
+  const int *index;
+  const float (*co)[3];
+  int (*cell)[3];
+  int *bucket;
+} SPHGridBuildData;
+
+BLI_INLINE int sph_grid_bucket(const ParticleSPHGrid *grid, const int cell[3])
 {
-  BLI_bvhtree_balance((BVHTree *)userdata);
+  const uint h = ((uint)cell[0] * 73856093u) ^ ((uint)cell[1] * 19349663u) ^
+                 ((uint)cell[2] * 83492791u);
+  return (int)(h & (uint)(grid->bucket_num - 1));
 }
 
-/************************************************/
-/*          Effectors                           */
-/************************************************/
-static void psys_update_particle_bvhtree(ParticleSystem *psys, float cfra)
+BLI_INLINE void sph_grid_cell(const ParticleSPHGrid *grid, const float co[3], int r_cell[3])
 {
-  if (psys) {
-    PARTICLE_P;
-    int totpart = 0;
-    bool need_rebuild;
+  r_cell[0] = (int)floorf(co[0] * grid->cell_size_inv);
+  r_cell[1] = (int)floorf(co[1] * grid->cell_size_inv);
+  r_cell[2] = (int)floorf(co[2] * grid->cell_size_inv);
+}
 
-    BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
-    need_rebuild = !psys->bvhtree || psys->bvhtree_frame != cfra;
-    BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
+static void sph_grid_cell_cb(void *__restrict userdata,
+                             const int i,
+                             const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SPHGridBuildData *data = userdata;
+  sph_grid_cell(data->grid, data->co[i], data->cell[i]);
+  data->bucket[i] = sph_grid_bucket(data->grid, data->cell[i]);
+}
 
-    if (need_rebuild) {
-      LOOP_SHOWN_PARTICLES
-      {
-        totpart++;
-      }
+/* Size of the cells, the interaction radius of the system so most queries visit 27 cells. */
+static float sph_grid_cell_size(ParticleSystem *psys, const float (*co)[3], int tot)
+{
+  ParticleSettings *part = psys->part;
+  float cell_size = 0.0f;
 
-      BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_WRITE);
+  if (part->fluid) {
+    cell_size = part->fluid->radius;
+    if (part->fluid->flag & SPH_FAC_RADIUS) {
+      cell_size *= 4.0f * part->size;
+    }
+  }
 
-      BLI_bvhtree_free(psys->bvhtree);
-      psys->bvhtree = BLI_bvhtree_new(totpart, 0.0, 4, 6);
+  /* Don't let a tiny radius create a huge number of cells. */
+  float min[3], max[3];
+  INIT_MINMAX(min, max);
+  for (int i = 0; i < tot; i++) {
+    minmax_v3v3_v3(min, max, co[i]);
+  }
+  float extent[3];
+  sub_v3_v3v3(extent, max, min);
+  const float extent_max = max_fff(extent[0], extent[1], extent[2]);
+  return max_fff(cell_size, extent_max / 1024.0f, FLT_EPSILON);
+}
 
-      LOOP_SHOWN_PARTICLES
-      {
-        if (pa->alive == PARS_ALIVE) {
-          if (pa->state.time == cfra) {
-            BLI_bvhtree_insert(psys->bvhtree, p, pa->prev_state.co, 1);
+static void sph_grid_build(ParticleSPHGrid *grid, ParticleSystem *psys, float cfra)
+{
+  PARTICLE_P;
+  int tot = 0;
+
+  LOOP_SHOWN_PARTICLES
+  {
+    if (pa->alive == PARS_ALIVE) {
+      tot++;
+    }
+  }
+
+  if (grid->alloc < tot) {
+    MEM_SAFE_FREE(grid->index);
+    MEM_SAFE_FREE(grid->cell);
+    MEM_SAFE_FREE(grid->co);
+    grid->index = MEM_mallocN(sizeof(*grid->index) * (size_t)tot, __func__);
+    grid->cell = MEM_mallocN(sizeof(*grid->cell) * (size_t)tot, __func__);
+    grid->co = MEM_mallocN(sizeof(*grid->co) * (size_t)tot, __func__);
+    grid->alloc = tot;
+  }
+  grid->tot = tot;
+
+  const int bucket_num = (int)power_of_2_max_u((uint)max_ii(tot, 1) * 2);
+  if (grid->bucket_num != bucket_num) {
+    MEM_SAFE_FREE(grid->bucket_offsets);
+    grid->bucket_offsets = MEM_mallocN(sizeof(int) * (size_t)(bucket_num + 1), __func__);
+    grid->bucket_num = bucket_num;
+  }
+  int *bucket_offsets = grid->bucket_offsets;
+  memset(bucket_offsets, 0, sizeof(int) * (size_t)(bucket_num + 1));
+
+  if (tot == 0) {
+    return;
+  }
+
+  /* Unsorted particles, in index order. */
+  int *index = MEM_mallocN(sizeof(*index) * (size_t)tot, __func__);
+  float(*co)[3] = MEM_mallocN(sizeof(*co) * (size_t)tot, __func__);
+  int(*cell)[3] = MEM_mallocN(sizeof(*cell) * (size_t)tot, __func__);
+  int *bucket = MEM_mallocN(sizeof(*bucket) * (size_t)tot, __func__);
+
+  int i = 0;
+  LOOP_SHOWN_PARTICLES
+  {
+    if (pa->alive == PARS_ALIVE) {
+      index[i] = p;
+      copy_v3_v3(co[i], (pa->state.time == cfra) ? pa->prev_state.co : pa->state.co);
+      i++;
+    }
+  }
+
+  grid->cell_size_inv = 1.0f / sph_grid_cell_size(psys, (const float(*)[3])co, tot);
+
+  SPHGridBuildData data = {
+      .grid = grid,
+      .index = index,
+      .co = (const float(*)[3])co,
+      .cell = cell,
+      .bucket = bucket,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  BLI_task_parallel_range(0, tot, &data, sph_grid_cell_cb, &settings);
+
+  copy_v3_v3_int(grid->cell_min, cell[0]);
+  copy_v3_v3_int(grid->cell_max, cell[0]);
+  for (i = 1; i < tot; i++) {
+    for (int axis = 0; axis < 3; axis++) {
+      grid->cell_min[axis] = min_ii(grid->cell_min[axis], cell[i][axis]);
+      grid->cell_max[axis] = max_ii(grid->cell_max[axis], cell[i][axis]);
+    }
+  }
+
+  /* Counting sort, stable so particles of a bucket stay in index order. */
+  for (i = 0; i < tot; i++) {
+    bucket_offsets[bucket[i] + 1]++;
+  }
+  for (i = 0; i < bucket_num; i++) {
+    bucket_offsets[i + 1] += bucket_offsets[i];
+  }
+  for (i = 0; i < tot; i++) {
+    /* Offsets are shifted back by one while filling. */
+    const int j = bucket_offsets[bucket[i]]++;
+    grid->index[j] = index[i];
+    copy_v3_v3_int(grid->cell[j], cell[i]);
+    copy_v3_v3(grid->co[j], co[i]);
+  }
+  memmove(bucket_offsets + 1, bucket_offsets, sizeof(int) * (size_t)bucket_num);
+  bucket_offsets[0] = 0;
+
+  MEM_freeN(index);
+  MEM_freeN(co);
+  MEM_freeN(cell);
+  MEM_freeN(bucket);
+}
+
+/**
+ * Call `callback` for all particles closer than `radius` to `co`, like a BVH range query.
+ *
+ * The radius may be larger than the cells, when a system with a larger interaction radius
+ * queries another system's grid. The visited cells are clamped to the occupied cells, and
+ * when that still is more cells than particles, all particles are tested directly.
+ */
+static void sph_grid_range_query(const ParticleSPHGrid *grid,
+                                 const float co[3],
+                                 float radius,
+                                 BVHTree_RangeQuery callback,
+                                 void *userdata)
+{
+  const float radius_sq = radius * radius;
+  int cell_min[3], cell_max[3], cell[3];
+  int64_t cells_num = 1;
+
+  if (grid->tot == 0) {
+    return;
+  }
+
+  /* Clamp before converting to int, so far away queries or huge radii can't overflow. */
+  for (int axis = 0; axis < 3; axis++) {
+    const float lo = floorf((co[axis] - radius) * grid->cell_size_inv);
+    const float hi = floorf((co[axis] + radius) * grid->cell_size_inv);
+    if (!(hi >= (float)grid->cell_min[axis] && lo <= (float)grid->cell_max[axis])) {
+      return;
+    }
+    cell_min[axis] = (lo > (float)grid->cell_min[axis]) ? (int)lo : grid->cell_min[axis];
+    cell_max[axis] = (hi < (float)grid->cell_max[axis]) ? (int)hi : grid->cell_max[axis];
+    cells_num *= (int64_t)(cell_max[axis] - cell_min[axis] + 1);
+  }
+
+  if (cells_num > (int64_t)grid->tot) {
+    for (int i = 0; i < grid->tot; i++) {
+      const float dist_sq = len_squared_v3v3(co, grid->co[i]);
+      if (dist_sq < radius_sq) {
+        callback(userdata, grid->index[i], co, dist_sq);
+      }
+    }
+    return;
+  }
+
+  for (cell[0] = cell_min[0]; cell[0] <= cell_max[0]; cell[0]++) {
+    for (cell[1] = cell_min[1]; cell[1] <= cell_max[1]; cell[1]++) {
+      for (cell[2] = cell_min[2]; cell[2] <= cell_max[2]; cell[2]++) {
+        const int bucket = sph_grid_bucket(grid, cell);
+        const int end = grid->bucket_offsets[bucket + 1];
+        for (int i = grid->bucket_offsets[bucket]; i < end; i++) {
+          if (!equals_v3v3_int(grid->cell[i], cell)) {
+            continue;
           }
-          else {
-            BLI_bvhtree_insert(psys->bvhtree, p, pa->state.co, 1);
+          const float dist_sq = len_squared_v3v3(co, grid->co[i]);
+          if (dist_sq < radius_sq) {
+            callback(userdata, grid->index[i], co, dist_sq);
           }
         }
       }
+    }
+  }
+}
+
+void psys_sph_grid_free(ParticleSPHGrid *grid)
+{
+  if (grid) {
+    MEM_SAFE_FREE(grid->bucket_offsets);
+    MEM_SAFE_FREE(grid->index);
+    MEM_SAFE_FREE(grid->cell);
+    MEM_SAFE_FREE(grid->co);
+    MEM_freeN(grid);
+  }
+}
+
+/************************************************/
+/*          Effectors                           */
+/************************************************/
+static void psys_update_particle_sph_grid(ParticleSystem *psys, float cfra)
+{
+  if (psys) {
+    bool need_rebuild;
 
-      BLI_task_isolate(bvhtree_balance_isolated, psys->bvhtree);
+    BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_READ);
+    need_rebuild = !psys->sph_grid || psys->sph_grid_frame != cfra;
+    BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
 
-      psys->bvhtree_frame = cfra;
+    if (need_rebuild) {
+      BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_WRITE);
 
-      BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
+      if (psys->sph_grid == NULL) {
+        psys->sph_grid = MEM_callocN(sizeof(ParticleSPHGrid), __func__);
+      }
+      sph_grid_build(psys->sph_grid, psys, cfra);
+
+      psys->sph_grid_frame = cfra;
+
+      BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
     }
   }
 }
@@ -1702,8 +1929,7 @@ typedef struct SPHRangeData {
   int use_size;
 } SPHRangeData;
 
-static void sph_evaluate_func(BVHTree *tree,
-                              ParticleSystem **psys,
+static void sph_evaluate_func(ParticleSystem **psys,
                               const float co[3],
                               SPHRangeData *pfr,
                               float interaction_radius,
@@ -1718,16 +1944,13 @@ static void sph_evaluate_func(BVHTree *tree,
     pfr->massfac = psys[i]->part->mass / pfr->mass;
     pfr->use_size = psys[i]->part->flag & PART_SIZEMASS;
 
-    if (tree) {
-      BLI_bvhtree_range_query(tree, co, interaction_radius, callback, pfr);
-      break;
-    }
-
-    BLI_rw_mutex_lock(&psys_bvhtree_rwlock, THREAD_LOCK_READ);
+    BLI_rw_mutex_lock(&psys_sph_grid_rwlock, THREAD_LOCK_READ);
 
-    BLI_bvhtree_range_query(psys[i]->bvhtree, co, interaction_radius, callback, pfr);
+    if (psys[i]->sph_grid) {
+      sph_grid_range_query(psys[i]->sph_grid, co, interaction_radius, callback, pfr);
+    }
 
-    BLI_rw_mutex_unlock(&psys_bvhtree_rwlock);
+    BLI_rw_mutex_unlock(&psys_sph_grid_rwlock);
   }
 }
 static void sph_density_accum_cb(void *userdata, int index, const float co[3], float squared_dist)
@@ -1847,7 +2070,7 @@ static void sph_force_cb(void *sphdata_v, ParticleKey *state, float *force, floa
   pfr.pa = pa;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(NULL, psys, state->co, &pfr, interaction_radius, sph_density_accum_cb);
+  sph_evaluate_func(psys, state->co, &pfr, interaction_radius, sph_density_accum_cb);
 
   density = data[0];
   near_density = data[1];
@@ -2039,8 +2262,7 @@ static void sphclassical_force_cb(void *sphdata_v,
   pfr.h = h;
   pfr.pa = pa;
 
-  sph_evaluate_func(
-      NULL, psys, state->co, &pfr, interaction_radius, sphclassical_neighbor_accum_cb);
+  sph_evaluate_func(psys, state->co, &pfr, interaction_radius, sphclassical_neighbor_accum_cb);
   pressure = stiffness * (pow7f(pa->sphdensity / rest_density) - 1.0f);
 
   /* multiply by mass so that we return a force, not accel */
@@ -2123,8 +2345,7 @@ static void sphclassical_calc_dens(ParticleData *pa, float UNUSED(dfra), SPHData
   pfr.pa = pa;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(
-      NULL, psys, pa->state.co, &pfr, interaction_radius, sphclassical_density_accum_cb);
+  sph_evaluate_func(psys, pa->state.co, &pfr, interaction_radius, sphclassical_density_accum_cb);
   pa->sphdensity = min_ff(max_ff(data[0], fluid->rest_density * 0.9f), fluid->rest_density * 1.1f);
 }
 
@@ -2188,7 +2409,7 @@ void psys_sph_finalize(SPHData *sphdata)
 }
 
 /* Sample the density field at a point in space. */
-void psys_sph_density(BVHTree *tree, SPHData *sphdata, float co[3], float vars[2])
+void psys_sph_density(SPHData *sphdata, float co[3], float vars[2])
 {
   ParticleSystem **psys = sphdata->psys;
   SPHFluidSettings *fluid = psys[0]->part->fluid;
@@ -2203,7 +2424,7 @@ void psys_sph_density(BVHTree *tree, SPHData *sphdata, float co[3], float vars[2
   pfr.h = interaction_radius * sphdata->hfac;
   pfr.mass = sphdata->mass;
 
-  sph_evaluate_func(tree, psys, co, &pfr, interaction_radius, sphdata->density_cb);
+  sph_evaluate_func(psys, co, &pfr, interaction_radius, sphdata->density_cb);
 
   vars[0] = pfr.data[0];
   vars[1] = pfr.data[1];
@@ -3892,12 +4113,13 @@ static void dynamics_step(ParticleSimulationData *sim, float cfra)
     }
     case PART_PHYS_FLUID: {
       ParticleTarget *pt = psys->targets.first;
-      psys_update_particle_bvhtree(psys, cfra);
+      psys_update_particle_sph_grid(psys, cfra);
 
       for (; pt;
            pt = pt->next) { /* Updating others systems particle tree for fluid-fluid interaction */
         if (pt->ob) {
-          psys_update_particle_bvhtree(BLI_findlink(&pt->ob->particlesystem, pt->psys - 1), cfra);
+          psys_update_particle_sph_grid(BLI_findlink(&pt->ob->particlesystem, pt->psys - 1),
+                                        cfra);
         }
       }
       break;
@@ -32,6 +32,7 @@
 #include "DNA_meshdata_types.h"
 
 #include "BKE_ccg.h"
+#include "BKE_global.h"
 #include "BKE_mesh.h" /* for BKE_mesh_calc_normals */
 #include "BKE_paint.h"
 #include "BKE_pbvh.h"
@@ -249,43 +250,76 @@ void pbvh_grow_nodes(PBVH *pbvh, int totnode)
   pbvh->totnode = totnode;
 }
 
-/* Add a vertex to the map, with a positive value for unique vertices and
- * a negative value for additional vertices */
-static int map_insert_vert(
-    PBVH *pbvh, GHash *map, unsigned int *face_verts, unsigned int *uniq_verts, int vertex)
+/* Leaf nodes are indexed in their build order while assigning vertices. */
+typedef struct PBVHBuildLeavesData {
+  PBVH *pbvh;
+  /* Node index of every leaf, in build order. */
+  const int *leaf_nodes;
+  /* First leaf using every vertex, which is the vertex' owner. Tagged with
+   * #PBVH_VERT_OWNER_ASSIGNED once the vertex is added to its owner. */
+  int *vert_owner;
+  /* Index of every vertex in its owner's vert_indices. */
+  int *vert_node_index;
+} PBVHBuildLeavesData;
+
+#define PBVH_VERT_OWNER_ASSIGNED (1 << 30)
+
+static void vert_owner_update(int *vert_owner, const int leaf)
+{
+  int owner = *vert_owner;
+  while (leaf < owner) {
+    const int owner_prev = atomic_cas_int32(vert_owner, owner, leaf);
+    if (owner_prev == owner) {
+      break;
+    }
+    owner = owner_prev;
+  }
+}
+
+static void build_mesh_leaf_vert_owners_cb(void *__restrict userdata,
+                                           const int leaf,
+                                           const TaskParallelTLS *__restrict UNUSED(tls))
 {
-  void *key, **value_p;
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  const PBVHNode *node = &pbvh->nodes[data->leaf_nodes[leaf]];
 
-  key = POINTER_FROM_INT(vertex);
-  if (!BLI_ghash_ensure_p(map, key, &value_p)) {
-    int value_i;
-    if (BLI_BITMAP_TEST(pbvh->vert_bitmap, vertex) == 0) {
-      BLI_BITMAP_ENABLE(pbvh->vert_bitmap, vertex);
-      value_i = *uniq_verts;
-      (*uniq_verts)++;
-    }
-    else {
-      value_i = ~(*face_verts);
-      (*face_verts)++;
+  for (int i = 0; i < node->totprim; i++) {
+    const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
+    for (int j = 0; j < 3; j++) {
+      vert_owner_update(&data->vert_owner[pbvh->mloop[lt->tri[j]].v], leaf);
     }
-    *value_p = POINTER_FROM_INT(value_i);
-    return value_i;
   }
+}
+
+typedef struct PBVHSharedVert {
+  int vert;
+  /* Index into the node's face_vert_indices, as a flat array. */
+  int corner;
+} PBVHSharedVert;
 
-  return POINTER_AS_INT(*value_p);
+static int shared_vert_cmp(const void *a_v, const void *b_v)
+{
+  const PBVHSharedVert *a = a_v;
+  const PBVHSharedVert *b = b_v;
+  if (a->vert != b->vert) {
+    return (a->vert < b->vert) ? -1 : 1;
+  }
+  return (a->corner < b->corner) ? -1 : (a->corner > b->corner);
 }
 
 /* Find vertices used by the faces in this node and update the draw buffers */
-static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
+static void build_mesh_leaf_node_cb(void *__restrict userdata,
+                                    const int leaf,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  PBVHNode *node = &pbvh->nodes[data->leaf_nodes[leaf]];
   bool has_visible = false;
 
-  node->uniq_verts = node->face_verts = 0;
   const int totface = node->totprim;
 
-  /* reserve size is rough guess */
-  GHash *map = BLI_ghash_int_new_ex("build_mesh_leaf_node gh", 2 * totface);
-
   int(*face_vert_indices)[3] = MEM_mallocN(sizeof(int[3]) * totface, "bvh node face vert indices");
 
   node->face_vert_indices = (const int(*)[3])face_vert_indices;
@@ -294,11 +328,32 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
     has_visible = true;
   }
 
+  /* At most every corner uses its own vertex, shrunk to the actual size below. */
+  int *vert_indices = MEM_mallocN(sizeof(int) * totface * 3, "bvh node vert indices");
+  PBVHSharedVert *shared_verts = MEM_mallocN(sizeof(PBVHSharedVert) * totface * 3, __func__);
+  int uniq_verts = 0;
+  int totshared = 0;
+
+  /* Unique verts first, in the order they are used. */
   for (int i = 0; i < totface; i++) {
     const MLoopTri *lt = &pbvh->looptri[node->prim_indices[i]];
     for (int j = 0; j < 3; j++) {
-      face_vert_indices[i][j] = map_insert_vert(
-          pbvh, map, &node->face_verts, &node->uniq_verts, pbvh->mloop[lt->tri[j]].v);
+      const int vert = pbvh->mloop[lt->tri[j]].v;
+      const int owner = data->vert_owner[vert];
+      if (owner == leaf) {
+        data->vert_owner[vert] = leaf | PBVH_VERT_OWNER_ASSIGNED;
+        data->vert_node_index[vert] = uniq_verts;
+        vert_indices[uniq_verts++] = vert;
+        face_vert_indices[i][j] = data->vert_node_index[vert];
+      }
+      else if (owner == (leaf | PBVH_VERT_OWNER_ASSIGNED)) {
+        face_vert_indices[i][j] = data->vert_node_index[vert];
+      }
+      else {
+        shared_verts[totshared].vert = vert;
+        shared_verts[totshared].corner = i * 3 + j;
+        totshared++;
+      }
     }
 
     if (has_visible == false) {
@@ -308,47 +363,57 @@ static void build_mesh_leaf_node(PBVH *pbvh, PBVHNode *node)
     }
   }
 
-  int *vert_indices = MEM_callocN(sizeof(int) * (node->uniq_verts + node->face_verts),
-                                  "bvh node vert indices");
-  node->vert_indices = vert_indices;
-
-  /* Build the vertex list, unique verts first */
-  GHashIterator gh_iter;
-  GHASH_ITER (gh_iter, map) {
-    void *value = BLI_ghashIterator_getValue(&gh_iter);
-    int ndx = POINTER_AS_INT(value);
-
-    if (ndx < 0) {
-      ndx = -ndx + node->uniq_verts - 1;
+  /* Vertices owned by other nodes follow, sorted by their index. */
+  qsort(shared_verts, totshared, sizeof(PBVHSharedVert), shared_vert_cmp);
+  int face_verts = 0;
+  for (int i = 0; i < totshared; i++) {
+    if (i == 0 || shared_verts[i].vert != shared_verts[i - 1].vert) {
+      vert_indices[uniq_verts + face_verts] = shared_verts[i].vert;
+      face_verts++;
     }
-
-    vert_indices[ndx] = POINTER_AS_INT(BLI_ghashIterator_getKey(&gh_iter));
+    ((int *)face_vert_indices)[shared_verts[i].corner] = uniq_verts + face_verts - 1;
   }
+  MEM_freeN(shared_verts);
 
-  for (int i = 0; i < totface; i++) {
-    const int sides = 3;
-
-    for (int j = 0; j < sides; j++) {
-      if (face_vert_indices[i][j] < 0) {
-        face_vert_indices[i][j] = -face_vert_indices[i][j] + node->uniq_verts - 1;
-      }
-    }
-  }
+  node->uniq_verts = uniq_verts;
+  node->face_verts = face_verts;
+  node->vert_indices = MEM_reallocN(vert_indices, sizeof(int) * (uniq_verts + face_verts));
 
   BKE_pbvh_node_mark_rebuild_draw(node);
 
   BKE_pbvh_node_fully_hidden_set(node, !has_visible);
+}
+
+/* Build all mesh leaves in parallel. Every vertex is unique to the first leaf using it, which
+ * is what building the leaves one by one in build order would give. */
+static void build_mesh_leaves(PBVH *pbvh, const int *leaf_nodes, const int totleaf)
+{
+  BLI_assert(totleaf < PBVH_VERT_OWNER_ASSIGNED);
+
+  PBVHBuildLeavesData data = {
+      .pbvh = pbvh,
+      .leaf_nodes = leaf_nodes,
+      .vert_owner = MEM_malloc_arrayN(pbvh->totvert, sizeof(int), "bvh vert owner"),
+      .vert_node_index = MEM_malloc_arrayN(pbvh->totvert, sizeof(int), "bvh vert node index"),
+  };
+  copy_vn_i(data.vert_owner, pbvh->totvert, INT_MAX);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, totleaf, &data, build_mesh_leaf_vert_owners_cb, &settings);
+  BLI_task_parallel_range(0, totleaf, &data, build_mesh_leaf_node_cb, &settings);
 
-  BLI_ghash_free(map, NULL, NULL);
+  MEM_freeN(data.vert_owner);
+  MEM_freeN(data.vert_node_index);
 }
 
-static void update_vb(PBVH *pbvh, PBVHNode *node, BBC *prim_bbc, int offset, int count)
+static void update_vb(PBVH *pbvh, BB *vb, BBC *prim_bbc, int offset, int count)
 {
-  BB_reset(&node->vb);
+  BB_reset(vb);
   for (int i = offset + count - 1; i >= offset; i--) {
-    BB_expand_with_bb(&node->vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
+    BB_expand_with_bb(vb, (BB *)(&prim_bbc[pbvh->prim_indices[i]]));
   }
-  node->orig_vb = node->vb;
 }
 
 /* Returns the number of visible quads in the nodes' grids. */
@@ -404,30 +469,30 @@ void BKE_pbvh_sync_face_sets_to_grids(PBVH *pbvh)
   }
 }
 
-static void build_grid_leaf_node(PBVH *pbvh, PBVHNode *node)
+static void build_grid_leaf_node_cb(void *__restrict userdata,
+                                    const int leaf,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  PBVHBuildLeavesData *data = userdata;
+  PBVH *pbvh = data->pbvh;
+  PBVHNode *node = &pbvh->nodes[data->leaf_nodes[leaf]];
   int totquads = BKE_pbvh_count_grid_quads(
       pbvh->grid_hidden, node->prim_indices, node->totprim, pbvh->gridkey.grid_size);
   BKE_pbvh_node_fully_hidden_set(node, (totquads == 0));
   BKE_pbvh_node_mark_rebuild_draw(node);
 }
 
-static void build_leaf(PBVH *pbvh, int node_index, BBC *prim_bbc, int offset, int count)
+static void build_grid_leaves(PBVH *pbvh, const int *leaf_nodes, const int totleaf)
 {
-  pbvh->nodes[node_index].flag |= PBVH_Leaf;
-
-  pbvh->nodes[node_index].prim_indices = pbvh->prim_indices + offset;
-  pbvh->nodes[node_index].totprim = count;
-
-  /* Still need vb for searches */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
+  PBVHBuildLeavesData data = {
+      .pbvh = pbvh,
+      .leaf_nodes = leaf_nodes,
+  };
 
-  if (pbvh->looptri) {
-    build_mesh_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
-  else {
-    build_grid_leaf_node(pbvh, pbvh->nodes + node_index);
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, totleaf, &data, build_grid_leaf_node_cb, &settings);
 }
 
 /* Return zero if all primitives in the node can be drawn with the
@@ -464,19 +529,48 @@ static bool leaf_needs_material_split(PBVH *pbvh, int offset, int count)
   return false;
 }
 
+/* Node of the tree while it's being built, before it's stored in #PBVH.nodes. */
+typedef struct PBVHBuildNode {
+  /* Two child nodes, NULL for leaves. */
+  struct PBVHBuildNode *children;
+  /* Range in the array of primitive indices. */
+  int offset;
+  int count;
+  BB vb;
+} PBVHBuildNode;
+
+typedef struct PBVHBuildData {
+  PBVH *pbvh;
+  BBC *prim_bbc;
+  /* NULL when the tree is too small to build subtrees in parallel. */
+  TaskPool *task_pool;
+} PBVHBuildData;
+
+/* Subtrees with fewer primitives are built in the task of their parent. */
+#define PBVH_BUILD_TASK_MIN_PRIMS (LEAF_LIMIT * 8)
+
+static void build_sub(PBVHBuildData *data, PBVHBuildNode *build_node, BB *cb);
+
+static void build_sub_task(TaskPool *__restrict pool, void *taskdata)
+{
+  build_sub(BLI_task_pool_user_data(pool), taskdata, NULL);
+}
+
 /* Recursively build a node in the tree
- *
- * vb is the voxel box around all of the primitives contained in
- * this node.
  *
  * cb is the bounding box around all the centroids of the primitives
  * contained in this node
  *
- * offset and start indicate a range in the array of primitive indices
+ * Partitioning only touches the range of primitive indices of the node,
+ * so large subtrees are built in parallel.
  */
 
-static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int offset, int count)
+static void build_sub(PBVHBuildData *data, PBVHBuildNode *build_node, BB *cb)
 {
+  PBVH *pbvh = data->pbvh;
+  BBC *prim_bbc = data->prim_bbc;
+  const int offset = build_node->offset;
+  const int count = build_node->count;
   int end;
   BB cb_backing;
 
@@ -484,18 +578,12 @@ static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int off
   const bool below_leaf_limit = count <= pbvh->leaf_limit;
   if (below_leaf_limit) {
     if (!leaf_needs_material_split(pbvh, offset, count)) {
-      build_leaf(pbvh, node_index, prim_bbc, offset, count);
+      /* Still need vb for searches */
+      update_vb(pbvh, &build_node->vb, prim_bbc, offset, count);
       return;
     }
   }
 
-  /* Add two child nodes */
-  pbvh->nodes[node_index].children_offset = pbvh->totnode;
-  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
-
-  /* Update parent node bounding box */
-  update_vb(pbvh, &pbvh->nodes[node_index], prim_bbc, offset, count);
-
   if (!below_leaf_limit) {
     /* Find axis with widest range of primitive centroids */
     if (!cb) {
@@ -520,18 +608,73 @@ static void build_sub(PBVH *pbvh, int node_index, BB *cb, BBC *prim_bbc, int off
     end = partition_indices_material(pbvh, offset, offset + count - 1);
   }
 
+  /* Add two child nodes */
+  PBVHBuildNode *children = MEM_callocN(sizeof(PBVHBuildNode[2]), __func__);
+  children[0].offset = offset;
+  children[0].count = end - offset;
+  children[1].offset = end;
+  children[1].count = offset + count - end;
+  build_node->children = children;
+
   /* Build children */
-  build_sub(pbvh, pbvh->nodes[node_index].children_offset, NULL, prim_bbc, offset, end - offset);
-  build_sub(pbvh,
-            pbvh->nodes[node_index].children_offset + 1,
-            NULL,
-            prim_bbc,
-            end,
-            offset + count - end);
+  if (data->task_pool != NULL && children[0].count >= PBVH_BUILD_TASK_MIN_PRIMS) {
+    BLI_task_pool_push(data->task_pool, build_sub_task, &children[0], false, NULL);
+  }
+  else {
+    build_sub(data, &children[0], NULL);
+  }
+  build_sub(data, &children[1], NULL);
+}
+
+typedef struct PBVHLeafNodes {
+  int *nodes;
+  int totnode;
+  int alloc_len;
+} PBVHLeafNodes;
+
+/* Store the build tree in #PBVH.nodes. Nodes get the same indices as when building the tree
+ * depth first, with both children of a node next to each other. */
+static void pbvh_build_flatten(PBVH *pbvh,
+                               int node_index,
+                               PBVHBuildNode *build_node,
+                               PBVHLeafNodes *leaves)
+{
+  if (build_node->children == NULL) {
+    PBVHNode *node = &pbvh->nodes[node_index];
+    node->flag |= PBVH_Leaf;
+    node->prim_indices = pbvh->prim_indices + build_node->offset;
+    node->totprim = build_node->count;
+    node->vb = build_node->vb;
+    node->orig_vb = node->vb;
+
+    if (leaves->totnode == leaves->alloc_len) {
+      leaves->alloc_len = max_ii(leaves->alloc_len * 2, 64);
+      leaves->nodes = MEM_reallocN(leaves->nodes, sizeof(int) * leaves->alloc_len);
+    }
+    leaves->nodes[leaves->totnode++] = node_index;
+    return;
+  }
+
+  const int children_offset = pbvh->totnode;
+  pbvh->nodes[node_index].children_offset = children_offset;
+  pbvh_grow_nodes(pbvh, pbvh->totnode + 2);
+
+  /* Update parent node bounding box */
+  BB_reset(&build_node->vb);
+  for (int i = 0; i < 2; i++) {
+    pbvh_build_flatten(pbvh, children_offset + i, &build_node->children[i], leaves);
+    BB_expand_with_bb(&build_node->vb, &build_node->children[i].vb);
+  }
+  pbvh->nodes[node_index].vb = build_node->vb;
+  pbvh->nodes[node_index].orig_vb = build_node->vb;
+
+  MEM_freeN(build_node->children);
 }
 
 static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
 {
+  const double start_time = PIL_check_seconds_timer();
+
   if (totprim != pbvh->totprim) {
     pbvh->totprim = totprim;
     if (pbvh->nodes) {
@@ -551,8 +694,117 @@ static void pbvh_build(PBVH *pbvh, BB *cb, BBC *prim_bbc, int totprim)
     }
   }
 
+  PBVHBuildData data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+  };
+  if (totprim >= PBVH_BUILD_TASK_MIN_PRIMS) {
+    data.task_pool = BLI_task_pool_create(&data, TASK_PRIORITY_HIGH);
+  }
+
+  PBVHBuildNode root = {NULL};
+  root.offset = 0;
+  root.count = totprim;
+  build_sub(&data, &root, cb);
+
+  if (data.task_pool != NULL) {
+    BLI_task_pool_work_and_wait(data.task_pool);
+    BLI_task_pool_free(data.task_pool);
+  }
+
+  PBVHLeafNodes leaves = {NULL};
   pbvh->totnode = 1;
-  build_sub(pbvh, 0, cb, prim_bbc, 0, totprim);
+  pbvh_build_flatten(pbvh, 0, &root, &leaves);
+
+  if (pbvh->looptri) {
+    build_mesh_leaves(pbvh, leaves.nodes, leaves.totnode);
+  }
+  else {
+    build_grid_leaves(pbvh, leaves.nodes, leaves.totnode);
+  }
+  MEM_SAFE_FREE(leaves.nodes);
+
+  if (G.debug & G_DEBUG) {
+    printf("PBVH build: %d primitives, %d nodes, %d leaves in %f seconds\n",
+           totprim,
+           pbvh->totnode,
+           leaves.totnode,
+           PIL_check_seconds_timer() - start_time);
+  }
+}
+
+typedef struct PBVHBuildBBCData {
+  PBVH *pbvh;
+  BBC *prim_bbc;
+  const MLoopTri *looptri;
+  const MVert *verts;
+  CCGElem **grids;
+  const CCGKey *key;
+} PBVHBuildBBCData;
+
+static void build_mesh_prim_bbc_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict tls)
+{
+  PBVHBuildBBCData *data = userdata;
+  const MLoopTri *lt = &data->looptri[i];
+  const int sides = 3;
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < sides; j++) {
+    BB_expand((BB *)bbc, data->verts[data->pbvh->mloop[lt->tri[j]].v].co);
+  }
+
+  BBC_update_centroid(bbc);
+
+  BB_expand(tls->userdata_chunk, bbc->bcentroid);
+}
+
+static void build_grid_prim_bbc_cb(void *__restrict userdata,
+                                   const int i,
+                                   const TaskParallelTLS *__restrict tls)
+{
+  PBVHBuildBBCData *data = userdata;
+  const CCGKey *key = data->key;
+  CCGElem *grid = data->grids[i];
+  BBC *bbc = data->prim_bbc + i;
+
+  BB_reset((BB *)bbc);
+
+  for (int j = 0; j < key->grid_area; j++) {
+    BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
+  }
+
+  BBC_update_centroid(bbc);
+
+  BB_expand(tls->userdata_chunk, bbc->bcentroid);
+}
+
+static void build_prim_bbc_reduce(const void *__restrict UNUSED(userdata),
+                                  void *__restrict chunk_join,
+                                  void *__restrict chunk)
+{
+  BB_expand_with_bb(chunk_join, chunk);
+}
+
+/* For each primitive, store the AABB and the AABB centroid,
+ * cb is the bounding box around all centroids. */
+static void build_prim_bbc(PBVHBuildBBCData *data,
+                           TaskParallelRangeFunc func,
+                           const int totprim,
+                           BB *r_cb)
+{
+  BB_reset(r_cb);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1024;
+  settings.userdata_chunk = r_cb;
+  settings.userdata_chunk_size = sizeof(*r_cb);
+  settings.func_reduce = build_prim_bbc_reduce;
+  BLI_task_parallel_range(0, totprim, data, func, &settings);
 }
 
 /**
@@ -582,7 +834,6 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   pbvh->mloop = mloop;
   pbvh->looptri = looptri;
   pbvh->verts = verts;
-  pbvh->vert_bitmap = BLI_BITMAP_NEW(totvert, "bvh->vert_bitmap");
   pbvh->totvert = totvert;
   pbvh->leaf_limit = LEAF_LIMIT;
   pbvh->vdata = vdata;
@@ -592,33 +843,22 @@ void BKE_pbvh_build_mesh(PBVH *pbvh,
   pbvh->face_sets_color_seed = mesh->face_sets_color_seed;
   pbvh->face_sets_color_default = mesh->face_sets_color_default;
 
-  BB_reset(&cb);
-
   /* For each face, store the AABB and the AABB centroid */
   prim_bbc = MEM_mallocN(sizeof(BBC) * looptri_num, "prim_bbc");
 
-  for (int i = 0; i < looptri_num; i++) {
-    const MLoopTri *lt = &looptri[i];
-    const int sides = 3;
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < sides; j++) {
-      BB_expand((BB *)bbc, verts[pbvh->mloop[lt->tri[j]].v].co);
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHBuildBBCData bbc_data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .looptri = looptri,
+      .verts = verts,
+  };
+  build_prim_bbc(&bbc_data, build_mesh_prim_bbc_cb, looptri_num, &cb);
 
   if (looptri_num) {
     pbvh_build(pbvh, &cb, prim_bbc, looptri_num);
   }
 
   MEM_freeN(prim_bbc);
-  MEM_freeN(pbvh->vert_bitmap);
 }
 
 /* Do a full rebuild with on Grids data structure */
@@ -642,25 +882,17 @@ void BKE_pbvh_build_grids(PBVH *pbvh,
   pbvh->leaf_limit = max_ii(LEAF_LIMIT / (gridsize * gridsize), 1);
 
   BB cb;
-  BB_reset(&cb);
 
   /* For each grid, store the AABB and the AABB centroid */
   BBC *prim_bbc = MEM_mallocN(sizeof(BBC) * totgrid, "prim_bbc");
 
-  for (int i = 0; i < totgrid; i++) {
-    CCGElem *grid = grids[i];
-    BBC *bbc = prim_bbc + i;
-
-    BB_reset((BB *)bbc);
-
-    for (int j = 0; j < gridsize * gridsize; j++) {
-      BB_expand((BB *)bbc, CCG_elem_offset_co(key, grid, j));
-    }
-
-    BBC_update_centroid(bbc);
-
-    BB_expand(&cb, bbc->bcentroid);
-  }
+  PBVHBuildBBCData bbc_data = {
+      .pbvh = pbvh,
+      .prim_bbc = prim_bbc,
+      .grids = grids,
+      .key = key,
+  };
+  build_prim_bbc(&bbc_data, build_grid_prim_bbc_cb, totgrid, &cb);
 
   if (totgrid) {
     pbvh_build(pbvh, &cb, prim_bbc, totgrid);
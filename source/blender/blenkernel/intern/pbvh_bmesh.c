@@ -25,6 +25,8 @@
 #include "BLI_heap_simple.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_DerivedMesh.h"
@@ -485,6 +487,24 @@ BLI_INLINE PBVHNode *pbvh_bmesh_node_from_face(PBVH *pbvh, const BMFace *key)
   return &pbvh->nodes[pbvh_bmesh_node_index_from_face(pbvh, key)];
 }
 
+/* BMesh element allocation and #BMLog aren't thread safe, changes to them are locked while the
+ * topology of nodes is changed in parallel, see #PBVH.bm_topology_threaded. */
+static ThreadMutex pbvh_bmesh_topology_mutex = BLI_MUTEX_INITIALIZER;
+
+BLI_INLINE void pbvh_bmesh_topology_lock(const PBVH *pbvh)
+{
+  if (pbvh->bm_topology_threaded) {
+    BLI_mutex_lock(&pbvh_bmesh_topology_mutex);
+  }
+}
+
+BLI_INLINE void pbvh_bmesh_topology_unlock(const PBVH *pbvh)
+{
+  if (pbvh->bm_topology_threaded) {
+    BLI_mutex_unlock(&pbvh_bmesh_topology_mutex);
+  }
+}
+
 static BMVert *pbvh_bmesh_vert_create(PBVH *pbvh,
                                       int node_index,
                                       const float co[3],
@@ -496,8 +516,10 @@ static BMVert *pbvh_bmesh_vert_create(PBVH *pbvh,
   BLI_assert((pbvh->totnode == 1 || node_index) && node_index <= pbvh->totnode);
 
   /* avoid initializing customdata because its quite involved */
+  pbvh_bmesh_topology_lock(pbvh);
   BMVert *v = BM_vert_create(pbvh->bm, co, NULL, BM_CREATE_SKIP_CD);
   CustomData_bmesh_set_default(&pbvh->bm->vdata, &v->head.data);
+  pbvh_bmesh_topology_unlock(pbvh);
 
   /* This value is logged below */
   copy_v3_v3(v->no, no);
@@ -508,7 +530,9 @@ static BMVert *pbvh_bmesh_vert_create(PBVH *pbvh,
   node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateBB;
 
   /* Log the new vertex */
+  pbvh_bmesh_topology_lock(pbvh);
   BM_log_vert_added(pbvh->bm_log, v, cd_vert_mask_offset);
+  pbvh_bmesh_topology_unlock(pbvh);
 
   return v;
 }
@@ -524,7 +548,9 @@ static BMFace *pbvh_bmesh_face_create(
   /* ensure we never add existing face */
   BLI_assert(!BM_face_exists(v_tri, 3));
 
+  pbvh_bmesh_topology_lock(pbvh);
   BMFace *f = BM_face_create(pbvh->bm, v_tri, e_tri, 3, f_example, BM_CREATE_NOP);
+  pbvh_bmesh_topology_unlock(pbvh);
   f->head.hflag = f_example->head.hflag;
 
   BLI_gset_insert(node->bm_faces, f);
@@ -535,7 +561,9 @@ static BMFace *pbvh_bmesh_face_create(
   node->flag &= ~PBVH_FullyHidden;
 
   /* Log the new face */
+  pbvh_bmesh_topology_lock(pbvh);
   BM_log_face_added(pbvh->bm_log, f);
+  pbvh_bmesh_topology_unlock(pbvh);
 
   return f;
 }
@@ -689,7 +717,9 @@ static void pbvh_bmesh_face_remove(PBVH *pbvh, BMFace *f)
   BM_ELEM_CD_SET_INT(f, pbvh->cd_face_node_offset, DYNTOPO_NODE_NONE);
 
   /* Log removed face */
+  pbvh_bmesh_topology_lock(pbvh);
   BM_log_face_removed(pbvh->bm_log, f);
+  pbvh_bmesh_topology_unlock(pbvh);
 
   /* mark node for update */
   f_node->flag |= PBVH_UpdateDrawBuffers | PBVH_UpdateNormals;
@@ -746,6 +776,44 @@ typedef struct EdgeQueue {
 #endif
 } EdgeQueue;
 
+/* Edges found while the queue is created, before they are inserted. */
+typedef struct EdgeQueueCandidates {
+  struct EdgeQueueCandidate {
+    BMEdge *e;
+    float priority;
+  } * data;
+  int len;
+  int alloc_len;
+} EdgeQueueCandidates;
+
+/* Edges left for the serial pass by a node queue. Stored as vertex pairs like in the queue,
+ * since the edges may be deleted before the serial pass. */
+typedef struct EdgeQueueDeferred {
+  struct EdgeQueueDeferredPair {
+    BMVert *v1, *v2;
+    float priority;
+  } * data;
+  int len;
+  int alloc_len;
+} EdgeQueueDeferred;
+
+/**
+ * Queue of the edges only used by faces of one node.
+ *
+ * The queues of different nodes are processed in parallel. An edge is only changed there when
+ * all faces around the vertices it changes are in the node, so threads never touch the same
+ * elements. Other edges are deferred to the queue processed serially afterwards.
+ */
+typedef struct EdgeQueueNode {
+  EdgeQueue q;
+  BLI_mempool *pool;
+  int node_index;
+  EdgeQueueDeferred deferred;
+  /* Collapse only, see #pbvh_bmesh_collapse_short_edges. */
+  GHash *deleted_verts;
+  bool modified;
+} EdgeQueueNode;
+
 typedef struct {
   EdgeQueue *q;
   BLI_mempool *pool;
@@ -753,6 +821,18 @@ typedef struct {
   int cd_vert_mask_offset;
   int cd_vert_node_offset;
   int cd_face_node_offset;
+  /* When set, edges are added here instead of the queue (used while gathering edges in
+   * parallel, the queue and the edge tags are only modified when inserting the candidates). */
+  EdgeQueueCandidates *candidates;
+
+  /* Queues of nodes, processed before `q`. */
+  EdgeQueueNode *node_queues;
+  int node_queues_len;
+
+  /* The node while processing its queue, edges outside of it are added to `deferred` then.
+   * #DYNTOPO_NODE_NONE while processing `q`. */
+  int node_index;
+  EdgeQueueDeferred *deferred;
 } EdgeQueueContext;
 
 /* only tag'd edges are in the queue */
@@ -833,6 +913,126 @@ static bool check_mask(EdgeQueueContext *eq_ctx, BMVert *v)
   return BM_ELEM_CD_GET_FLOAT(v, eq_ctx->cd_vert_mask_offset) < 1.0f;
 }
 
+/* Node of all faces using the edge, #DYNTOPO_NODE_NONE when they are in different nodes or the
+ * edge has no faces. */
+static int edge_queue_edge_node_index(const EdgeQueueContext *eq_ctx, BMEdge *e)
+{
+  BMLoop *l_first = e->l;
+  if (l_first == NULL) {
+    return DYNTOPO_NODE_NONE;
+  }
+  const int node_index = BM_ELEM_CD_GET_INT(l_first->f, eq_ctx->cd_face_node_offset);
+  BMLoop *l_iter = l_first->radial_next;
+  for (; l_iter != l_first; l_iter = l_iter->radial_next) {
+    if (BM_ELEM_CD_GET_INT(l_iter->f, eq_ctx->cd_face_node_offset) != node_index) {
+      return DYNTOPO_NODE_NONE;
+    }
+  }
+  return node_index;
+}
+
+/* True when the vertex belongs to the node being processed and all its faces are in it, so no
+ * other thread reads or changes the vertex or its edges and faces. */
+static bool edge_queue_vert_in_node(const EdgeQueueContext *eq_ctx, BMVert *v)
+{
+  if (BM_ELEM_CD_GET_INT(v, eq_ctx->cd_vert_node_offset) != eq_ctx->node_index) {
+    return false;
+  }
+  BMEdge *e_first = v->e;
+  if (e_first == NULL) {
+    return false;
+  }
+  BMEdge *e_iter = e_first;
+  do {
+    if (edge_queue_edge_node_index(eq_ctx, e_iter) != eq_ctx->node_index) {
+      return false;
+    }
+  } while ((e_iter = BM_DISK_EDGE_NEXT(e_iter, v)) != e_first);
+  return true;
+}
+
+/* A split changes the edge's vertices and the opposite vertices of its faces.
+ *
+ * The edge also has to be the longest edge of its faces. The shared queue splits the longest
+ * edges first, a longer edge here may have been deferred. Splitting the shorter edges of its
+ * faces instead would keep creating thinner faces along it. */
+static bool edge_queue_split_in_node(const EdgeQueueContext *eq_ctx, BMEdge *e)
+{
+  if (!edge_queue_vert_in_node(eq_ctx, e->v1) || !edge_queue_vert_in_node(eq_ctx, e->v2)) {
+    return false;
+  }
+  const float len_sq = BM_edge_calc_length_squared(e);
+  BMLoop *l_iter = e->l;
+  do {
+    if (!edge_queue_vert_in_node(eq_ctx, l_iter->prev->v)) {
+      return false;
+    }
+    if ((BM_edge_calc_length_squared(l_iter->next->e) > len_sq) ||
+        (BM_edge_calc_length_squared(l_iter->prev->e) > len_sq)) {
+      return false;
+    }
+  } while ((l_iter = l_iter->radial_next) != e->l);
+  return true;
+}
+
+/* A collapse re-creates the faces around both vertices, changing all vertices around them. */
+static bool edge_queue_collapse_in_node(const EdgeQueueContext *eq_ctx, BMEdge *e)
+{
+  BMVert *v_pair[2] = {e->v1, e->v2};
+  for (int i = 0; i < 2; i++) {
+    if (!edge_queue_vert_in_node(eq_ctx, v_pair[i])) {
+      return false;
+    }
+  }
+  for (int i = 0; i < 2; i++) {
+    BMEdge *e_iter = v_pair[i]->e;
+    do {
+      if (!edge_queue_vert_in_node(eq_ctx, BM_edge_other_vert(e_iter, v_pair[i]))) {
+        return false;
+      }
+    } while ((e_iter = BM_DISK_EDGE_NEXT(e_iter, v_pair[i])) != v_pair[i]->e);
+  }
+  return true;
+}
+
+static void edge_queue_defer(EdgeQueueContext *eq_ctx, BMVert *v1, BMVert *v2, float priority)
+{
+  EdgeQueueDeferred *deferred = eq_ctx->deferred;
+  if (deferred->len == deferred->alloc_len) {
+    deferred->alloc_len = max_ii(deferred->alloc_len * 2, 64);
+    deferred->data = MEM_reallocN(deferred->data,
+                                  sizeof(*deferred->data) * (size_t)deferred->alloc_len);
+  }
+  deferred->data[deferred->len].v1 = v1;
+  deferred->data[deferred->len].v2 = v2;
+  deferred->data[deferred->len].priority = priority;
+  deferred->len++;
+}
+
+static void edge_queue_insert_unchecked(EdgeQueueContext *eq_ctx, BMEdge *e, float priority)
+{
+  BMVert **pair = BLI_mempool_alloc(eq_ctx->pool);
+  pair[0] = e->v1;
+  pair[1] = e->v2;
+  BLI_heapsimple_insert(eq_ctx->q->heap, priority, pair);
+#ifdef USE_EDGEQUEUE_TAG
+  BLI_assert(EDGE_QUEUE_TEST(e) == false);
+  EDGE_QUEUE_ENABLE(e);
+#endif
+}
+
+static void edge_queue_candidate_add(EdgeQueueCandidates *candidates, BMEdge *e, float priority)
+{
+  if (candidates->len == candidates->alloc_len) {
+    candidates->alloc_len = max_ii(candidates->alloc_len * 2, 64);
+    candidates->data = MEM_reallocN(candidates->data,
+                                    sizeof(*candidates->data) * (size_t)candidates->alloc_len);
+  }
+  candidates->data[candidates->len].e = e;
+  candidates->data[candidates->len].priority = priority;
+  candidates->len++;
+}
+
 static void edge_queue_insert(EdgeQueueContext *eq_ctx, BMEdge *e, float priority)
 {
   /* Don't let topology update affect fully masked vertices. This used to
@@ -845,14 +1045,16 @@ static void edge_queue_insert(EdgeQueueContext *eq_ctx, BMEdge *e, float priorit
        (check_mask(eq_ctx, e->v1) || check_mask(eq_ctx, e->v2))) &&
       !(BM_elem_flag_test_bool(e->v1, BM_ELEM_HIDDEN) ||
         BM_elem_flag_test_bool(e->v2, BM_ELEM_HIDDEN))) {
-    BMVert **pair = BLI_mempool_alloc(eq_ctx->pool);
-    pair[0] = e->v1;
-    pair[1] = e->v2;
-    BLI_heapsimple_insert(eq_ctx->q->heap, priority, pair);
-#ifdef USE_EDGEQUEUE_TAG
-    BLI_assert(EDGE_QUEUE_TEST(e) == false);
-    EDGE_QUEUE_ENABLE(e);
-#endif
+    if (eq_ctx->candidates) {
+      edge_queue_candidate_add(eq_ctx->candidates, e, priority);
+    }
+    else if (eq_ctx->node_index != DYNTOPO_NODE_NONE &&
+             edge_queue_edge_node_index(eq_ctx, e) != eq_ctx->node_index) {
+      edge_queue_defer(eq_ctx, e->v1, e->v2, priority);
+    }
+    else {
+      edge_queue_insert_unchecked(eq_ctx, e, priority);
+    }
   }
 }
 
@@ -910,6 +1112,12 @@ static void long_edge_queue_edge_add_recursive(
 
     BMLoop *l_iter = l_edge;
     do {
+      /* Faces of other nodes may be changed by other threads while processing a node queue,
+       * their edges are only deferred above. */
+      if (eq_ctx->node_index != DYNTOPO_NODE_NONE &&
+          BM_ELEM_CD_GET_INT(l_iter->f, eq_ctx->cd_face_node_offset) != eq_ctx->node_index) {
+        continue;
+      }
       BMLoop *l_adjacent[2] = {l_iter->next, l_iter->prev};
       for (int i = 0; i < ARRAY_SIZE(l_adjacent); i++) {
         float len_sq_other = BM_edge_calc_length_squared(l_adjacent[i]->e);
@@ -990,6 +1198,108 @@ static void short_edge_queue_face_add(EdgeQueueContext *eq_ctx, BMFace *f)
   }
 }
 
+typedef void (*EdgeQueueFaceAddFn)(EdgeQueueContext *eq_ctx, BMFace *f);
+
+typedef struct EdgeQueueGatherData {
+  const EdgeQueueContext *eq_ctx;
+  EdgeQueueFaceAddFn face_add;
+  PBVHNode **nodes;
+  EdgeQueueCandidates *candidates;
+} EdgeQueueGatherData;
+
+static void edge_queue_gather_node_cb(void *__restrict userdata,
+                                      const int n,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  EdgeQueueGatherData *data = userdata;
+  EdgeQueueContext eq_ctx = *data->eq_ctx;
+  eq_ctx.candidates = &data->candidates[n];
+
+  GSetIterator gs_iter;
+
+  /* Check each face */
+  GSET_ITER (gs_iter, data->nodes[n]->bm_faces) {
+    BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
+
+    data->face_add(&eq_ctx, f);
+  }
+}
+
+/* Fill the queues with the edges of all leaf nodes marked for topology update.
+ *
+ * Edges are gathered from the nodes in parallel, only reading the mesh. They are then inserted
+ * in the order of the nodes, skipping edges which are already queued. Edges only used by faces
+ * of one of these nodes go to the queue of that node, the others to the shared queue. */
+static void edge_queue_create_from_nodes(EdgeQueueContext *eq_ctx,
+                                         PBVH *pbvh,
+                                         EdgeQueueFaceAddFn face_add)
+{
+  PBVHNode **nodes = MEM_malloc_arrayN(pbvh->totnode, sizeof(*nodes), __func__);
+  int totnode = 0;
+
+  for (int n = 0; n < pbvh->totnode; n++) {
+    PBVHNode *node = &pbvh->nodes[n];
+
+    /* Check leaf nodes marked for topology update */
+    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateTopology) &&
+        !(node->flag & PBVH_FullyHidden)) {
+      nodes[totnode++] = node;
+    }
+  }
+
+  EdgeQueueGatherData data = {
+      .eq_ctx = eq_ctx,
+      .face_add = face_add,
+      .nodes = nodes,
+      .candidates = MEM_calloc_arrayN(totnode, sizeof(EdgeQueueCandidates), __func__),
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(0, totnode, &data, edge_queue_gather_node_cb, &settings);
+
+  /* Queue of each node, by node index. */
+  int *node_queue_index = MEM_malloc_arrayN(pbvh->totnode, sizeof(int), __func__);
+  copy_vn_i(node_queue_index, pbvh->totnode, -1);
+
+  eq_ctx->node_queues = MEM_calloc_arrayN(totnode, sizeof(EdgeQueueNode), __func__);
+  eq_ctx->node_queues_len = totnode;
+  for (int n = 0; n < totnode; n++) {
+    EdgeQueueNode *node_queue = &eq_ctx->node_queues[n];
+    node_queue->q = *eq_ctx->q;
+    node_queue->q.heap = BLI_heapsimple_new();
+    node_queue->pool = BLI_mempool_create(sizeof(BMVert *) * 2, 0, 128, BLI_MEMPOOL_NOP);
+    node_queue->node_index = (int)(nodes[n] - pbvh->nodes);
+    node_queue_index[node_queue->node_index] = n;
+  }
+
+  for (int n = 0; n < totnode; n++) {
+    EdgeQueueCandidates *candidates = &data.candidates[n];
+    for (int i = 0; i < candidates->len; i++) {
+      BMEdge *e = candidates->data[i].e;
+#ifdef USE_EDGEQUEUE_TAG
+      if (EDGE_QUEUE_TEST(e)) {
+        continue;
+      }
+#endif
+      EdgeQueueContext insert_ctx = *eq_ctx;
+      const int node_index = edge_queue_edge_node_index(eq_ctx, e);
+      if (node_index != DYNTOPO_NODE_NONE && node_queue_index[node_index] != -1) {
+        EdgeQueueNode *node_queue = &eq_ctx->node_queues[node_queue_index[node_index]];
+        insert_ctx.q = &node_queue->q;
+        insert_ctx.pool = node_queue->pool;
+      }
+      edge_queue_insert_unchecked(&insert_ctx, e, candidates->data[i].priority);
+    }
+    MEM_SAFE_FREE(candidates->data);
+  }
+
+  MEM_freeN(node_queue_index);
+  MEM_freeN(data.candidates);
+  MEM_freeN(nodes);
+}
+
 /* Create a priority queue containing vertex pairs connected by a long
  * edge as defined by PBVH.bm_max_edge_len.
  *
@@ -1035,22 +1345,7 @@ static void long_edge_queue_create(EdgeQueueContext *eq_ctx,
   pbvh_bmesh_edge_tag_verify(pbvh);
 #endif
 
-  for (int n = 0; n < pbvh->totnode; n++) {
-    PBVHNode *node = &pbvh->nodes[n];
-
-    /* Check leaf nodes marked for topology update */
-    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateTopology) &&
-        !(node->flag & PBVH_FullyHidden)) {
-      GSetIterator gs_iter;
-
-      /* Check each face */
-      GSET_ITER (gs_iter, node->bm_faces) {
-        BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
-
-        long_edge_queue_face_add(eq_ctx, f);
-      }
-    }
-  }
+  edge_queue_create_from_nodes(eq_ctx, pbvh, long_edge_queue_face_add);
 }
 
 /* Create a priority queue containing vertex pairs connected by a
@@ -1094,22 +1389,7 @@ static void short_edge_queue_create(EdgeQueueContext *eq_ctx,
     eq_ctx->q->edge_queue_tri_in_range = edge_queue_tri_in_sphere;
   }
 
-  for (int n = 0; n < pbvh->totnode; n++) {
-    PBVHNode *node = &pbvh->nodes[n];
-
-    /* Check leaf nodes marked for topology update */
-    if ((node->flag & PBVH_Leaf) && (node->flag & PBVH_UpdateTopology) &&
-        !(node->flag & PBVH_FullyHidden)) {
-      GSetIterator gs_iter;
-
-      /* Check each face */
-      GSET_ITER (gs_iter, node->bm_faces) {
-        BMFace *f = BLI_gsetIterator_getKey(&gs_iter);
-
-        short_edge_queue_face_add(eq_ctx, f);
-      }
-    }
-  }
+  edge_queue_create_from_nodes(eq_ctx, pbvh, short_edge_queue_face_add);
 }
 
 /*************************** Topology update **************************/
@@ -1197,22 +1477,28 @@ static void pbvh_bmesh_split_edge(EdgeQueueContext *eq_ctx,
     v_tri[0] = v1;
     v_tri[1] = v_new;
     v_tri[2] = v_opp;
+    pbvh_bmesh_topology_lock(pbvh);
     bm_edges_from_tri(pbvh->bm, v_tri, e_tri);
+    pbvh_bmesh_topology_unlock(pbvh);
     f_new = pbvh_bmesh_face_create(pbvh, ni, v_tri, e_tri, f_adj);
     long_edge_queue_face_add(eq_ctx, f_new);
 
     v_tri[0] = v_new;
     v_tri[1] = v2;
     /* v_tri[2] = v_opp; */ /* unchanged */
+    pbvh_bmesh_topology_lock(pbvh);
     e_tri[0] = BM_edge_create(pbvh->bm, v_tri[0], v_tri[1], NULL, BM_CREATE_NO_DOUBLE);
     e_tri[2] = e_tri[1]; /* switched */
     e_tri[1] = BM_edge_create(pbvh->bm, v_tri[1], v_tri[2], NULL, BM_CREATE_NO_DOUBLE);
+    pbvh_bmesh_topology_unlock(pbvh);
     f_new = pbvh_bmesh_face_create(pbvh, ni, v_tri, e_tri, f_adj);
     long_edge_queue_face_add(eq_ctx, f_new);
 
     /* Delete original */
     pbvh_bmesh_face_remove(pbvh, f_adj);
+    pbvh_bmesh_topology_lock(pbvh);
     BM_face_kill(pbvh->bm, f_adj);
+    pbvh_bmesh_topology_unlock(pbvh);
 
     /* Ensure new vertex is in the node */
     if (!BLI_gset_haskey(pbvh->nodes[ni].bm_unique_verts, v_new)) {
@@ -1229,7 +1515,9 @@ static void pbvh_bmesh_split_edge(EdgeQueueContext *eq_ctx,
     }
   }
 
+  pbvh_bmesh_topology_lock(pbvh);
   BM_edge_kill(pbvh->bm, e);
+  pbvh_bmesh_topology_unlock(pbvh);
 }
 
 static bool pbvh_bmesh_subdivide_long_edges(EdgeQueueContext *eq_ctx,
@@ -1273,13 +1561,20 @@ static bool pbvh_bmesh_subdivide_long_edges(EdgeQueueContext *eq_ctx,
       continue;
     }
 
+    if (eq_ctx->node_index != DYNTOPO_NODE_NONE && !edge_queue_split_in_node(eq_ctx, e)) {
+      edge_queue_defer(eq_ctx, v1, v2, -len_squared_v3v3(v1->co, v2->co));
+      continue;
+    }
+
     any_subdivided = true;
 
     pbvh_bmesh_split_edge(eq_ctx, pbvh, e, edge_loops);
   }
 
 #ifdef USE_EDGEQUEUE_TAG_VERIFY
-  pbvh_bmesh_edge_tag_verify(pbvh);
+  if (eq_ctx->node_index == DYNTOPO_NODE_NONE) {
+    pbvh_bmesh_edge_tag_verify(pbvh);
+  }
 #endif
 
   return any_subdivided;
@@ -1315,12 +1610,16 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
     BMFace *f_adj = l_adj->f;
 
     pbvh_bmesh_face_remove(pbvh, f_adj);
+    pbvh_bmesh_topology_lock(pbvh);
     BM_face_kill(pbvh->bm, f_adj);
+    pbvh_bmesh_topology_unlock(pbvh);
   }
 
   /* Kill the edge */
   BLI_assert(BM_edge_is_wire(e));
+  pbvh_bmesh_topology_lock(pbvh);
   BM_edge_kill(pbvh->bm, e);
+  pbvh_bmesh_topology_unlock(pbvh);
 
   /* For all remaining faces of v_del, create a new face that is the
    * same except it uses v_conn instead of v_del */
@@ -1367,7 +1666,9 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
       BMEdge *e_tri[3];
       PBVHNode *n = pbvh_bmesh_node_from_face(pbvh, f);
       int ni = n - pbvh->nodes;
+      pbvh_bmesh_topology_lock(pbvh);
       bm_edges_from_tri(pbvh->bm, v_tri, e_tri);
+      pbvh_bmesh_topology_unlock(pbvh);
       pbvh_bmesh_face_create(pbvh, ni, v_tri, e_tri, f);
 
       /* Ensure that v_conn is in the new face's node */
@@ -1400,6 +1701,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
 
     /* Remove the face */
     pbvh_bmesh_face_remove(pbvh, f_del);
+    pbvh_bmesh_topology_lock(pbvh);
     BM_face_kill(pbvh->bm, f_del);
 
     /* Check if any of the face's edges are now unused by any
@@ -1409,6 +1711,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
         BM_edge_kill(pbvh->bm, e_tri[j]);
       }
     }
+    pbvh_bmesh_topology_unlock(pbvh);
 
     /* Check if any of the face's vertices are now unused, if so
      * remove them from the PBVH */
@@ -1416,6 +1719,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
       if ((v_tri[j] != v_del) && (v_tri[j]->e == NULL)) {
         pbvh_bmesh_vert_remove(pbvh, v_tri[j]);
 
+        pbvh_bmesh_topology_lock(pbvh);
         BM_log_vert_removed(pbvh->bm_log, v_tri[j], eq_ctx->cd_vert_mask_offset);
 
         if (v_tri[j] == v_conn) {
@@ -1423,6 +1727,7 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
         }
         BLI_ghash_insert(deleted_verts, v_tri[j], NULL);
         BM_vert_kill(pbvh->bm, v_tri[j]);
+        pbvh_bmesh_topology_unlock(pbvh);
       }
     }
   }
@@ -1430,7 +1735,9 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
   /* Move v_conn to the midpoint of v_conn and v_del (if v_conn still exists, it
    * may have been deleted above) */
   if (v_conn != NULL) {
+    pbvh_bmesh_topology_lock(pbvh);
     BM_log_vert_before_modified(pbvh->bm_log, v_conn, eq_ctx->cd_vert_mask_offset);
+    pbvh_bmesh_topology_unlock(pbvh);
     mid_v3_v3v3(v_conn->co, v_conn->co, v_del->co);
     add_v3_v3(v_conn->no, v_del->no);
     normalize_v3(v_conn->no);
@@ -1446,20 +1753,22 @@ static void pbvh_bmesh_collapse_edge(PBVH *pbvh,
 
   /* Delete v_del */
   BLI_assert(!BM_vert_face_check(v_del));
+  pbvh_bmesh_topology_lock(pbvh);
   BM_log_vert_removed(pbvh->bm_log, v_del, eq_ctx->cd_vert_mask_offset);
   /* v_conn == NULL is OK */
   BLI_ghash_insert(deleted_verts, v_del, v_conn);
   BM_vert_kill(pbvh->bm, v_del);
+  pbvh_bmesh_topology_unlock(pbvh);
 }
 
+/* `deleted_verts` maps deleted verts to vertices they were merged into, or NULL when removed. */
 static bool pbvh_bmesh_collapse_short_edges(EdgeQueueContext *eq_ctx,
                                             PBVH *pbvh,
-                                            BLI_Buffer *deleted_faces)
+                                            BLI_Buffer *deleted_faces,
+                                            GHash *deleted_verts)
 {
   const float min_len_squared = pbvh->bm_min_edge_len * pbvh->bm_min_edge_len;
   bool any_collapsed = false;
-  /* deleted verts point to vertices they were merged into, or NULL when removed. */
-  GHash *deleted_verts = BLI_ghash_ptr_new("deleted_verts");
 
   while (!BLI_heapsimple_is_empty(eq_ctx->q->heap)) {
     BMVert **pair = BLI_heapsimple_pop_min(eq_ctx->q->heap);
@@ -1495,16 +1804,120 @@ static bool pbvh_bmesh_collapse_short_edges(EdgeQueueContext *eq_ctx,
       continue;
     }
 
+    if (eq_ctx->node_index != DYNTOPO_NODE_NONE && !edge_queue_collapse_in_node(eq_ctx, e)) {
+      edge_queue_defer(eq_ctx, v1, v2, len_squared_v3v3(v1->co, v2->co));
+      continue;
+    }
+
     any_collapsed = true;
 
     pbvh_bmesh_collapse_edge(pbvh, e, v1, v2, deleted_verts, deleted_faces, eq_ctx);
   }
 
-  BLI_ghash_free(deleted_verts, NULL, NULL);
-
   return any_collapsed;
 }
 
+typedef struct EdgeQueueNodesData {
+  const EdgeQueueContext *eq_ctx;
+  PBVH *pbvh;
+  bool use_collapse;
+} EdgeQueueNodesData;
+
+static void edge_queue_node_process_cb(void *__restrict userdata,
+                                       const int n,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  EdgeQueueNodesData *data = userdata;
+  EdgeQueueNode *node_queue = &data->eq_ctx->node_queues[n];
+  EdgeQueueContext eq_ctx = *data->eq_ctx;
+  eq_ctx.q = &node_queue->q;
+  eq_ctx.pool = node_queue->pool;
+  eq_ctx.node_index = node_queue->node_index;
+  eq_ctx.deferred = &node_queue->deferred;
+
+  if (data->use_collapse) {
+    BLI_buffer_declare_static(BMFace *, deleted_faces, BLI_BUFFER_NOP, 32);
+    node_queue->deleted_verts = BLI_ghash_ptr_new(__func__);
+    node_queue->modified = pbvh_bmesh_collapse_short_edges(
+        &eq_ctx, data->pbvh, &deleted_faces, node_queue->deleted_verts);
+    BLI_buffer_free(&deleted_faces);
+  }
+  else {
+    BLI_buffer_declare_static(BMLoop *, edge_loops, BLI_BUFFER_NOP, 2);
+    node_queue->modified = pbvh_bmesh_subdivide_long_edges(&eq_ctx, data->pbvh, &edge_loops);
+    BLI_buffer_free(&edge_loops);
+  }
+}
+
+/* Process the queues of the nodes in parallel, then add the edges they deferred to the shared
+ * queue, in the order of the nodes. `deleted_verts` is only passed when collapsing, it is filled
+ * with the vertices deleted by the nodes. */
+static bool edge_queue_nodes_process(EdgeQueueContext *eq_ctx, PBVH *pbvh, GHash *deleted_verts)
+{
+  EdgeQueueNodesData data = {
+      .eq_ctx = eq_ctx,
+      .pbvh = pbvh,
+      .use_collapse = deleted_verts != NULL,
+  };
+
+  TaskParallelSettings settings;
+  BKE_pbvh_parallel_range_settings(&settings, true, eq_ctx->node_queues_len);
+  pbvh->bm_topology_threaded = true;
+  BLI_task_parallel_range(0, eq_ctx->node_queues_len, &data, edge_queue_node_process_cb, &settings);
+  pbvh->bm_topology_threaded = false;
+
+  bool modified = false;
+  for (int n = 0; n < eq_ctx->node_queues_len; n++) {
+    EdgeQueueNode *node_queue = &eq_ctx->node_queues[n];
+    modified |= node_queue->modified;
+
+    if (node_queue->deleted_verts) {
+      GHashIterator gh_iter;
+      GHASH_ITER (gh_iter, node_queue->deleted_verts) {
+        BLI_ghash_insert(deleted_verts,
+                         BLI_ghashIterator_getKey(&gh_iter),
+                         BLI_ghashIterator_getValue(&gh_iter));
+      }
+      BLI_ghash_free(node_queue->deleted_verts, NULL, NULL);
+    }
+  }
+
+  for (int n = 0; n < eq_ctx->node_queues_len; n++) {
+    EdgeQueueNode *node_queue = &eq_ctx->node_queues[n];
+    EdgeQueueDeferred *deferred = &node_queue->deferred;
+
+    for (int i = 0; i < deferred->len; i++) {
+      BMVert *v1 = deferred->data[i].v1, *v2 = deferred->data[i].v2;
+      if (deleted_verts) {
+        if (!(v1 = bm_vert_hash_lookup_chain(deleted_verts, v1)) ||
+            !(v2 = bm_vert_hash_lookup_chain(deleted_verts, v2)) || (v1 == v2)) {
+          continue;
+        }
+      }
+
+      BMEdge *e;
+      if (!(e = BM_edge_exists(v1, v2))) {
+        continue;
+      }
+#ifdef USE_EDGEQUEUE_TAG
+      if (EDGE_QUEUE_TEST(e)) {
+        continue;
+      }
+#endif
+      edge_queue_insert_unchecked(eq_ctx, e, deferred->data[i].priority);
+    }
+
+    MEM_SAFE_FREE(deferred->data);
+    BLI_heapsimple_free(node_queue->q.heap, NULL);
+    BLI_mempool_destroy(node_queue->pool);
+  }
+
+  MEM_SAFE_FREE(eq_ctx->node_queues);
+  eq_ctx->node_queues_len = 0;
+
+  return modified;
+}
+
 /************************* Called from pbvh.c *************************/
 
 bool pbvh_bmesh_node_raycast(PBVHNode *node,
@@ -1979,17 +2392,22 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *pbvh,
     EdgeQueue q;
     BLI_mempool *queue_pool = BLI_mempool_create(sizeof(BMVert *) * 2, 0, 128, BLI_MEMPOOL_NOP);
     EdgeQueueContext eq_ctx = {
-        &q,
-        queue_pool,
-        pbvh->bm,
-        cd_vert_mask_offset,
-        cd_vert_node_offset,
-        cd_face_node_offset,
+        .q = &q,
+        .pool = queue_pool,
+        .bm = pbvh->bm,
+        .cd_vert_mask_offset = cd_vert_mask_offset,
+        .cd_vert_node_offset = cd_vert_node_offset,
+        .cd_face_node_offset = cd_face_node_offset,
+        .node_index = DYNTOPO_NODE_NONE,
     };
+    /* deleted verts point to vertices they were merged into, or NULL when removed. */
+    GHash *deleted_verts = BLI_ghash_ptr_new("deleted_verts");
 
     short_edge_queue_create(
         &eq_ctx, pbvh, center, view_normal, radius, use_frontface, use_projected);
-    modified |= pbvh_bmesh_collapse_short_edges(&eq_ctx, pbvh, &deleted_faces);
+    modified |= edge_queue_nodes_process(&eq_ctx, pbvh, deleted_verts);
+    modified |= pbvh_bmesh_collapse_short_edges(&eq_ctx, pbvh, &deleted_faces, deleted_verts);
+    BLI_ghash_free(deleted_verts, NULL, NULL);
     BLI_heapsimple_free(q.heap, NULL);
     BLI_mempool_destroy(queue_pool);
   }
@@ -1998,16 +2416,18 @@ bool BKE_pbvh_bmesh_update_topology(PBVH *pbvh,
     EdgeQueue q;
     BLI_mempool *queue_pool = BLI_mempool_create(sizeof(BMVert *) * 2, 0, 128, BLI_MEMPOOL_NOP);
     EdgeQueueContext eq_ctx = {
-        &q,
-        queue_pool,
-        pbvh->bm,
-        cd_vert_mask_offset,
-        cd_vert_node_offset,
-        cd_face_node_offset,
+        .q = &q,
+        .pool = queue_pool,
+        .bm = pbvh->bm,
+        .cd_vert_mask_offset = cd_vert_mask_offset,
+        .cd_vert_node_offset = cd_vert_node_offset,
+        .cd_face_node_offset = cd_face_node_offset,
+        .node_index = DYNTOPO_NODE_NONE,
     };
 
     long_edge_queue_create(
         &eq_ctx, pbvh, center, view_normal, radius, use_frontface, use_projected);
+    modified |= edge_queue_nodes_process(&eq_ctx, pbvh, NULL);
     modified |= pbvh_bmesh_subdivide_long_edges(&eq_ctx, pbvh, &edge_loops);
     BLI_heapsimple_free(q.heap, NULL);
     BLI_mempool_destroy(queue_pool);
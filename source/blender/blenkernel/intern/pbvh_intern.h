@@ -150,10 +150,6 @@ struct PBVH {
   int totgrid;
   BLI_bitmap **grid_hidden;
 
-  /* Only used during BVH build and update,
-   * don't need to remain valid after */
-  BLI_bitmap *vert_bitmap;
-
 #ifdef PERFCNTRS
   int perf_modified;
 #endif
@@ -175,6 +171,9 @@ struct PBVH {
   int num_planes;
 
   struct BMLog *bm_log;
+  /* Set while dyntopo changes the topology of nodes in parallel, BMesh element allocation and
+   * #BMLog changes are locked then. */
+  bool bm_topology_threaded;
   struct SubdivCCG *subdiv_ccg;
 };
 
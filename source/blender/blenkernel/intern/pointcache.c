@@ -45,14 +45,18 @@
 
 #include "BLI_blenlib.h"
 #include "BLI_endian_switch.h"
+#include "BLI_ghash.h"
 #include "BLI_math.h"
+#include "BLI_mmap.h"
 #include "BLI_string.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BLT_translation.h"
 
 #include "PIL_time.h"
 
+#include "BKE_anim_data.h"
 #include "BKE_appdir.h"
 #include "BKE_cloth.h"
 #include "BKE_collection.h"
@@ -72,9 +76,9 @@
 
 #include "BIK_api.h"
 
-#ifdef WITH_BULLET
-#  include "RBI_api.h"
-#endif
+#include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
+#include "DEG_depsgraph_query.h"
 
 #ifdef WITH_LZO
 #  ifdef WITH_SYSTEM_LZO
@@ -95,8 +99,14 @@
 /* needed for directory lookup */
 #ifndef WIN32
 #  include <dirent.h>
+#  include <unistd.h>
 #else
 #  include "BLI_winstuff.h"
+#  include <io.h>
+#endif
+
+#ifdef __linux__
+#  include <fcntl.h> /* for posix_fadvise */
 #endif
 
 #define PTCACHE_DATA_FROM(data, type, from) \
@@ -118,6 +128,12 @@
 
 static CLG_LogRef LOG = {"bke.pointcache"};
 
+/* Number of cached frames after the one being read, to hint the OS to read ahead. */
+#define PTCACHE_READ_AHEAD_FRAMES 2
+
+/* Opening and freeing memory mapped files isn't thread-safe. */
+static ThreadMutex ptcache_mmap_lock = BLI_MUTEX_INITIALIZER;
+
 static int ptcache_data_size[] = {
     sizeof(unsigned int), /* BPHYS_DATA_INDEX */
     sizeof(float[3]),     /* BPHYS_DATA_LOCATION */
@@ -136,9 +152,16 @@ static int ptcache_extra_datasize[] = {
 };
 
 /* forward declarations */
-static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result, unsigned int len);
-static int ptcache_file_compressed_write(
-    PTCacheFile *pf, unsigned char *in, unsigned int in_len, unsigned char *out, int mode);
+static int ptcache_file_compressed_read(PTCacheFile *pf,
+                                        unsigned char *result,
+                                        unsigned int len,
+                                        unsigned int stride);
+static int ptcache_file_compressed_write(PTCacheFile *pf,
+                                         unsigned char *in,
+                                         unsigned int in_len,
+                                         unsigned int stride,
+                                         unsigned char *out,
+                                         int mode);
 static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot, unsigned int size);
 static int ptcache_file_read(PTCacheFile *pf, void *f, unsigned int tot, unsigned int size);
 
@@ -148,11 +171,11 @@ static int ptcache_basic_header_read(PTCacheFile *pf)
   int error = 0;
 
   /* Custom functions should read these basic elements too! */
-  if (!error && !fread(&pf->totpoint, sizeof(unsigned int), 1, pf->fp)) {
+  if (!error && !ptcache_file_read(pf, &pf->totpoint, 1, sizeof(unsigned int))) {
     error = 1;
   }
 
-  if (!error && !fread(&pf->data_types, sizeof(unsigned int), 1, pf->fp)) {
+  if (!error && !ptcache_file_read(pf, &pf->data_types, 1, sizeof(unsigned int))) {
     error = 1;
   }
 
@@ -689,30 +712,31 @@ static int ptcache_dynamicpaint_write(PTCacheFile *pf, void *dp_v)
 
   if (surface->format != MOD_DPAINT_SURFACE_F_IMAGESEQ && surface->data) {
     int total_points = surface->data->total_points;
-    unsigned int in_len;
+    unsigned int elem_size, in_len;
     unsigned char *out;
 
     /* cache type */
     ptcache_file_write(pf, &surface->type, 1, sizeof(int));
 
     if (surface->type == MOD_DPAINT_SURFACE_T_PAINT) {
-      in_len = sizeof(PaintPoint) * total_points;
+      elem_size = sizeof(PaintPoint);
     }
     else if (surface->type == MOD_DPAINT_SURFACE_T_DISPLACE ||
              surface->type == MOD_DPAINT_SURFACE_T_WEIGHT) {
-      in_len = sizeof(float) * total_points;
+      elem_size = sizeof(float);
     }
     else if (surface->type == MOD_DPAINT_SURFACE_T_WAVE) {
-      in_len = sizeof(PaintWavePoint) * total_points;
+      elem_size = sizeof(PaintWavePoint);
     }
     else {
       return 0;
     }
+    in_len = elem_size * total_points;
 
     out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len), "pointcache_lzo_buffer");
 
     ptcache_file_compressed_write(
-        pf, (unsigned char *)surface->data->type_data, in_len, out, cache_compress);
+        pf, (unsigned char *)surface->data->type_data, in_len, elem_size, out, cache_compress);
     MEM_freeN(out);
   }
   return 1;
@@ -754,8 +778,10 @@ static int ptcache_dynamicpaint_read(PTCacheFile *pf, void *dp_v)
       return 0;
     }
 
-    ptcache_file_compressed_read(
-        pf, (unsigned char *)surface->data->type_data, data_len * surface->data->total_points);
+    ptcache_file_compressed_read(pf,
+                                 (unsigned char *)surface->data->type_data,
+                                 data_len * surface->data->total_points,
+                                 data_len);
   }
   return 1;
 }
@@ -774,10 +800,8 @@ static int ptcache_rigidbody_write(int index, void *rb_v, void **data, int UNUSE
     RigidBodyOb *rbo = ob->rigidbody_object;
 
     if (rbo->type == RBO_TYPE_ACTIVE && rbo->shared->physics_object != NULL) {
-#ifdef WITH_BULLET
-      RB_body_get_position(rbo->shared->physics_object, rbo->pos);
-      RB_body_get_orientation(rbo->shared->physics_object, rbo->orn);
-#endif
+      /* The simulated transforms are read in bulk before writing the cache, see
+       * #BKE_rigidbody_do_simulation. */
       PTCACHE_DATA_FROM(data, BPHYS_DATA_LOCATION, rbo->pos);
       PTCACHE_DATA_FROM(data, BPHYS_DATA_ROTATION, rbo->orn);
     }
@@ -1466,6 +1490,8 @@ static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
 {
   PTCacheFile *pf;
   FILE *fp = NULL;
+  BLI_mmap_file *mmap_file = NULL;
+  size_t mmap_size = 0;
   char filename[MAX_PTCACHE_FILE];
 
 #ifndef DURIAN_POINTCACHE_LIB_OK
@@ -1481,7 +1507,23 @@ static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
   ptcache_filename(pid, filename, cfra, 1, 1);
 
   if (mode == PTCACHE_FILE_READ) {
-    fp = BLI_fopen(filename, "rb");
+    /* Map the file, so reading the points doesn't go through the C library and system calls. */
+    const int fd = BLI_open(filename, O_BINARY | O_RDONLY, 0);
+    if (fd == -1) {
+      return NULL;
+    }
+    mmap_size = BLI_file_descriptor_size(fd);
+    if (mmap_size > 0 && mmap_size != (size_t)-1) {
+      BLI_mutex_lock(&ptcache_mmap_lock);
+      mmap_file = BLI_mmap_open(fd);
+      BLI_mutex_unlock(&ptcache_mmap_lock);
+    }
+    /* The mapping stays valid after closing. */
+    close(fd);
+
+    if (mmap_file == NULL) {
+      fp = BLI_fopen(filename, "rb");
+    }
   }
   else if (mode == PTCACHE_FILE_WRITE) {
     /* Will create the dir if needs be, same as "//textures" is created. */
@@ -1494,12 +1536,15 @@ static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
     fp = BLI_fopen(filename, "rb+");
   }
 
-  if (!fp) {
+  if (!fp && !mmap_file) {
     return NULL;
   }
 
   pf = MEM_mallocN(sizeof(PTCacheFile), "PTCacheFile");
   pf->fp = fp;
+  pf->mmap_file = mmap_file;
+  pf->mmap_size = mmap_file ? mmap_size : 0;
+  pf->mmap_offset = 0;
   pf->old_format = 0;
   pf->frame = cfra;
 
@@ -1508,12 +1553,116 @@ static PTCacheFile *ptcache_file_open(PTCacheID *pid, int mode, int cfra)
 static void ptcache_file_close(PTCacheFile *pf)
 {
   if (pf) {
-    fclose(pf->fp);
+    if (pf->mmap_file) {
+      BLI_mutex_lock(&ptcache_mmap_lock);
+      BLI_mmap_free(pf->mmap_file);
+      BLI_mutex_unlock(&ptcache_mmap_lock);
+    }
+    else {
+      fclose(pf->fp);
+    }
     MEM_freeN(pf);
   }
 }
 
-static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result, unsigned int len)
+/**
+ * Hint the OS to read the files of the next cached frames in the background, so playback
+ * finds them in the page cache. No data is kept here, so nothing goes stale when the cache
+ * changes.
+ */
+static void ptcache_file_read_ahead(PTCacheID *pid, int cfra)
+{
+#ifdef __linux__
+  char filename[MAX_PTCACHE_FILE];
+
+  if (!G.relbase_valid && (pid->cache->flag & PTCACHE_EXTERNAL) == 0) {
+    return;
+  }
+
+  for (int i = 1; i <= PTCACHE_READ_AHEAD_FRAMES; i++) {
+    const int frame = cfra + i * max_ii(pid->cache->step, 1);
+    if (frame > pid->cache->endframe) {
+      break;
+    }
+
+    ptcache_filename(pid, filename, frame, 1, 1);
+
+    const int fd = BLI_open(filename, O_BINARY | O_RDONLY, 0);
+    if (fd != -1) {
+      posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+      close(fd);
+    }
+  }
+#else
+  UNUSED_VARS(pid, cfra);
+#endif
+}
+
+/**
+ * Delta encoding of #PTCACHE_COMPRESS_DELTA. Every byte is XOR'ed with the same byte of the
+ * previous element, then bytes are grouped by their position in 4 byte words. Coordinates of
+ * neighboring points are close, so the sign, exponent and high mantissa bytes mostly become
+ * long runs of zeros, which the compressor packs well.
+ */
+void BKE_ptcache_delta_encode(const unsigned char *in,
+                              unsigned char *out,
+                              size_t len,
+                              size_t stride)
+{
+  const size_t width = (len % 4 == 0) ? 4 : 1;
+  const size_t plane_len = len / width;
+
+  for (size_t i = 0; i < len; i++) {
+    const unsigned char value = (stride && i >= stride) ? in[i] ^ in[i - stride] : in[i];
+    out[(i % width) * plane_len + i / width] = value;
+  }
+}
+
+void BKE_ptcache_delta_decode(const unsigned char *in,
+                              unsigned char *out,
+                              size_t len,
+                              size_t stride)
+{
+  const size_t width = (len % 4 == 0) ? 4 : 1;
+  const size_t plane_len = len / width;
+
+  for (size_t i = 0; i < len; i++) {
+    out[i] = in[(i % width) * plane_len + i / width];
+    if (stride && i >= stride) {
+      out[i] ^= out[i - stride];
+    }
+  }
+}
+
+/**
+ * Pointer to the next `len` bytes of a memory mapped file, to read compressed data without
+ * copying it first. NULL when the file isn't mapped.
+ *
+ * \note IO errors while accessing the returned memory are only caught by the SIGBUS handler of
+ * #BLI_mmap_open, so check #BLI_mmap_any_io_error after using it. On Windows such errors raise
+ * exceptions that are only handled inside #BLI_mmap_read, so data is always copied there.
+ */
+static const unsigned char *ptcache_file_mapped_read(PTCacheFile *pf, size_t len)
+{
+#ifdef WIN32
+  UNUSED_VARS(pf, len);
+  return NULL;
+#else
+  if (pf->mmap_file == NULL || pf->mmap_offset + len > pf->mmap_size) {
+    return NULL;
+  }
+
+  const unsigned char *data = (const unsigned char *)BLI_mmap_get_pointer(pf->mmap_file) +
+                              pf->mmap_offset;
+  pf->mmap_offset += len;
+  return data;
+#endif
+}
+
+static int ptcache_file_compressed_read(PTCacheFile *pf,
+                                        unsigned char *result,
+                                        unsigned int len,
+                                        unsigned int stride)
 {
   int r = 0;
   unsigned char compressed = 0;
@@ -1521,9 +1670,10 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result,
 #ifdef WITH_LZO
   size_t out_len = len;
 #endif
-  unsigned char *in;
   unsigned char *props = MEM_callocN(sizeof(char[16]), "tmp");
 
+  (void)stride; /* unused when building w/o compression */
+
   ptcache_file_read(pf, &compressed, 1, sizeof(unsigned char));
   if (compressed) {
     unsigned int size;
@@ -1533,13 +1683,24 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result,
       /* do nothing */
     }
     else {
-      in = (unsigned char *)MEM_callocN(sizeof(unsigned char) * in_len,
-                                        "pointcache_compressed_buffer");
-      ptcache_file_read(pf, in, in_len, sizeof(unsigned char));
+      unsigned char *in_buffer = NULL;
+      const unsigned char *in = ptcache_file_mapped_read(pf, in_len);
+      if (in == NULL) {
+        in_buffer = (unsigned char *)MEM_callocN(sizeof(unsigned char) * in_len,
+                                                 "pointcache_compressed_buffer");
+        ptcache_file_read(pf, in_buffer, in_len, sizeof(unsigned char));
+        in = in_buffer;
+      }
 #ifdef WITH_LZO
       if (compressed == 1) {
         r = lzo1x_decompress_safe(in, (lzo_uint)in_len, result, (lzo_uint *)&out_len, NULL);
       }
+      else if (compressed == 3) {
+        unsigned char *delta = MEM_mallocN(len, "pointcache_delta_buffer");
+        r = lzo1x_decompress_safe(in, (lzo_uint)in_len, delta, (lzo_uint *)&out_len, NULL);
+        BKE_ptcache_delta_decode(delta, result, len, stride);
+        MEM_freeN(delta);
+      }
 #endif
 #ifdef WITH_LZMA
       if (compressed == 2) {
@@ -1551,7 +1712,12 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result,
         r = LzmaUncompress(result, &leno, in, &leni, props, sizeOfIt);
       }
 #endif
-      MEM_freeN(in);
+      /* Decompressed from mapped memory that failed to read, which is zeroes by now. */
+      if (in_buffer == NULL && BLI_mmap_any_io_error(pf->mmap_file)) {
+        memset(result, 0, len);
+        r = -1;
+      }
+      MEM_SAFE_FREE(in_buffer);
     }
   }
   else {
@@ -1562,8 +1728,12 @@ static int ptcache_file_compressed_read(PTCacheFile *pf, unsigned char *result,
 
   return r;
 }
-static int ptcache_file_compressed_write(
-    PTCacheFile *pf, unsigned char *in, unsigned int in_len, unsigned char *out, int mode)
+static int ptcache_file_compressed_write(PTCacheFile *pf,
+                                         unsigned char *in,
+                                         unsigned int in_len,
+                                         unsigned int stride,
+                                         unsigned char *out,
+                                         int mode)
 {
   int r = 0;
   unsigned char compressed = 0;
@@ -1572,23 +1742,32 @@ static int ptcache_file_compressed_write(
   size_t sizeOfIt = 5;
 
   (void)mode; /* unused when building w/o compression */
+  (void)stride;
 
 #ifdef WITH_LZO
   out_len = LZO_OUT_LEN(in_len);
-  if (mode == 1) {
+  if (ELEM(mode, PTCACHE_COMPRESS_LZO, PTCACHE_COMPRESS_DELTA)) {
     LZO_HEAP_ALLOC(wrkmem, LZO1X_MEM_COMPRESS);
 
-    r = lzo1x_1_compress(in, (lzo_uint)in_len, out, (lzo_uint *)&out_len, wrkmem);
+    if (mode == PTCACHE_COMPRESS_DELTA) {
+      unsigned char *delta = MEM_mallocN(in_len, "pointcache_delta_buffer");
+      BKE_ptcache_delta_encode(in, delta, in_len, stride);
+      r = lzo1x_1_compress(delta, (lzo_uint)in_len, out, (lzo_uint *)&out_len, wrkmem);
+      MEM_freeN(delta);
+    }
+    else {
+      r = lzo1x_1_compress(in, (lzo_uint)in_len, out, (lzo_uint *)&out_len, wrkmem);
+    }
     if (!(r == LZO_E_OK) || (out_len >= in_len)) {
       compressed = 0;
     }
     else {
-      compressed = 1;
+      compressed = (mode == PTCACHE_COMPRESS_DELTA) ? 3 : 1;
     }
   }
 #endif
 #ifdef WITH_LZMA
-  if (mode == 2) {
+  if (mode == PTCACHE_COMPRESS_LZMA) {
 
     r = LzmaCompress(out,
                      &out_len,
@@ -1635,6 +1814,14 @@ static int ptcache_file_compressed_write(
 }
 static int ptcache_file_read(PTCacheFile *pf, void *f, unsigned int tot, unsigned int size)
 {
+  if (pf->mmap_file) {
+    const size_t len = (size_t)tot * size;
+    if (!BLI_mmap_read(pf->mmap_file, f, pf->mmap_offset, len)) {
+      return 0;
+    }
+    pf->mmap_offset += len;
+    return 1;
+  }
   return (fread(f, size, tot, pf->fp) == tot);
 }
 static int ptcache_file_write(PTCacheFile *pf, const void *f, unsigned int tot, unsigned int size)
@@ -1675,7 +1862,7 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
 
   pf->data_types = 0;
 
-  if (fread(bphysics, sizeof(char), 8, pf->fp) != 8) {
+  if (!ptcache_file_read(pf, bphysics, 8, sizeof(char))) {
     error = 1;
   }
 
@@ -1683,7 +1870,7 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
     error = 1;
   }
 
-  if (!error && !fread(&typeflag, sizeof(unsigned int), 1, pf->fp)) {
+  if (!error && !ptcache_file_read(pf, &typeflag, 1, sizeof(unsigned int))) {
     error = 1;
   }
 
@@ -1692,7 +1879,12 @@ static int ptcache_file_header_begin_read(PTCacheFile *pf)
 
   /* if there was an error set file as it was */
   if (error) {
-    BLI_fseek(pf->fp, 0, SEEK_SET);
+    if (pf->mmap_file) {
+      pf->mmap_offset = 0;
+    }
+    else {
+      BLI_fseek(pf->fp, 0, SEEK_SET);
+    }
   }
 
   return !error;
@@ -1970,7 +2162,11 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
       for (i = 0; i < BPHYS_TOT_DATA; i++) {
         unsigned int out_len = pm->totpoint * ptcache_data_size[i];
         if (pf->data_types & (1 << i)) {
-          ptcache_file_compressed_read(pf, (unsigned char *)(pm->data[i]), out_len);
+          if (ptcache_file_compressed_read(
+                  pf, (unsigned char *)(pm->data[i]), out_len, ptcache_data_size[i]) != 0) {
+            error = 1;
+            break;
+          }
         }
       }
     }
@@ -2006,7 +2202,8 @@ static PTCacheMem *ptcache_disk_frame_to_mem(PTCacheID *pid, int cfra)
       if (pf->flag & PTCACHE_TYPEFLAG_COMPRESS) {
         ptcache_file_compressed_read(pf,
                                      (unsigned char *)(extra->data),
-                                     extra->totdata * ptcache_extra_datasize[extra->type]);
+                                     extra->totdata * ptcache_extra_datasize[extra->type],
+                                     ptcache_extra_datasize[extra->type]);
       }
       else {
         ptcache_file_read(pf, extra->data, extra->totdata, ptcache_extra_datasize[extra->type]);
@@ -2070,8 +2267,12 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
           unsigned int in_len = pm->totpoint * ptcache_data_size[i];
           unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
                                                             "pointcache_lzo_buffer");
-          ptcache_file_compressed_write(
-              pf, (unsigned char *)(pm->data[i]), in_len, out, pid->cache->compression);
+          ptcache_file_compressed_write(pf,
+                                        (unsigned char *)(pm->data[i]),
+                                        in_len,
+                                        ptcache_data_size[i],
+                                        out,
+                                        pid->cache->compression);
           MEM_freeN(out);
         }
       }
@@ -2107,8 +2308,12 @@ static int ptcache_mem_frame_to_disk(PTCacheID *pid, PTCacheMem *pm)
         unsigned int in_len = extra->totdata * ptcache_extra_datasize[extra->type];
         unsigned char *out = (unsigned char *)MEM_callocN(LZO_OUT_LEN(in_len) * 4,
                                                           "pointcache_lzo_buffer");
-        ptcache_file_compressed_write(
-            pf, (unsigned char *)(extra->data), in_len, out, pid->cache->compression);
+        ptcache_file_compressed_write(pf,
+                                      (unsigned char *)(extra->data),
+                                      in_len,
+                                      ptcache_extra_datasize[extra->type],
+                                      out,
+                                      pid->cache->compression);
         MEM_freeN(out);
       }
       else {
@@ -2171,6 +2376,10 @@ static int ptcache_read_stream(PTCacheID *pid, int cfra)
 
   ptcache_file_close(pf);
 
+  if ((pid->cache->flag & PTCACHE_BAKING) == 0) {
+    ptcache_file_read_ahead(pid, cfra);
+  }
+
   return error == 0;
 }
 
@@ -2183,6 +2392,10 @@ static int ptcache_read(PTCacheID *pid, int cfra)
   /* get a memory cache to read from */
   if (pid->cache->flag & PTCACHE_DISK_CACHE) {
     pm = ptcache_disk_frame_to_mem(pid, cfra);
+
+    if ((pid->cache->flag & PTCACHE_BAKING) == 0) {
+      ptcache_file_read_ahead(pid, cfra);
+    }
   }
   else {
     pm = pid->cache->mem_cache.first;
@@ -2240,6 +2453,10 @@ static int ptcache_interpolate(PTCacheID *pid, float cfra, int cfra1, int cfra2)
   /* get a memory cache to read from */
   if (pid->cache->flag & PTCACHE_DISK_CACHE) {
     pm = ptcache_disk_frame_to_mem(pid, cfra2);
+
+    if ((pid->cache->flag & PTCACHE_BAKING) == 0) {
+      ptcache_file_read_ahead(pid, cfra2);
+    }
   }
   else {
     pm = pid->cache->mem_cache.first;
@@ -3202,6 +3419,494 @@ static void ptcache_dt_to_str(char *str, double dtime)
   }
 }
 
+/* Clear the baking flag of all caches in the scene. */
+static void ptcache_bake_all_finish(PTCacheBaker *baker)
+{
+  Scene *scene = baker->scene;
+  Scene *sce_iter; /* SETLOOPER macro only */
+  Base *base;
+  ListBase pidlist;
+
+  for (SETLOOPER_VIEW_LAYER(scene, baker->view_layer, sce_iter, base)) {
+    BKE_ptcache_ids_from_object(&pidlist, base->object, scene, MAX_DUPLI_RECUR);
+
+    LISTBASE_FOREACH (PTCacheID *, pid, &pidlist) {
+      /* skip hair particles */
+      if (pid->type == PTCACHE_TYPE_PARTICLES &&
+          ((ParticleSystem *)pid->calldata)->part->type == PART_HAIR) {
+        continue;
+      }
+
+      PointCache *cache = pid->cache;
+
+      if (baker->quick_step > 1) {
+        cache->flag &= ~(PTCACHE_BAKING | PTCACHE_OUTDATED);
+      }
+      else {
+        cache->flag &= ~(PTCACHE_BAKING | PTCACHE_REDO_NEEDED);
+      }
+
+      cache->flag |= PTCACHE_SIMULATION_VALID;
+
+      if (baker->bake) {
+        cache->flag |= PTCACHE_BAKED;
+        if (cache->flag & PTCACHE_DISK_CACHE) {
+          BKE_ptcache_write(pid, 0);
+        }
+      }
+    }
+    BLI_freelistN(&pidlist);
+  }
+}
+
+/* Concurrent baking: when baking all caches, the caches are split in groups of objects that don't
+ * depend on each other. Every group is baked on its own depsgraph and thread, sweeping only its
+ * own frame range, so independent simulations don't wait for each other.
+ *
+ * The depsgraphs of the groups are active, so evaluated data is copied back to the original IDs.
+ * That's only safe when no ID is evaluated in more than one group at a time: groups never share
+ * an ID, except for the IDs every depsgraph of the view layer has (the scene, its camera, world and
+ * so on). Those are only allowed when they don't change over time, and are evaluated once for the
+ * first frame of every group, before the threads start. */
+
+typedef struct PTCacheBakeGroup {
+  /* Owners of the caches, the depsgraph of the group is built from them. */
+  ID **ids;
+  int ids_num;
+  /* #PTCacheID's of the caches baked by the group. */
+  ListBase pids;
+  struct Depsgraph *depsgraph;
+  int startframe, endframe;
+  int frames_done;
+  double time;
+} PTCacheBakeGroup;
+
+typedef struct PTCacheBakeScheduler {
+  PTCacheBaker *baker;
+  PTCacheBakeGroup *groups;
+  int groups_num;
+
+  /* Everything below is guarded by the mutex. */
+  ThreadMutex mutex;
+  int group_next;
+  int frames_done, frames_total;
+  int cancel;
+} PTCacheBakeScheduler;
+
+typedef struct PTCacheBakeAncestorData {
+  /* IDs which are in every depsgraph of the view layer. */
+  GSet *common_ids;
+  /* Index of the first owner an ID was found to be evaluated for. */
+  GHash *id_owner;
+  int *owner_parent;
+  int index;
+  /* A common ID changes while baking. */
+  bool common_id_changes;
+} PTCacheBakeAncestorData;
+
+static bool ptcache_bake_concurrent_supported(const PTCacheID *pid)
+{
+  switch (pid->type) {
+    case PTCACHE_TYPE_SOFTBODY:
+    case PTCACHE_TYPE_PARTICLES:
+    case PTCACHE_TYPE_CLOTH:
+    case PTCACHE_TYPE_DYNAMICPAINT:
+      return true;
+  }
+  return false;
+}
+
+static const char *ptcache_bake_type_name(const PTCacheID *pid)
+{
+  if (pid->cache->name[0]) {
+    return pid->cache->name;
+  }
+  switch (pid->type) {
+    case PTCACHE_TYPE_SOFTBODY:
+      return "Soft Body";
+    case PTCACHE_TYPE_PARTICLES:
+      return "Particles";
+    case PTCACHE_TYPE_CLOTH:
+      return "Cloth";
+    case PTCACHE_TYPE_DYNAMICPAINT:
+      return "Dynamic Paint";
+  }
+  return "Cache";
+}
+
+static int ptcache_bake_owner_find(int *owner_parent, int index)
+{
+  while (owner_parent[index] != index) {
+    owner_parent[index] = owner_parent[owner_parent[index]];
+    index = owner_parent[index];
+  }
+  return index;
+}
+
+static void ptcache_bake_owner_ancestor_cb(ID *id, void *user_data)
+{
+  PTCacheBakeAncestorData *data = user_data;
+  void **index_p;
+
+  if (BLI_gset_haskey(data->common_ids, id)) {
+    return;
+  }
+  if (!BLI_ghash_ensure_p(data->id_owner, id, &index_p)) {
+    *index_p = POINTER_FROM_INT(data->index);
+    return;
+  }
+
+  const int root_a = ptcache_bake_owner_find(data->owner_parent, data->index);
+  const int root_b = ptcache_bake_owner_find(data->owner_parent, POINTER_AS_INT(*index_p));
+  data->owner_parent[MAX2(root_a, root_b)] = MIN2(root_a, root_b);
+}
+
+static void ptcache_bake_owner_dependent_cb(ID *id, void *user_data)
+{
+  PTCacheBakeAncestorData *data = user_data;
+  if (BLI_gset_haskey(data->common_ids, id)) {
+    data->common_id_changes = true;
+  }
+}
+
+static void ptcache_bake_common_id_cb(ID *id, void *user_data)
+{
+  PTCacheBakeAncestorData *data = user_data;
+  BLI_gset_add(data->common_ids, id);
+
+  if (BKE_animdata_id_is_animated(id)) {
+    data->common_id_changes = true;
+  }
+  else if (GS(id->name) == ID_OB) {
+    /* Modifiers include simulations and particle systems. */
+    const Object *ob = (const Object *)id;
+    if (BKE_object_moves_in_time(ob, true) || !BLI_listbase_is_empty(&ob->modifiers)) {
+      data->common_id_changes = true;
+    }
+  }
+  else if (GS(id->name) == ID_SCE && ((const Scene *)id)->rigidbody_world) {
+    data->common_id_changes = true;
+  }
+}
+
+/* Collect the caches to bake. Returns false when a cache can't be baked concurrently, the
+ * caches collected so far are in `r_pids` then too. */
+static bool ptcache_bake_concurrent_collect(PTCacheBaker *baker, ListBase *r_pids)
+{
+  Scene *scene = baker->scene;
+  Scene *sce_iter; /* SETLOOPER macro only */
+  Base *base;
+  ListBase pidlist;
+
+  BLI_listbase_clear(r_pids);
+
+  for (SETLOOPER_VIEW_LAYER(scene, baker->view_layer, sce_iter, base)) {
+    BKE_ptcache_ids_from_object(&pidlist, base->object, scene, MAX_DUPLI_RECUR);
+
+    PTCacheID *pid_next;
+    for (PTCacheID *pid = pidlist.first; pid; pid = pid_next) {
+      pid_next = pid->next;
+
+      if (pid->cache->flag & PTCACHE_BAKED) {
+        continue;
+      }
+      if (pid->type == PTCACHE_TYPE_PARTICLES) {
+        ParticleSystem *psys = (ParticleSystem *)pid->calldata;
+        /* skip hair & keyed particles */
+        if (psys->part->type == PART_HAIR || psys->part->phystype == PART_PHYS_KEYED) {
+          continue;
+        }
+      }
+      /* Caches of instanced objects are evaluated through their instancer. */
+      if (!ptcache_bake_concurrent_supported(pid) || pid->owner_id != &base->object->id) {
+        BLI_freelistN(&pidlist);
+        return false;
+      }
+
+      BLI_remlink(&pidlist, pid);
+      BLI_addtail(r_pids, pid);
+    }
+    BLI_freelistN(&pidlist);
+  }
+
+  return true;
+}
+
+/* Split the caches in groups of owners that depend on each other or on the same IDs, through
+ * colliders, effectors or any other relation. Returns the number of groups, 0 when the caches
+ * can't be baked concurrently. */
+static int ptcache_bake_concurrent_group(PTCacheBaker *baker,
+                                         ListBase *pids,
+                                         PTCacheBakeGroup **r_groups)
+{
+  GHash *owner_index = BLI_ghash_ptr_new(__func__);
+  ID **owners = MEM_malloc_arrayN(BLI_listbase_count(pids), sizeof(ID *), __func__);
+  int owners_num = 0;
+
+  LISTBASE_FOREACH (PTCacheID *, pid, pids) {
+    void **index_p;
+    if (!BLI_ghash_ensure_p(owner_index, pid->owner_id, &index_p)) {
+      *index_p = POINTER_FROM_INT(owners_num);
+      owners[owners_num++] = pid->owner_id;
+    }
+  }
+
+  int *owner_parent = MEM_malloc_arrayN(owners_num, sizeof(int), __func__);
+  for (int i = 0; i < owners_num; i++) {
+    owner_parent[i] = i;
+  }
+
+  PTCacheBakeAncestorData data = {
+      .common_ids = BLI_gset_ptr_new(__func__),
+      .id_owner = BLI_ghash_ptr_new(__func__),
+      .owner_parent = owner_parent,
+  };
+
+  /* IDs in the depsgraph of the view layer without any owner. */
+  struct Depsgraph *depsgraph = DEG_graph_new(
+      baker->bmain, baker->scene, baker->view_layer, DAG_EVAL_VIEWPORT);
+  DEG_graph_build_from_ids(depsgraph, NULL, 0);
+  DEG_foreach_ID(depsgraph, ptcache_bake_common_id_cb, &data);
+  DEG_graph_free(depsgraph);
+
+  /* Owners that are ancestors of each other in one depsgraph, or share an ancestor (an evaluated
+   * collider, a baked cache, a mesh), end up in the same group. */
+  depsgraph = DEG_graph_new(baker->bmain, baker->scene, baker->view_layer, DAG_EVAL_VIEWPORT);
+  DEG_graph_build_from_ids(depsgraph, owners, owners_num);
+  for (data.index = 0; data.index < owners_num && !data.common_id_changes; data.index++) {
+    /* Owners in every depsgraph, or common IDs that depend on an owner, change while baking. */
+    ptcache_bake_owner_dependent_cb(owners[data.index], &data);
+    ptcache_bake_owner_ancestor_cb(owners[data.index], &data);
+    DEG_foreach_ancestor_ID(depsgraph, owners[data.index], ptcache_bake_owner_ancestor_cb, &data);
+    DEG_foreach_dependent_ID(
+        depsgraph, owners[data.index], ptcache_bake_owner_dependent_cb, &data);
+  }
+  DEG_graph_free(depsgraph);
+
+  BLI_gset_free(data.common_ids, NULL);
+  BLI_ghash_free(data.id_owner, NULL, NULL);
+
+  if (data.common_id_changes) {
+    MEM_freeN(owner_parent);
+    MEM_freeN(owners);
+    BLI_ghash_free(owner_index, NULL, NULL);
+    *r_groups = NULL;
+    return 0;
+  }
+
+  /* Owners of a group are contiguous in `owners`, ordered by group. */
+  int *owner_group = MEM_malloc_arrayN(owners_num, sizeof(int), __func__);
+  int groups_num = 0;
+  for (int i = 0; i < owners_num; i++) {
+    const int root = ptcache_bake_owner_find(owner_parent, i);
+    owner_group[i] = (root == i) ? groups_num++ : owner_group[root];
+  }
+
+  PTCacheBakeGroup *groups = MEM_calloc_arrayN(groups_num, sizeof(*groups), __func__);
+  ID **group_ids = MEM_malloc_arrayN(owners_num, sizeof(ID *), __func__);
+  for (int i = 0; i < owners_num; i++) {
+    groups[owner_group[i]].ids_num++;
+  }
+  for (int i = 0, offset = 0; i < groups_num; i++) {
+    groups[i].ids = group_ids + offset;
+    offset += groups[i].ids_num;
+    groups[i].ids_num = 0;
+    groups[i].startframe = MAXFRAME;
+    groups[i].endframe = MINAFRAME;
+  }
+  for (int i = 0; i < owners_num; i++) {
+    PTCacheBakeGroup *group = &groups[owner_group[i]];
+    group->ids[group->ids_num++] = owners[i];
+  }
+
+  PTCacheID *pid_next;
+  for (PTCacheID *pid = pids->first; pid; pid = pid_next) {
+    pid_next = pid->next;
+    const int index = POINTER_AS_INT(BLI_ghash_lookup(owner_index, pid->owner_id));
+    BLI_remlink(pids, pid);
+    BLI_addtail(&groups[owner_group[index]].pids, pid);
+  }
+
+  MEM_freeN(owner_group);
+  MEM_freeN(owner_parent);
+  MEM_freeN(owners);
+  BLI_ghash_free(owner_index, NULL, NULL);
+
+  *r_groups = groups;
+  return groups_num;
+}
+
+static void *ptcache_bake_concurrent_thread(void *data)
+{
+  PTCacheBakeScheduler *scheduler = data;
+  PTCacheBaker *baker = scheduler->baker;
+
+  while (true) {
+    PTCacheBakeGroup *group = NULL;
+
+    BLI_mutex_lock(&scheduler->mutex);
+    if (!scheduler->cancel && scheduler->group_next < scheduler->groups_num) {
+      group = &scheduler->groups[scheduler->group_next++];
+    }
+    BLI_mutex_unlock(&scheduler->mutex);
+
+    if (group == NULL) {
+      break;
+    }
+
+    const double stime = PIL_check_seconds_timer();
+
+    /* The first frame is already evaluated. */
+    for (int fr = group->startframe + baker->quick_step; fr <= group->endframe;
+         fr += baker->quick_step) {
+      DEG_evaluate_on_framechange(group->depsgraph, (float)fr);
+      group->frames_done++;
+
+      BLI_mutex_lock(&scheduler->mutex);
+      scheduler->frames_done++;
+      if (baker->update_progress) {
+        const float progress = (float)scheduler->frames_done / (float)scheduler->frames_total;
+        baker->update_progress(baker->bake_job, progress, &scheduler->cancel);
+      }
+      if (G.is_break) {
+        scheduler->cancel = 1;
+      }
+      const bool cancel = scheduler->cancel;
+      BLI_mutex_unlock(&scheduler->mutex);
+
+      if (G.background) {
+        printf("bake: %s frame %d :: %d\n", group->ids[0]->name + 2, fr, group->endframe);
+      }
+
+      /* NOTE: breaking baking should leave calculated frames in cache, not clear it */
+      if (cancel) {
+        break;
+      }
+    }
+
+    group->time += PIL_check_seconds_timer() - stime;
+  }
+
+  return NULL;
+}
+
+/* Bake all caches of the scene concurrently. Returns false when the caches can't be baked
+ * concurrently, nothing is changed then. */
+static bool ptcache_bake_concurrent(PTCacheBaker *baker)
+{
+  Scene *scene = baker->scene;
+  ListBase pids;
+
+  if (!ptcache_bake_concurrent_collect(baker, &pids) || BLI_listbase_is_empty(&pids)) {
+    BLI_freelistN(&pids);
+    return false;
+  }
+
+  PTCacheBakeScheduler scheduler = {.baker = baker};
+  scheduler.groups_num = ptcache_bake_concurrent_group(baker, &pids, &scheduler.groups);
+
+  if (scheduler.groups_num == 0) {
+    BLI_freelistN(&pids);
+    return false;
+  }
+  if (scheduler.groups_num == 1) {
+    BLI_freelistN(&scheduler.groups[0].pids);
+    MEM_freeN(scheduler.groups[0].ids);
+    MEM_freeN(scheduler.groups);
+    return false;
+  }
+
+  /* set caches to baking mode and figure out frame range of the groups */
+  for (int i = 0; i < scheduler.groups_num; i++) {
+    PTCacheBakeGroup *group = &scheduler.groups[i];
+
+    LISTBASE_FOREACH (PTCacheID *, pid, &group->pids) {
+      PointCache *cache = pid->cache;
+      if (pid->type == PTCACHE_TYPE_PARTICLES) {
+        psys_get_pointcache_start_end(scene, pid->calldata, &cache->startframe, &cache->endframe);
+      }
+      BKE_ptcache_id_clear(pid, PTCACHE_CLEAR_ALL, 0);
+
+      group->startframe = MIN2(group->startframe, cache->startframe);
+      group->endframe = MAX2(group->endframe, cache->endframe);
+
+      cache->flag |= PTCACHE_BAKING;
+      cache->flag &= ~PTCACHE_BAKED;
+    }
+
+    scheduler.frames_total += (group->endframe - group->startframe) / baker->quick_step + 1;
+
+    /* Caches are only written by the active depsgraph. Dependencies such as colliders are only
+     * evaluated in the depsgraph of the one group using them. */
+    group->depsgraph = DEG_graph_new(
+        baker->bmain, scene, baker->view_layer, DAG_EVAL_VIEWPORT);
+    DEG_graph_build_from_ids(group->depsgraph, group->ids, group->ids_num);
+    DEG_make_active(group->depsgraph);
+    DEG_graph_relations_update(group->depsgraph);
+  }
+
+  /* The groups evaluate their own copy of the scene at their own frame, only the frame length of
+   * the original is shared. */
+  float frameleno = scene->r.framelen;
+  scene->r.framelen = 1.0;
+
+  /* Evaluate the first frame of the groups one after another, which is where the IDs shared by
+   * all groups are evaluated and copied back to the original. */
+  for (int i = 0; i < scheduler.groups_num; i++) {
+    PTCacheBakeGroup *group = &scheduler.groups[i];
+    const double stime = PIL_check_seconds_timer();
+    DEG_evaluate_on_framechange(group->depsgraph, (float)group->startframe);
+    group->frames_done++;
+    group->time = PIL_check_seconds_timer() - stime;
+    scheduler.frames_done++;
+  }
+
+  const int threads_num = min_ii(baker->concurrent_bakes, scheduler.groups_num);
+  ListBase threads;
+
+  BLI_mutex_init(&scheduler.mutex);
+  BLI_threadpool_init(&threads, ptcache_bake_concurrent_thread, threads_num);
+  for (int i = 0; i < threads_num; i++) {
+    BLI_threadpool_insert(&threads, &scheduler);
+  }
+  BLI_threadpool_end(&threads);
+  BLI_mutex_end(&scheduler.mutex);
+
+  scene->r.framelen = frameleno;
+
+  for (int i = 0; i < scheduler.groups_num; i++) {
+    PTCacheBakeGroup *group = &scheduler.groups[i];
+    char run[32];
+
+    ptcache_dt_to_str(run, group->time);
+    LISTBASE_FOREACH (PTCacheID *, pid, &group->pids) {
+      printf("Baked %s %s: %i frames in %s (%.2f frames/s)\n",
+             pid->owner_id->name + 2,
+             ptcache_bake_type_name(pid),
+             group->frames_done,
+             run,
+             group->frames_done / max_dd(group->time, 1e-6));
+    }
+
+    /* The original depsgraph didn't evaluate the bake, read the baked frame on its update. */
+    for (int j = 0; j < group->ids_num; j++) {
+      DEG_id_tag_update_ex(baker->bmain, group->ids[j], ID_RECALC_GEOMETRY);
+    }
+
+    DEG_graph_free(group->depsgraph);
+    BLI_freelistN(&group->pids);
+  }
+
+  MEM_freeN(scheduler.groups[0].ids);
+  MEM_freeN(scheduler.groups);
+
+  ptcache_bake_all_finish(baker);
+
+  BKE_scene_graph_update_for_newframe(baker->depsgraph);
+
+  return true;
+}
+
 /* if bake is not given run simulations to current frame */
 void BKE_ptcache_bake(PTCacheBaker *baker)
 {
@@ -3221,6 +3926,12 @@ void BKE_ptcache_bake(PTCacheBaker *baker)
 
   G.is_break = false;
 
+  if (pid->owner_id == NULL && bake && !render && baker->concurrent_bakes > 1) {
+    if (ptcache_bake_concurrent(baker)) {
+      return;
+    }
+  }
+
   /* set caches to baking mode and figure out start frame */
   if (pid->owner_id) {
     /* cache/bake a single object */
@@ -3398,36 +4109,7 @@ void BKE_ptcache_bake(PTCacheBaker *baker)
     }
   }
   else {
-    for (SETLOOPER_VIEW_LAYER(scene, view_layer, sce_iter, base)) {
-      BKE_ptcache_ids_from_object(&pidlist, base->object, scene, MAX_DUPLI_RECUR);
-
-      for (pid = pidlist.first; pid; pid = pid->next) {
-        /* skip hair particles */
-        if (pid->type == PTCACHE_TYPE_PARTICLES &&
-            ((ParticleSystem *)pid->calldata)->part->type == PART_HAIR) {
-          continue;
-        }
-
-        cache = pid->cache;
-
-        if (baker->quick_step > 1) {
-          cache->flag &= ~(PTCACHE_BAKING | PTCACHE_OUTDATED);
-        }
-        else {
-          cache->flag &= ~(PTCACHE_BAKING | PTCACHE_REDO_NEEDED);
-        }
-
-        cache->flag |= PTCACHE_SIMULATION_VALID;
-
-        if (bake) {
-          cache->flag |= PTCACHE_BAKED;
-          if (cache->flag & PTCACHE_DISK_CACHE) {
-            BKE_ptcache_write(pid, 0);
-          }
-        }
-      }
-      BLI_freelistN(&pidlist);
-    }
+    ptcache_bake_all_finish(baker);
   }
 
   scene->r.framelen = frameleno;
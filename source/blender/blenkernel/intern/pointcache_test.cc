@@ -0,0 +1,90 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "BKE_pointcache.h"
+
+#include "BLI_rand.hh"
+#include "BLI_vector.hh"
+
+namespace blender::bke::tests {
+
+static void test_delta_round_trip(const size_t len, const size_t stride)
+{
+  RandomNumberGenerator rng(len * 31 + stride);
+  Vector<unsigned char> data(len);
+  for (unsigned char &value : data) {
+    value = (unsigned char)rng.get_int32(256);
+  }
+
+  Vector<unsigned char> encoded(len);
+  Vector<unsigned char> decoded(len);
+  BKE_ptcache_delta_encode(data.data(), encoded.data(), len, stride);
+  BKE_ptcache_delta_decode(encoded.data(), decoded.data(), len, stride);
+
+  for (const int i : data.index_range()) {
+    EXPECT_EQ(data[i], decoded[i]) << "len " << len << ", stride " << stride << ", byte " << i;
+  }
+}
+
+TEST(pointcache, delta_round_trip)
+{
+  /* Element sizes of the cache data types. */
+  const size_t strides[] = {1, 2, 4, 8, 12, 16};
+  for (const size_t stride : strides) {
+    for (const size_t num_elements : {0, 1, 2, 7, 100}) {
+      test_delta_round_trip(num_elements * stride, stride);
+    }
+  }
+}
+
+TEST(pointcache, delta_round_trip_unaligned)
+{
+  /* Lengths that are not a multiple of 4 are not split into byte planes, a zero stride disables
+   * the delta. */
+  for (const size_t len : {1, 2, 3, 5, 6, 7, 13, 101, 1023}) {
+    test_delta_round_trip(len, 0);
+    test_delta_round_trip(len, 1);
+    test_delta_round_trip(len, 3);
+    test_delta_round_trip(len, 5);
+  }
+}
+
+TEST(pointcache, delta_encode_float_planes)
+{
+  /* Equal elements encode to zeroes after the first element. */
+  const float co[3] = {1.5f, -2.25f, 3.0f};
+  const size_t num_points = 8;
+  Vector<float> data;
+  for (size_t i = 0; i < num_points; i++) {
+    data.extend({co[0], co[1], co[2]});
+  }
+  const size_t len = data.size() * sizeof(float);
+  const size_t stride = sizeof(co);
+  Vector<unsigned char> encoded(len);
+  BKE_ptcache_delta_encode((const unsigned char *)data.data(), encoded.data(), len, stride);
+
+  const size_t plane_len = len / 4;
+  for (size_t plane = 0; plane < 4; plane++) {
+    for (size_t i = stride / 4; i < plane_len; i++) {
+      EXPECT_EQ(encoded[plane * plane_len + i], 0);
+    }
+  }
+}
+
+}  // namespace blender::bke::tests
@@ -35,6 +35,7 @@
 
 #include "BLI_listbase.h"
 #include "BLI_math.h"
+#include "BLI_task.h"
 
 #ifdef WITH_BULLET
 #  include "RBI_api.h"
@@ -1954,19 +1955,27 @@ static ListBase rigidbody_create_substep_data(RigidBodyWorld *rbw)
   return substep_targets;
 }
 
-static void rigidbody_update_kinematic_obj_substep(ListBase *substep_targets, float interp_fac)
+static void rigidbody_update_kinematic_obj_substep(RigidBodyWorld *rbw,
+                                                   ListBase *substep_targets,
+                                                   float interp_fac)
 {
-  LISTBASE_FOREACH (LinkData *, link, substep_targets) {
-    KinematicSubstepData *data = link->data;
-    RigidBodyOb *rbo = data->rbo;
+  const int num_bodies = BLI_listbase_count(substep_targets);
+  if (num_bodies == 0) {
+    return;
+  }
 
-    float loc[3], rot[4];
+  rbRigidBody **bodies = MEM_malloc_arrayN(num_bodies, sizeof(*bodies), __func__);
+  float(*loc)[3] = MEM_malloc_arrayN(num_bodies, sizeof(*loc), __func__);
+  float(*rot)[4] = MEM_malloc_arrayN(num_bodies, sizeof(*rot), __func__);
+  int i = 0;
 
-    interp_v3_v3v3(loc, data->old_pos, data->new_pos, interp_fac);
-    interp_qt_qtqt(rot, data->old_rot, data->new_rot, interp_fac);
+  LISTBASE_FOREACH_INDEX (LinkData *, link, substep_targets, i) {
+    KinematicSubstepData *data = link->data;
+    RigidBodyOb *rbo = data->rbo;
 
-    RB_body_activate(rbo->shared->physics_object);
-    RB_body_set_loc_rot(rbo->shared->physics_object, loc, rot);
+    bodies[i] = rbo->shared->physics_object;
+    interp_v3_v3v3(loc[i], data->old_pos, data->new_pos, interp_fac);
+    interp_qt_qtqt(rot[i], data->old_rot, data->new_rot, interp_fac);
 
     if (!data->scale_changed) {
       /* Avoid having to rebuild the collision shape AABBs if scale didn't change. */
@@ -1985,6 +1994,12 @@ static void rigidbody_update_kinematic_obj_substep(ListBase *substep_targets, fl
                           RBO_GET_MARGIN(rbo) * MIN3(scale[0], scale[1], scale[2]));
     }
   }
+
+  RB_dworld_set_body_transforms(rbw->shared->physics_world, bodies, num_bodies, loc, rot, true);
+
+  MEM_freeN(bodies);
+  MEM_freeN(loc);
+  MEM_freeN(rot);
 }
 
 static void rigidbody_free_substep_data(ListBase *substep_targets)
@@ -2018,6 +2033,60 @@ static void rigidbody_update_simulation_post_step(Depsgraph *depsgraph, RigidBod
   FOREACH_COLLECTION_OBJECT_RECURSIVE_END;
 }
 
+/* Number of bodies whose transforms are transferred with one bulk call. */
+#  define RB_TRANSFORM_CHUNK_SIZE 256
+
+static void rigidbody_update_ob_transforms_cb(void *__restrict userdata,
+                                              const int chunk,
+                                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  RigidBodyWorld *rbw = userdata;
+  rbRigidBody *bodies[RB_TRANSFORM_CHUNK_SIZE];
+  RigidBodyOb *rbos[RB_TRANSFORM_CHUNK_SIZE];
+  float loc[RB_TRANSFORM_CHUNK_SIZE][3];
+  float rot[RB_TRANSFORM_CHUNK_SIZE][4];
+  int num_bodies = 0;
+
+  const int start = chunk * RB_TRANSFORM_CHUNK_SIZE;
+  const int end = min_ii(start + RB_TRANSFORM_CHUNK_SIZE, rbw->numbodies);
+
+  for (int i = start; i < end; i++) {
+    Object *ob = rbw->objects[i];
+    RigidBodyOb *rbo = ob ? ob->rigidbody_object : NULL;
+
+    /* Only active bodies are moved by the simulation. */
+    if (rbo && rbo->type == RBO_TYPE_ACTIVE && rbo->shared->physics_object != NULL) {
+      bodies[num_bodies] = rbo->shared->physics_object;
+      rbos[num_bodies] = rbo;
+      num_bodies++;
+    }
+  }
+
+  RB_dworld_get_body_transforms(rbw->shared->physics_world, bodies, num_bodies, loc, rot);
+
+  for (int i = 0; i < num_bodies; i++) {
+    copy_v3_v3(rbos[i]->pos, loc[i]);
+    copy_v4_v4(rbos[i]->orn, rot[i]);
+  }
+}
+
+/* Read the simulated transforms of all active bodies into their #RigidBodyOb, in bulk. */
+static void rigidbody_update_ob_transforms(RigidBodyWorld *rbw)
+{
+  if (rbw->objects == NULL || rbw->shared->physics_world == NULL) {
+    return;
+  }
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = (rbw->numbodies > 4 * RB_TRANSFORM_CHUNK_SIZE);
+  BLI_task_parallel_range(0,
+                          divide_ceil_u(rbw->numbodies, RB_TRANSFORM_CHUNK_SIZE),
+                          rbw,
+                          rigidbody_update_ob_transforms_cb,
+                          &settings);
+}
+
 bool BKE_rigidbody_check_sim_running(RigidBodyWorld *rbw, float ctime)
 {
   return (rbw && (rbw->flag & RBW_FLAG_MUTED) == 0 && ctime > rbw->shared->pointcache->startframe);
@@ -2223,6 +2292,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
   if (compare_ff_relative(ctime, rbw->ltime + 1, FLT_EPSILON, 64)) {
     /* write cache for first frame when on second frame */
     if (rbw->ltime == startframe && (cache->flag & PTCACHE_OUTDATED || cache->last_exact == 0)) {
+      rigidbody_update_ob_transforms(rbw);
       BKE_ptcache_write(&pid, startframe);
     }
 
@@ -2241,7 +2311,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
     float cur_interp_val = interp_step;
 
     for (int i = 0; i < rbw->substeps_per_frame; i++) {
-      rigidbody_update_kinematic_obj_substep(&substep_targets, cur_interp_val);
+      rigidbody_update_kinematic_obj_substep(rbw, &substep_targets, cur_interp_val);
       RB_dworld_step_simulation(rbw->shared->physics_world, substep, 0, substep);
       cur_interp_val += interp_step;
     }
@@ -2250,6 +2320,7 @@ void BKE_rigidbody_do_simulation(Depsgraph *depsgraph, Scene *scene, float ctime
     rigidbody_update_simulation_post_step(depsgraph, rbw);
 
     /* write cache for current frame */
+    rigidbody_update_ob_transforms(rbw);
     BKE_ptcache_validate(cache, (int)ctime);
     BKE_ptcache_write(&pid, (unsigned int)ctime);
 
@@ -59,7 +59,7 @@
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_math.h"
-#include "BLI_threads.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_collection.h"
@@ -72,7 +72,6 @@
 #include "BKE_mesh.h"
 #include "BKE_modifier.h"
 #include "BKE_pointcache.h"
-#include "BKE_scene.h"
 #include "BKE_softbody.h"
 
 #include "DEG_depsgraph.h"
@@ -100,6 +99,7 @@ typedef struct BodySpring {
 typedef struct BodyFace {
   int v1, v2, v3;
   float ext_force[3]; /* faces colliding */
+  float damp;         /* damping of the detected collision */
   short flag;
 } BodyFace;
 
@@ -129,16 +129,23 @@ typedef struct SB_thread_context {
   Object *ob;
   float forcetime;
   float timenow;
-  int ifirst;
-  int ilast;
   ListBase *effectors;
   int do_deflector;
   float fieldfactor;
   float windfactor;
-  int nr;
-  int tot;
+  int do_selfcollision;
+  int do_springcollision;
+  int do_aero;
 } SB_thread_context;
 
+/* Accumulated per thread while calculating forces, joined after. */
+typedef struct SB_thread_accum {
+  bool do_fuzzy;
+} SB_thread_accum;
+
+/* Below this many points or springs per thread, forces aren't threaded. */
+#define SB_MIN_ITER_PER_THREAD 64
+
 #define MID_PRESERVE 1
 
 #define SOFTGOALSNAP 0.999f
@@ -1258,60 +1265,86 @@ static int sb_detect_face_collisionCached(const float face_v1[3],
   return deflected;
 }
 
+typedef struct SB_FaceForcesData {
+  SoftBody *sb;
+  Object *ob;
+  float timenow;
+} SB_FaceForcesData;
+
+/* Collision detection of one face, the result is kept in the face to be applied in order. */
+static void scan_for_ext_face_forces_cb(void *__restrict userdata,
+                                        const int a,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  SB_FaceForcesData *data = userdata;
+  SoftBody *sb = data->sb;
+  BodyFace *bf = &sb->scratch->bodyface[a];
+  float damp = 0.0f;
+
+  zero_v3(bf->ext_force);
+  bf->damp = 0.0f;
+  bf->flag &= ~(BFF_INTERSECT | BFF_CLOSEVERT);
+
+  /*+++edges intruding. */
+  if (sb_detect_face_collisionCached(sb->bpoint[bf->v1].pos,
+                                     sb->bpoint[bf->v2].pos,
+                                     sb->bpoint[bf->v3].pos,
+                                     &damp,
+                                     bf->ext_force,
+                                     data->ob,
+                                     data->timenow)) {
+    bf->flag |= BFF_INTERSECT;
+    bf->damp = damp;
+    return;
+  }
+  /*---edges intruding. */
+
+  /*+++ close vertices. */
+  zero_v3(bf->ext_force);
+  if (sb_detect_face_pointCached(sb->bpoint[bf->v1].pos,
+                                 sb->bpoint[bf->v2].pos,
+                                 sb->bpoint[bf->v3].pos,
+                                 &damp,
+                                 bf->ext_force,
+                                 data->ob,
+                                 data->timenow)) {
+    bf->flag |= BFF_CLOSEVERT;
+    bf->damp = damp;
+  }
+  /*--- close vertices. */
+}
+
 static void scan_for_ext_face_forces(Object *ob, float timenow)
 {
   SoftBody *sb = ob->soft;
   BodyFace *bf;
   int a;
-  float damp = 0.0f, choke = 1.0f;
+  float choke = 1.0f;
   float tune = -10.0f;
-  float feedback[3];
 
   if (sb && sb->scratch->totface) {
-
+    SB_FaceForcesData data = {
+        .sb = sb,
+        .ob = ob,
+        .timenow = timenow,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = SB_MIN_ITER_PER_THREAD;
+    BLI_task_parallel_range(0, sb->scratch->totface, &data, scan_for_ext_face_forces_cb, &settings);
+
+    /* Faces share points and the tuning depends on the faces before, apply in order. */
     bf = sb->scratch->bodyface;
     for (a = 0; a < sb->scratch->totface; a++, bf++) {
-      bf->ext_force[0] = bf->ext_force[1] = bf->ext_force[2] = 0.0f;
-      /*+++edges intruding. */
-      bf->flag &= ~BFF_INTERSECT;
-      zero_v3(feedback);
-      if (sb_detect_face_collisionCached(sb->bpoint[bf->v1].pos,
-                                         sb->bpoint[bf->v2].pos,
-                                         sb->bpoint[bf->v3].pos,
-                                         &damp,
-                                         feedback,
-                                         ob,
-                                         timenow)) {
-        madd_v3_v3fl(sb->bpoint[bf->v1].force, feedback, tune);
-        madd_v3_v3fl(sb->bpoint[bf->v2].force, feedback, tune);
-        madd_v3_v3fl(sb->bpoint[bf->v3].force, feedback, tune);
-        //              madd_v3_v3fl(bf->ext_force, feedback, tune);
-        bf->flag |= BFF_INTERSECT;
-        choke = min_ff(max_ff(damp, choke), 1.0f);
-      }
-      /*---edges intruding. */
-
-      /*+++ close vertices. */
       if ((bf->flag & BFF_INTERSECT) == 0) {
-        bf->flag &= ~BFF_CLOSEVERT;
         tune = -1.0f;
-        zero_v3(feedback);
-        if (sb_detect_face_pointCached(sb->bpoint[bf->v1].pos,
-                                       sb->bpoint[bf->v2].pos,
-                                       sb->bpoint[bf->v3].pos,
-                                       &damp,
-                                       feedback,
-                                       ob,
-                                       timenow)) {
-          madd_v3_v3fl(sb->bpoint[bf->v1].force, feedback, tune);
-          madd_v3_v3fl(sb->bpoint[bf->v2].force, feedback, tune);
-          madd_v3_v3fl(sb->bpoint[bf->v3].force, feedback, tune);
-          //                  madd_v3_v3fl(bf->ext_force, feedback, tune);
-          bf->flag |= BFF_CLOSEVERT;
-          choke = min_ff(max_ff(damp, choke), 1.0f);
-        }
       }
-      /*--- close vertices. */
+      if ((bf->flag & BFF_INTERSECT) || (bf->flag & BFF_CLOSEVERT)) {
+        madd_v3_v3fl(sb->bpoint[bf->v1].force, bf->ext_force, tune);
+        madd_v3_v3fl(sb->bpoint[bf->v2].force, bf->ext_force, tune);
+        madd_v3_v3fl(sb->bpoint[bf->v3].force, bf->ext_force, tune);
+        choke = min_ff(max_ff(bf->damp, choke), 1.0f);
+      }
     }
     bf = sb->scratch->bodyface;
     for (a = 0; a < sb->scratch->totface; a++, bf++) {
@@ -1441,88 +1474,81 @@ static int sb_detect_edge_collisionCached(const float edge_v1[3],
   return deflected;
 }
 
-static void _scan_for_ext_spring_forces(
-    Scene *scene, Object *ob, float timenow, int ifirst, int ilast, struct ListBase *effectors)
+static void scan_for_ext_spring_forces_cb(void *__restrict userdata,
+                                          const int a,
+                                          const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  SB_thread_context *pctx = userdata;
+  Scene *scene = pctx->scene;
+  Object *ob = pctx->ob;
+  ListBase *effectors = pctx->effectors;
+  const float timenow = pctx->timenow;
   SoftBody *sb = ob->soft;
-  int a;
   float damp;
   float feedback[3];
 
-  if (sb && sb->totspring) {
-    for (a = ifirst; a < ilast; a++) {
-      BodySpring *bs = &sb->bspring[a];
-      bs->ext_force[0] = bs->ext_force[1] = bs->ext_force[2] = 0.0f;
-      feedback[0] = feedback[1] = feedback[2] = 0.0f;
-      bs->flag &= ~BSF_INTERSECT;
+  BodySpring *bs = &sb->bspring[a];
+  bs->ext_force[0] = bs->ext_force[1] = bs->ext_force[2] = 0.0f;
+  feedback[0] = feedback[1] = feedback[2] = 0.0f;
+  bs->flag &= ~BSF_INTERSECT;
+
+  if (bs->springtype == SB_EDGE) {
+    /* +++ springs colliding */
+    if (ob->softflag & OB_SB_EDGECOLL) {
+      if (sb_detect_edge_collisionCached(
+              sb->bpoint[bs->v1].pos, sb->bpoint[bs->v2].pos, &damp, feedback, ob, timenow)) {
+        add_v3_v3(bs->ext_force, feedback);
+        bs->flag |= BSF_INTERSECT;
+        // bs->cf=damp;
+        bs->cf = sb->choke * 0.01f;
+      }
+    }
+    /* ---- springs colliding */
 
-      if (bs->springtype == SB_EDGE) {
-        /* +++ springs colliding */
-        if (ob->softflag & OB_SB_EDGECOLL) {
-          if (sb_detect_edge_collisionCached(
-                  sb->bpoint[bs->v1].pos, sb->bpoint[bs->v2].pos, &damp, feedback, ob, timenow)) {
-            add_v3_v3(bs->ext_force, feedback);
-            bs->flag |= BSF_INTERSECT;
-            // bs->cf=damp;
-            bs->cf = sb->choke * 0.01f;
-          }
-        }
-        /* ---- springs colliding */
-
-        /* +++ springs seeing wind ... n stuff depending on their orientation. */
-        /* NOTE: we don't use `sb->mediafrict` but use `sb->aeroedge` for magnitude of effect. */
-        if (sb->aeroedge) {
-          float vel[3], sp[3], pr[3], force[3];
-          float f, windfactor = 0.25f;
-          /* See if we have wind. */
-          if (effectors) {
-            EffectedPoint epoint;
-            float speed[3] = {0.0f, 0.0f, 0.0f};
-            float pos[3];
-            mid_v3_v3v3(pos, sb->bpoint[bs->v1].pos, sb->bpoint[bs->v2].pos);
-            mid_v3_v3v3(vel, sb->bpoint[bs->v1].vec, sb->bpoint[bs->v2].vec);
-            pd_point_from_soft(scene, pos, vel, -1, &epoint);
-            BKE_effectors_apply(
-                effectors, NULL, sb->effector_weights, &epoint, force, NULL, speed);
-
-            mul_v3_fl(speed, windfactor);
-            add_v3_v3(vel, speed);
-          }
-          /* media in rest */
-          else {
-            add_v3_v3v3(vel, sb->bpoint[bs->v1].vec, sb->bpoint[bs->v2].vec);
-          }
-          f = normalize_v3(vel);
-          f = -0.0001f * f * f * sb->aeroedge;
-          /* (todo) add a nice angle dependent function done for now BUT */
-          /* still there could be some nice drag/lift function, but who needs it */
-
-          sub_v3_v3v3(sp, sb->bpoint[bs->v1].pos, sb->bpoint[bs->v2].pos);
-          project_v3_v3v3(pr, vel, sp);
-          sub_v3_v3(vel, pr);
-          normalize_v3(vel);
-          if (ob->softflag & OB_SB_AERO_ANGLE) {
-            normalize_v3(sp);
-            madd_v3_v3fl(bs->ext_force, vel, f * (1.0f - fabsf(dot_v3v3(vel, sp))));
-          }
-          else {
-            madd_v3_v3fl(bs->ext_force, vel, f); /* to keep compatible with 2.45 release files */
-          }
-        }
-        /* --- springs seeing wind */
+    /* +++ springs seeing wind ... n stuff depending on their orientation. */
+    /* NOTE: we don't use `sb->mediafrict` but use `sb->aeroedge` for magnitude of effect. */
+    if (sb->aeroedge) {
+      float vel[3], sp[3], pr[3], force[3];
+      float f, windfactor = 0.25f;
+      /* See if we have wind. */
+      if (effectors) {
+        EffectedPoint epoint;
+        float speed[3] = {0.0f, 0.0f, 0.0f};
+        float pos[3];
+        mid_v3_v3v3(pos, sb->bpoint[bs->v1].pos, sb->bpoint[bs->v2].pos);
+        mid_v3_v3v3(vel, sb->bpoint[bs->v1].vec, sb->bpoint[bs->v2].vec);
+        pd_point_from_soft(scene, pos, vel, -1, &epoint);
+        BKE_effectors_apply(
+            effectors, NULL, sb->effector_weights, &epoint, force, NULL, speed);
+
+        mul_v3_fl(speed, windfactor);
+        add_v3_v3(vel, speed);
+      }
+      /* media in rest */
+      else {
+        add_v3_v3v3(vel, sb->bpoint[bs->v1].vec, sb->bpoint[bs->v2].vec);
+      }
+      f = normalize_v3(vel);
+      f = -0.0001f * f * f * sb->aeroedge;
+      /* (todo) add a nice angle dependent function done for now BUT */
+      /* still there could be some nice drag/lift function, but who needs it */
+
+      sub_v3_v3v3(sp, sb->bpoint[bs->v1].pos, sb->bpoint[bs->v2].pos);
+      project_v3_v3v3(pr, vel, sp);
+      sub_v3_v3(vel, pr);
+      normalize_v3(vel);
+      if (ob->softflag & OB_SB_AERO_ANGLE) {
+        normalize_v3(sp);
+        madd_v3_v3fl(bs->ext_force, vel, f * (1.0f - fabsf(dot_v3v3(vel, sp))));
+      }
+      else {
+        madd_v3_v3fl(bs->ext_force, vel, f); /* to keep compatible with 2.45 release files */
       }
     }
+    /* --- springs seeing wind */
   }
 }
 
-static void *exec_scan_for_ext_spring_forces(void *data)
-{
-  SB_thread_context *pctx = (SB_thread_context *)data;
-  _scan_for_ext_spring_forces(
-      pctx->scene, pctx->ob, pctx->timenow, pctx->ifirst, pctx->ilast, pctx->effectors);
-  return NULL;
-}
-
 static void sb_sfesf_threads_run(struct Depsgraph *depsgraph,
                                  Scene *scene,
                                  struct Object *ob,
@@ -1530,62 +1556,24 @@ static void sb_sfesf_threads_run(struct Depsgraph *depsgraph,
                                  int totsprings,
                                  int *UNUSED(ptr_to_break_func(void)))
 {
-  ListBase threads;
-  SB_thread_context *sb_threads;
-  int i, totthread, left, dec;
-
-  /* wild guess .. may increase with better thread management 'above'
-   * or even be UI option sb->spawn_cf_threads_nopts */
-  int lowsprings = 100;
+  if (totsprings == 0) {
+    return;
+  }
 
   ListBase *effectors = BKE_effectors_create(
       depsgraph, ob, NULL, ob->soft->effector_weights, false);
 
-  /* figure the number of threads while preventing pretty pointless threading overhead */
-  totthread = BKE_scene_num_threads(scene);
-  /* What if we got zillions of CPUs running but less to spread. */
-  while ((totsprings / totthread < lowsprings) && (totthread > 1)) {
-    totthread--;
-  }
-
-  sb_threads = MEM_callocN(sizeof(SB_thread_context) * totthread, "SBSpringsThread");
-  memset(sb_threads, 0, sizeof(SB_thread_context) * totthread);
-  left = totsprings;
-  dec = totsprings / totthread + 1;
-  for (i = 0; i < totthread; i++) {
-    sb_threads[i].scene = scene;
-    sb_threads[i].ob = ob;
-    sb_threads[i].forcetime = 0.0; /* not used here */
-    sb_threads[i].timenow = timenow;
-    sb_threads[i].ilast = left;
-    left = left - dec;
-    if (left > 0) {
-      sb_threads[i].ifirst = left;
-    }
-    else {
-      sb_threads[i].ifirst = 0;
-    }
-    sb_threads[i].effectors = effectors;
-    sb_threads[i].do_deflector = false; /* not used here */
-    sb_threads[i].fieldfactor = 0.0f;   /* not used here */
-    sb_threads[i].windfactor = 0.0f;    /* not used here */
-    sb_threads[i].nr = i;
-    sb_threads[i].tot = totthread;
-  }
-  if (totthread > 1) {
-    BLI_threadpool_init(&threads, exec_scan_for_ext_spring_forces, totthread);
-
-    for (i = 0; i < totthread; i++) {
-      BLI_threadpool_insert(&threads, &sb_threads[i]);
-    }
+  SB_thread_context ctx = {
+      .scene = scene,
+      .ob = ob,
+      .timenow = timenow,
+      .effectors = effectors,
+  };
 
-    BLI_threadpool_end(&threads);
-  }
-  else {
-    exec_scan_for_ext_spring_forces(&sb_threads[0]);
-  }
-  /* clean up */
-  MEM_freeN(sb_threads);
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = SB_MIN_ITER_PER_THREAD;
+  BLI_task_parallel_range(0, totsprings, &ctx, scan_for_ext_spring_forces_cb, &settings);
 
   BKE_effectors_free(effectors);
 }
@@ -1957,246 +1945,213 @@ static void sb_spring_force(
   madd_v3_v3fl(bp1->force, dir, -kd);
 }
 
-/* since this is definitely the most CPU consuming task here .. try to spread it */
-/* core function _softbody_calc_forces_slice_in_a_thread */
-/* result is int to be able to flag user break */
-static int _softbody_calc_forces_slice_in_a_thread(Scene *scene,
-                                                   Object *ob,
-                                                   float forcetime,
-                                                   float timenow,
-                                                   int ifirst,
-                                                   int ilast,
-                                                   int *UNUSED(ptr_to_break_func(void)),
-                                                   ListBase *effectors,
-                                                   int do_deflector,
-                                                   float fieldfactor,
-                                                   float windfactor)
-{
+/* Since this is definitely the most CPU consuming task here, it runs for every point in
+ * parallel. Only the point itself is written, forces of other points are read. */
+static void softbody_calc_forces_cb(void *__restrict userdata,
+                                    const int index,
+                                    const TaskParallelTLS *__restrict tls)
+{
+  const SB_thread_context *pctx = userdata;
+  SB_thread_accum *accum = tls->userdata_chunk;
+  Scene *scene = pctx->scene;
+  Object *ob = pctx->ob;
+  ListBase *effectors = pctx->effectors;
+  const float forcetime = pctx->forcetime;
+  const float timenow = pctx->timenow;
+  const float fieldfactor = pctx->fieldfactor;
+  const float windfactor = pctx->windfactor;
+  const int do_deflector = pctx->do_deflector;
+  const int do_selfcollision = pctx->do_selfcollision;
+  const int do_springcollision = pctx->do_springcollision;
+  const int do_aero = pctx->do_aero;
+  SoftBody *sb = ob->soft;
+  BodyPoint *bp = &sb->bpoint[index];
   float iks;
-  int bb, do_selfcollision, do_springcollision, do_aero;
-  int number_of_points_here = ilast - ifirst;
-  SoftBody *sb = ob->soft; /* is supposed to be there */
-  BodyPoint *bp;
 
-  /* initialize */
-  if (sb) {
-    /* check conditions for various options */
-    /* +++ could be done on object level to squeeze out the last bits of it */
-    do_selfcollision = ((ob->softflag & OB_SB_EDGES) && (sb->bspring) &&
-                        (ob->softflag & OB_SB_SELF));
-    do_springcollision = do_deflector && (ob->softflag & OB_SB_EDGES) &&
-                         (ob->softflag & OB_SB_EDGECOLL);
-    do_aero = ((sb->aeroedge) && (ob->softflag & OB_SB_EDGES));
-    /* --- could be done on object level to squeeze out the last bits of it */
-  }
-  else {
-    CLOG_ERROR(&LOG, "expected a SB here");
-    return 999;
-  }
-
-  /* Debugging. */
-  if (sb->totpoint < ifirst) {
-    printf("Aye 998");
-    return 998;
-  }
-  /* Debugging. */
-
-  bp = &sb->bpoint[ifirst];
-  for (bb = number_of_points_here; bb > 0; bb--, bp++) {
-    /* clear forces  accumulator */
-    bp->force[0] = bp->force[1] = bp->force[2] = 0.0;
-    /* naive ball self collision */
-    /* needs to be done if goal snaps or not */
-    if (do_selfcollision) {
-      int attached;
-      BodyPoint *obp;
-      BodySpring *bs;
-      int c, b;
-      float velcenter[3], dvel[3], def[3];
-      float distance;
-      float compare;
-      float bstune = sb->ballstiff;
-
-      /* Running in a slice we must not assume anything done with obp
-       * neither alter the data of obp. */
-      for (c = sb->totpoint, obp = sb->bpoint; c > 0; c--, obp++) {
-        compare = (obp->colball + bp->colball);
-        sub_v3_v3v3(def, bp->pos, obp->pos);
-        /* rather check the AABBoxes before ever calculating the real distance */
-        /* mathematically it is completely nuts, but performance is pretty much (3) times faster */
-        if ((fabsf(def[0]) > compare) || (fabsf(def[1]) > compare) || (fabsf(def[2]) > compare)) {
-          continue;
-        }
-        distance = normalize_v3(def);
-        if (distance < compare) {
-          /* exclude body points attached with a spring */
-          attached = 0;
-          for (b = obp->nofsprings; b > 0; b--) {
-            bs = sb->bspring + obp->springs[b - 1];
-            if (ELEM(ilast - bb, bs->v2, bs->v1)) {
-              attached = 1;
-              continue;
-            }
+  /* clear forces  accumulator */
+  bp->force[0] = bp->force[1] = bp->force[2] = 0.0;
+  /* naive ball self collision */
+  /* needs to be done if goal snaps or not */
+  if (do_selfcollision) {
+    int attached;
+    BodyPoint *obp;
+    BodySpring *bs;
+    int c, b;
+    float velcenter[3], dvel[3], def[3];
+    float distance;
+    float compare;
+    float bstune = sb->ballstiff;
+
+    /* Running in a slice we must not assume anything done with obp
+     * neither alter the data of obp. */
+    for (c = sb->totpoint, obp = sb->bpoint; c > 0; c--, obp++) {
+      compare = (obp->colball + bp->colball);
+      sub_v3_v3v3(def, bp->pos, obp->pos);
+      /* rather check the AABBoxes before ever calculating the real distance */
+      /* mathematically it is completely nuts, but performance is pretty much (3) times faster */
+      if ((fabsf(def[0]) > compare) || (fabsf(def[1]) > compare) || (fabsf(def[2]) > compare)) {
+        continue;
+      }
+      distance = normalize_v3(def);
+      if (distance < compare) {
+        /* exclude body points attached with a spring */
+        attached = 0;
+        for (b = obp->nofsprings; b > 0; b--) {
+          bs = sb->bspring + obp->springs[b - 1];
+          if (ELEM(index, bs->v2, bs->v1)) {
+            attached = 1;
+            continue;
           }
-          if (!attached) {
-            float f = bstune / (distance) + bstune / (compare * compare) * distance -
-                      2.0f * bstune / compare;
+        }
+        if (!attached) {
+          float f = bstune / (distance) + bstune / (compare * compare) * distance -
+                    2.0f * bstune / compare;
 
-            mid_v3_v3v3(velcenter, bp->vec, obp->vec);
-            sub_v3_v3v3(dvel, velcenter, bp->vec);
-            mul_v3_fl(dvel, _final_mass(ob, bp));
+          mid_v3_v3v3(velcenter, bp->vec, obp->vec);
+          sub_v3_v3v3(dvel, velcenter, bp->vec);
+          mul_v3_fl(dvel, _final_mass(ob, bp));
 
-            madd_v3_v3fl(bp->force, def, f * (1.0f - sb->balldamp));
-            madd_v3_v3fl(bp->force, dvel, sb->balldamp);
-          }
+          madd_v3_v3fl(bp->force, def, f * (1.0f - sb->balldamp));
+          madd_v3_v3fl(bp->force, dvel, sb->balldamp);
         }
       }
     }
-    /* naive ball self collision done */
-
-    if (_final_goal(ob, bp) < SOFTGOALSNAP) { /* omit this bp when it snaps */
-      float auxvect[3];
-      float velgoal[3];
-
-      /* do goal stuff */
-      if (ob->softflag & OB_SB_GOAL) {
-        /* true elastic goal */
-        float ks, kd;
-        sub_v3_v3v3(auxvect, bp->pos, bp->origT);
-        ks = 1.0f / (1.0f - _final_goal(ob, bp) * sb->goalspring) - 1.0f;
-        bp->force[0] += -ks * (auxvect[0]);
-        bp->force[1] += -ks * (auxvect[1]);
-        bp->force[2] += -ks * (auxvect[2]);
-
-        /* Calculate damping forces generated by goals. */
-        sub_v3_v3v3(velgoal, bp->origS, bp->origE);
-        kd = sb->goalfrict * sb_fric_force_scale(ob);
-        add_v3_v3v3(auxvect, velgoal, bp->vec);
-
-        if (forcetime >
-            0.0f) { /* make sure friction does not become rocket motor on time reversal */
-          bp->force[0] -= kd * (auxvect[0]);
-          bp->force[1] -= kd * (auxvect[1]);
-          bp->force[2] -= kd * (auxvect[2]);
-        }
-        else {
-          bp->force[0] -= kd * (velgoal[0] - bp->vec[0]);
-          bp->force[1] -= kd * (velgoal[1] - bp->vec[1]);
-          bp->force[2] -= kd * (velgoal[2] - bp->vec[2]);
-        }
-      }
-      /* done goal stuff */
-
-      /* gravitation */
-      if (scene->physics_settings.flag & PHYS_GLOBAL_GRAVITY) {
-        float gravity[3];
-        copy_v3_v3(gravity, scene->physics_settings.gravity);
+  }
+  /* naive ball self collision done */
 
-        /* Individual mass of node here. */
-        mul_v3_fl(gravity,
-                  sb_grav_force_scale(ob) * _final_mass(ob, bp) *
-                      sb->effector_weights->global_gravity);
+  if (_final_goal(ob, bp) < SOFTGOALSNAP) { /* omit this bp when it snaps */
+    float auxvect[3];
+    float velgoal[3];
 
-        add_v3_v3(bp->force, gravity);
+    /* do goal stuff */
+    if (ob->softflag & OB_SB_GOAL) {
+      /* true elastic goal */
+      float ks, kd;
+      sub_v3_v3v3(auxvect, bp->pos, bp->origT);
+      ks = 1.0f / (1.0f - _final_goal(ob, bp) * sb->goalspring) - 1.0f;
+      bp->force[0] += -ks * (auxvect[0]);
+      bp->force[1] += -ks * (auxvect[1]);
+      bp->force[2] += -ks * (auxvect[2]);
+
+      /* Calculate damping forces generated by goals. */
+      sub_v3_v3v3(velgoal, bp->origS, bp->origE);
+      kd = sb->goalfrict * sb_fric_force_scale(ob);
+      add_v3_v3v3(auxvect, velgoal, bp->vec);
+
+      if (forcetime >
+          0.0f) { /* make sure friction does not become rocket motor on time reversal */
+        bp->force[0] -= kd * (auxvect[0]);
+        bp->force[1] -= kd * (auxvect[1]);
+        bp->force[2] -= kd * (auxvect[2]);
+      }
+      else {
+        bp->force[0] -= kd * (velgoal[0] - bp->vec[0]);
+        bp->force[1] -= kd * (velgoal[1] - bp->vec[1]);
+        bp->force[2] -= kd * (velgoal[2] - bp->vec[2]);
       }
+    }
+    /* done goal stuff */
 
-      /* particle field & vortex */
-      if (effectors) {
-        EffectedPoint epoint;
-        float kd;
-        float force[3] = {0.0f, 0.0f, 0.0f};
-        float speed[3] = {0.0f, 0.0f, 0.0f};
+    /* gravitation */
+    if (scene->physics_settings.flag & PHYS_GLOBAL_GRAVITY) {
+      float gravity[3];
+      copy_v3_v3(gravity, scene->physics_settings.gravity);
 
-        /* just for calling function once */
-        float eval_sb_fric_force_scale = sb_fric_force_scale(ob);
+      /* Individual mass of node here. */
+      mul_v3_fl(gravity,
+                sb_grav_force_scale(ob) * _final_mass(ob, bp) *
+                    sb->effector_weights->global_gravity);
 
-        pd_point_from_soft(scene, bp->pos, bp->vec, sb->bpoint - bp, &epoint);
-        BKE_effectors_apply(effectors, NULL, sb->effector_weights, &epoint, force, NULL, speed);
+      add_v3_v3(bp->force, gravity);
+    }
 
-        /* Apply force-field. */
-        mul_v3_fl(force, fieldfactor * eval_sb_fric_force_scale);
-        add_v3_v3(bp->force, force);
+    /* particle field & vortex */
+    if (effectors) {
+      EffectedPoint epoint;
+      float kd;
+      float force[3] = {0.0f, 0.0f, 0.0f};
+      float speed[3] = {0.0f, 0.0f, 0.0f};
 
-        /* BP friction in moving media */
-        kd = sb->mediafrict * eval_sb_fric_force_scale;
-        bp->force[0] -= kd * (bp->vec[0] + windfactor * speed[0] / eval_sb_fric_force_scale);
-        bp->force[1] -= kd * (bp->vec[1] + windfactor * speed[1] / eval_sb_fric_force_scale);
-        bp->force[2] -= kd * (bp->vec[2] + windfactor * speed[2] / eval_sb_fric_force_scale);
-        /* now we'll have nice centrifugal effect for vortex */
-      }
-      else {
-        /* BP friction in media (not) moving. */
-        float kd = sb->mediafrict * sb_fric_force_scale(ob);
-        /* assume it to be proportional to actual velocity */
-        bp->force[0] -= bp->vec[0] * kd;
-        bp->force[1] -= bp->vec[1] * kd;
-        bp->force[2] -= bp->vec[2] * kd;
-        /* friction in media done */
-      }
-      /* +++cached collision targets */
-      bp->choke = 0.0f;
-      bp->choke2 = 0.0f;
-      bp->loc_flag &= ~SBF_DOFUZZY;
-      if (do_deflector && !(bp->loc_flag & SBF_OUTOFCOLLISION)) {
-        float cfforce[3], defforce[3] = {0.0f, 0.0f, 0.0f}, vel[3] = {0.0f, 0.0f, 0.0f},
-                          facenormal[3], cf = 1.0f, intrusion;
-        float kd = 1.0f;
-
-        if (sb_deflect_face(ob, bp->pos, facenormal, defforce, &cf, timenow, vel, &intrusion)) {
-          if (intrusion < 0.0f) {
-            sb->scratch->flag |= SBF_DOFUZZY;
-            bp->loc_flag |= SBF_DOFUZZY;
-            bp->choke = sb->choke * 0.01f;
-          }
+      /* just for calling function once */
+      float eval_sb_fric_force_scale = sb_fric_force_scale(ob);
+
+      pd_point_from_soft(scene, bp->pos, bp->vec, sb->bpoint - bp, &epoint);
+      BKE_effectors_apply(effectors, NULL, sb->effector_weights, &epoint, force, NULL, speed);
 
-          sub_v3_v3v3(cfforce, bp->vec, vel);
-          madd_v3_v3fl(bp->force, cfforce, -cf * 50.0f);
+      /* Apply force-field. */
+      mul_v3_fl(force, fieldfactor * eval_sb_fric_force_scale);
+      add_v3_v3(bp->force, force);
 
-          madd_v3_v3fl(bp->force, defforce, kd);
+      /* BP friction in moving media */
+      kd = sb->mediafrict * eval_sb_fric_force_scale;
+      bp->force[0] -= kd * (bp->vec[0] + windfactor * speed[0] / eval_sb_fric_force_scale);
+      bp->force[1] -= kd * (bp->vec[1] + windfactor * speed[1] / eval_sb_fric_force_scale);
+      bp->force[2] -= kd * (bp->vec[2] + windfactor * speed[2] / eval_sb_fric_force_scale);
+      /* now we'll have nice centrifugal effect for vortex */
+    }
+    else {
+      /* BP friction in media (not) moving. */
+      float kd = sb->mediafrict * sb_fric_force_scale(ob);
+      /* assume it to be proportional to actual velocity */
+      bp->force[0] -= bp->vec[0] * kd;
+      bp->force[1] -= bp->vec[1] * kd;
+      bp->force[2] -= bp->vec[2] * kd;
+      /* friction in media done */
+    }
+    /* +++cached collision targets */
+    bp->choke = 0.0f;
+    bp->choke2 = 0.0f;
+    bp->loc_flag &= ~SBF_DOFUZZY;
+    if (do_deflector && !(bp->loc_flag & SBF_OUTOFCOLLISION)) {
+      float cfforce[3], defforce[3] = {0.0f, 0.0f, 0.0f}, vel[3] = {0.0f, 0.0f, 0.0f},
+                        facenormal[3], cf = 1.0f, intrusion;
+      float kd = 1.0f;
+
+      if (sb_deflect_face(ob, bp->pos, facenormal, defforce, &cf, timenow, vel, &intrusion)) {
+        if (intrusion < 0.0f) {
+          accum->do_fuzzy = true;
+          bp->loc_flag |= SBF_DOFUZZY;
+          bp->choke = sb->choke * 0.01f;
         }
+
+        sub_v3_v3v3(cfforce, bp->vec, vel);
+        madd_v3_v3fl(bp->force, cfforce, -cf * 50.0f);
+
+        madd_v3_v3fl(bp->force, defforce, kd);
       }
-      /* ---cached collision targets */
-
-      /* +++springs */
-      iks = 1.0f / (1.0f - sb->inspring) - 1.0f; /* inner spring constants function */
-      if (ob->softflag & OB_SB_EDGES) {
-        if (sb->bspring) { /* Spring list exists at all? */
-          int b;
-          BodySpring *bs;
-          for (b = bp->nofsprings; b > 0; b--) {
-            bs = sb->bspring + bp->springs[b - 1];
-            if (do_springcollision || do_aero) {
-              add_v3_v3(bp->force, bs->ext_force);
-              if (bs->flag & BSF_INTERSECT) {
-                bp->choke = bs->cf;
-              }
+    }
+    /* ---cached collision targets */
+
+    /* +++springs */
+    iks = 1.0f / (1.0f - sb->inspring) - 1.0f; /* inner spring constants function */
+    if (ob->softflag & OB_SB_EDGES) {
+      if (sb->bspring) { /* Spring list exists at all? */
+        int b;
+        BodySpring *bs;
+        for (b = bp->nofsprings; b > 0; b--) {
+          bs = sb->bspring + bp->springs[b - 1];
+          if (do_springcollision || do_aero) {
+            add_v3_v3(bp->force, bs->ext_force);
+            if (bs->flag & BSF_INTERSECT) {
+              bp->choke = bs->cf;
             }
-            // sb_spring_force(Object *ob, int bpi, BodySpring *bs, float iks, float forcetime)
-            sb_spring_force(ob, ilast - bb, bs, iks, forcetime);
-          } /* loop springs. */
-        }   /* existing spring list. */
-      }     /* Any edges. */
-      /* ---springs */
-    }       /* Omit on snap. */
-  }         /* Loop all bp's. */
-  return 0; /* Done fine. */
-}
-
-static void *exec_softbody_calc_forces(void *data)
-{
-  SB_thread_context *pctx = (SB_thread_context *)data;
-  _softbody_calc_forces_slice_in_a_thread(pctx->scene,
-                                          pctx->ob,
-                                          pctx->forcetime,
-                                          pctx->timenow,
-                                          pctx->ifirst,
-                                          pctx->ilast,
-                                          NULL,
-                                          pctx->effectors,
-                                          pctx->do_deflector,
-                                          pctx->fieldfactor,
-                                          pctx->windfactor);
-  return NULL;
+          }
+          // sb_spring_force(Object *ob, int bpi, BodySpring *bs, float iks, float forcetime)
+          sb_spring_force(ob, index, bs, iks, forcetime);
+        } /* loop springs. */
+      }   /* existing spring list. */
+    }     /* Any edges. */
+    /* ---springs */
+  }       /* Omit on snap. */
+}
+
+static void softbody_calc_forces_reduce(const void *__restrict UNUSED(userdata),
+                                        void *__restrict chunk_join,
+                                        void *__restrict chunk)
+{
+  SB_thread_accum *join = chunk_join;
+  const SB_thread_accum *accum = chunk;
+  join->do_fuzzy |= accum->do_fuzzy;
 }
 
 static void sb_cf_threads_run(Scene *scene,
@@ -2210,62 +2165,36 @@ static void sb_cf_threads_run(Scene *scene,
                               float fieldfactor,
                               float windfactor)
 {
-  ListBase threads;
-  SB_thread_context *sb_threads;
-  int i, totthread, left, dec;
-
-  /* wild guess .. may increase with better thread management 'above'
-   * or even be UI option sb->spawn_cf_threads_nopts. */
-  int lowpoints = 100;
-
-  /* figure the number of threads while preventing pretty pointless threading overhead */
-  totthread = BKE_scene_num_threads(scene);
-  /* What if we got zillions of CPUs running but less to spread. */
-  while ((totpoint / totthread < lowpoints) && (totthread > 1)) {
-    totthread--;
-  }
-
-  /* printf("sb_cf_threads_run spawning %d threads\n", totthread); */
-
-  sb_threads = MEM_callocN(sizeof(SB_thread_context) * totthread, "SBThread");
-  memset(sb_threads, 0, sizeof(SB_thread_context) * totthread);
-  left = totpoint;
-  dec = totpoint / totthread + 1;
-  for (i = 0; i < totthread; i++) {
-    sb_threads[i].scene = scene;
-    sb_threads[i].ob = ob;
-    sb_threads[i].forcetime = forcetime;
-    sb_threads[i].timenow = timenow;
-    sb_threads[i].ilast = left;
-    left = left - dec;
-    if (left > 0) {
-      sb_threads[i].ifirst = left;
-    }
-    else {
-      sb_threads[i].ifirst = 0;
-    }
-    sb_threads[i].effectors = effectors;
-    sb_threads[i].do_deflector = do_deflector;
-    sb_threads[i].fieldfactor = fieldfactor;
-    sb_threads[i].windfactor = windfactor;
-    sb_threads[i].nr = i;
-    sb_threads[i].tot = totthread;
-  }
-
-  if (totthread > 1) {
-    BLI_threadpool_init(&threads, exec_softbody_calc_forces, totthread);
-
-    for (i = 0; i < totthread; i++) {
-      BLI_threadpool_insert(&threads, &sb_threads[i]);
-    }
+  SoftBody *sb = ob->soft;
 
-    BLI_threadpool_end(&threads);
-  }
-  else {
-    exec_softbody_calc_forces(&sb_threads[0]);
+  SB_thread_context ctx = {
+      .scene = scene,
+      .ob = ob,
+      .forcetime = forcetime,
+      .timenow = timenow,
+      .effectors = effectors,
+      .do_deflector = do_deflector,
+      .fieldfactor = fieldfactor,
+      .windfactor = windfactor,
+      .do_selfcollision = ((ob->softflag & OB_SB_EDGES) && (sb->bspring) &&
+                           (ob->softflag & OB_SB_SELF)),
+      .do_springcollision = do_deflector && (ob->softflag & OB_SB_EDGES) &&
+                            (ob->softflag & OB_SB_EDGECOLL),
+      .do_aero = ((sb->aeroedge) && (ob->softflag & OB_SB_EDGES)),
+  };
+  SB_thread_accum accum = {false};
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = SB_MIN_ITER_PER_THREAD;
+  settings.userdata_chunk = &accum;
+  settings.userdata_chunk_size = sizeof(accum);
+  settings.func_reduce = softbody_calc_forces_reduce;
+  BLI_task_parallel_range(0, totpoint, &ctx, softbody_calc_forces_cb, &settings);
+
+  if (accum.do_fuzzy) {
+    sb->scratch->flag |= SBF_DOFUZZY;
   }
-  /* clean up */
-  MEM_freeN(sb_threads);
 }
 
 static void softbody_calc_forces(
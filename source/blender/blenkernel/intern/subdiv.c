@@ -29,6 +29,9 @@
 
 #include "BLI_utildefines.h"
 
+#include "BKE_subdiv_eval.h"
+#include "BKE_subdiv_mesh.h"
+
 #include "MEM_guardedalloc.h"
 
 #include "subdiv_converter.h"
@@ -195,6 +198,10 @@ void BKE_subdiv_free(Subdiv *subdiv)
     openSubdiv_deleteTopologyRefiner(subdiv->topology_refiner);
   }
   BKE_subdiv_displacement_detach(subdiv);
+  BKE_subdiv_mesh_topology_cache_free(subdiv);
+  if (subdiv->cache_.ccg_limit_stencils != NULL) {
+    BKE_subdiv_eval_limit_stencils_free(subdiv->cache_.ccg_limit_stencils);
+  }
   if (subdiv->cache_.face_ptex_offset != NULL) {
     MEM_freeN(subdiv->cache_.face_ptex_offset);
   }
@@ -40,6 +40,7 @@
 #include "BKE_subdiv.h"
 #include "BKE_subdiv_eval.h"
 
+#include "opensubdiv_capi_type.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
 /* -------------------------------------------------------------------- */
@@ -181,17 +182,69 @@ typedef struct CCGEvalGridsData {
   int *face_ptex_offset;
   SubdivCCGMaskEvaluator *mask_evaluator;
   SubdivCCGMaterialFlagsEvaluator *material_flags_evaluator;
+  /* Limit points and derivatives of all grid elements, evaluated in a batch from limit stencils.
+   * NULL when elements are evaluated one by one. */
+  float (*limit_P)[3];
+  float (*limit_dPdu)[3];
+  float (*limit_dPdv)[3];
 } CCGEvalGridsData;
 
+/* Ptex face and coordinate of the grid element at (x, y) of the given face corner grid. */
+static void subdiv_ccg_grid_element_ptex_coord(const SubdivCCG *subdiv_ccg,
+                                               const int *face_ptex_offset,
+                                               const int face_index,
+                                               const int corner,
+                                               const int x,
+                                               const int y,
+                                               int *r_ptex_face_index,
+                                               float *r_u,
+                                               float *r_v)
+{
+  const float grid_size_1_inv = 1.0f / (subdiv_ccg->grid_size - 1);
+  const SubdivCCGFace *face = &subdiv_ccg->faces[face_index];
+  if (face->num_grids == 4) {
+    const float grid_u = x * grid_size_1_inv;
+    const float grid_v = y * grid_size_1_inv;
+    *r_ptex_face_index = face_ptex_offset[face_index];
+    BKE_subdiv_rotate_grid_to_quad(corner, grid_u, grid_v, r_u, r_v);
+  }
+  else {
+    *r_ptex_face_index = face_ptex_offset[face_index] + corner;
+    *r_u = 1.0f - (y * grid_size_1_inv);
+    *r_v = 1.0f - (x * grid_size_1_inv);
+  }
+}
+
 static void subdiv_ccg_eval_grid_element_limit(CCGEvalGridsData *data,
                                                const int ptex_face_index,
                                                const float u,
                                                const float v,
+                                               const size_t element_index,
                                                unsigned char *element)
 {
   Subdiv *subdiv = data->subdiv;
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
-  if (subdiv->displacement_evaluator != NULL) {
+  if (data->limit_P != NULL) {
+    float *P = (float *)element;
+    copy_v3_v3(P, data->limit_P[element_index]);
+    if (subdiv->displacement_evaluator != NULL) {
+      float D[3];
+      BKE_subdiv_eval_displacement(subdiv,
+                                   ptex_face_index,
+                                   u,
+                                   v,
+                                   data->limit_dPdu[element_index],
+                                   data->limit_dPdv[element_index],
+                                   D);
+      add_v3_v3(P, D);
+    }
+    else if (subdiv_ccg->has_normal) {
+      float *N = (float *)(element + subdiv_ccg->normal_offset);
+      cross_v3_v3v3(N, data->limit_dPdu[element_index], data->limit_dPdv[element_index]);
+      normalize_v3(N);
+    }
+  }
+  else if (subdiv->displacement_evaluator != NULL) {
     BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, (float *)element);
   }
   else if (subdiv_ccg->has_normal) {
@@ -230,18 +283,21 @@ static void subdiv_ccg_eval_grid_element(CCGEvalGridsData *data,
                                          const int ptex_face_index,
                                          const float u,
                                          const float v,
+                                         const size_t element_index,
                                          unsigned char *element)
 {
-  subdiv_ccg_eval_grid_element_limit(data, ptex_face_index, u, v, element);
+  subdiv_ccg_eval_grid_element_limit(data, ptex_face_index, u, v, element_index, element);
   subdiv_ccg_eval_grid_element_mask(data, ptex_face_index, u, v, element);
 }
 
-static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_index)
+static void subdiv_ccg_eval_grids_task(void *__restrict userdata_v,
+                                       const int face_index,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
 {
+  CCGEvalGridsData *data = userdata_v;
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
-  const int ptex_face_index = data->face_ptex_offset[face_index];
   const int grid_size = subdiv_ccg->grid_size;
-  const float grid_size_1_inv = 1.0f / (grid_size - 1);
+  const size_t grid_area = (size_t)grid_size * grid_size;
   const int element_size = element_size_bytes_get(subdiv_ccg);
   SubdivCCGFace *faces = subdiv_ccg->faces;
   SubdivCCGFace **grid_faces = subdiv_ccg->grid_faces;
@@ -250,14 +306,19 @@ static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_
     const int grid_index = face->start_grid_index + corner;
     unsigned char *grid = (unsigned char *)subdiv_ccg->grids[grid_index];
     for (int y = 0; y < grid_size; y++) {
-      const float grid_v = y * grid_size_1_inv;
       for (int x = 0; x < grid_size; x++) {
-        const float grid_u = x * grid_size_1_inv;
+        int ptex_face_index;
         float u, v;
-        BKE_subdiv_rotate_grid_to_quad(corner, grid_u, grid_v, &u, &v);
+        subdiv_ccg_grid_element_ptex_coord(
+            subdiv_ccg, data->face_ptex_offset, face_index, corner, x, y, &ptex_face_index, &u, &v);
         const size_t grid_element_index = (size_t)y * grid_size + x;
         const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(data, ptex_face_index, u, v, &grid[grid_element_offset]);
+        subdiv_ccg_eval_grid_element(data,
+                                     ptex_face_index,
+                                     u,
+                                     v,
+                                     grid_index * grid_area + grid_element_index,
+                                     &grid[grid_element_offset]);
       }
     }
     /* Assign grid's face. */
@@ -268,49 +329,88 @@ static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_
   }
 }
 
-static void subdiv_ccg_eval_special_grid(CCGEvalGridsData *data, const int face_index)
+/* Estimated number of control vertices a single limit stencil depends on. Regular patches have 16
+ * of them, patches around extraordinary vertices have more. */
+#define SUBDIV_CCG_LIMIT_STENCIL_WIDTH 20
+/* Limit stencils are kept for as long as the topology does not change, so their memory is
+ * bounded. Above this budget grid elements are evaluated one by one. */
+#define SUBDIV_CCG_LIMIT_STENCILS_MAX_BYTES ((size_t)256 * 1024 * 1024)
+
+/* Estimated memory used by limit stencils of the given number of grid elements: index and weights
+ * of position and both derivatives for every control vertex, stencil size and offset, patch
+ * coordinate, and the evaluated limit position and derivatives. */
+static size_t subdiv_ccg_limit_stencils_estimate_bytes(const size_t num_elements)
+{
+  const size_t stencil_bytes = SUBDIV_CCG_LIMIT_STENCIL_WIDTH *
+                                   (sizeof(int) + 3 * sizeof(float)) +
+                               2 * sizeof(int);
+  const size_t element_bytes = stencil_bytes + sizeof(OpenSubdiv_PatchCoord) +
+                               3 * sizeof(float[3]);
+  return num_elements * element_bytes;
+}
+
+/* Limit stencils for all grid elements, in the order of grids and their elements. */
+static struct SubdivLimitStencils *subdiv_ccg_limit_stencils_create(
+    const SubdivCCG *subdiv_ccg, Subdiv *subdiv, const int *face_ptex_offset)
 {
-  SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   const int grid_size = subdiv_ccg->grid_size;
-  const float grid_size_1_inv = 1.0f / (grid_size - 1);
-  const int element_size = element_size_bytes_get(subdiv_ccg);
-  SubdivCCGFace *faces = subdiv_ccg->faces;
-  SubdivCCGFace **grid_faces = subdiv_ccg->grid_faces;
-  const SubdivCCGFace *face = &faces[face_index];
-  for (int corner = 0; corner < face->num_grids; corner++) {
-    const int grid_index = face->start_grid_index + corner;
-    const int ptex_face_index = data->face_ptex_offset[face_index] + corner;
-    unsigned char *grid = (unsigned char *)subdiv_ccg->grids[grid_index];
-    for (int y = 0; y < grid_size; y++) {
-      const float u = 1.0f - (y * grid_size_1_inv);
-      for (int x = 0; x < grid_size; x++) {
-        const float v = 1.0f - (x * grid_size_1_inv);
-        const size_t grid_element_index = (size_t)y * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(data, ptex_face_index, u, v, &grid[grid_element_offset]);
+  const size_t grid_area = (size_t)grid_size * grid_size;
+  const size_t num_elements = subdiv_ccg->num_grids * grid_area;
+  if (num_elements == 0 || num_elements > INT_MAX) {
+    return NULL;
+  }
+  if (subdiv_ccg_limit_stencils_estimate_bytes(num_elements) >
+      SUBDIV_CCG_LIMIT_STENCILS_MAX_BYTES) {
+    return NULL;
+  }
+  OpenSubdiv_PatchCoord *patch_coords = MEM_malloc_arrayN(
+      num_elements, sizeof(OpenSubdiv_PatchCoord), "ccg limit stencils patch coords");
+  for (int face_index = 0; face_index < subdiv_ccg->num_faces; face_index++) {
+    const SubdivCCGFace *face = &subdiv_ccg->faces[face_index];
+    for (int corner = 0; corner < face->num_grids; corner++) {
+      const int grid_index = face->start_grid_index + corner;
+      OpenSubdiv_PatchCoord *grid_patch_coords = &patch_coords[grid_index * grid_area];
+      for (int y = 0; y < grid_size; y++) {
+        for (int x = 0; x < grid_size; x++) {
+          OpenSubdiv_PatchCoord *patch_coord = &grid_patch_coords[y * grid_size + x];
+          subdiv_ccg_grid_element_ptex_coord(subdiv_ccg,
+                                             face_ptex_offset,
+                                             face_index,
+                                             corner,
+                                             x,
+                                             y,
+                                             &patch_coord->ptex_face,
+                                             &patch_coord->u,
+                                             &patch_coord->v);
+        }
       }
     }
-    /* Assign grid's face. */
-    grid_faces[grid_index] = &faces[face_index];
-    /* Assign material flags. */
-    subdiv_ccg->grid_flag_mats[grid_index] = data->material_flags_evaluator->eval_material_flags(
-        data->material_flags_evaluator, face_index);
   }
+  return BKE_subdiv_eval_limit_stencils_create(subdiv, patch_coords, (int)num_elements);
 }
 
-static void subdiv_ccg_eval_grids_task(void *__restrict userdata_v,
-                                       const int face_index,
-                                       const TaskParallelTLS *__restrict UNUSED(tls))
+/* Get limit stencils for the grids of the given CCG, when it's worth creating them: the same
+ * topology and grid size is evaluated for the second time, which happens on animated coarse
+ * meshes. Returns NULL when elements are to be evaluated one by one, which is also the case when
+ * the stencils do not fit into the memory budget. */
+static const struct SubdivLimitStencils *subdiv_ccg_limit_stencils_ensure(
+    const SubdivCCG *subdiv_ccg, Subdiv *subdiv, const int *face_ptex_offset)
 {
-  CCGEvalGridsData *data = userdata_v;
-  SubdivCCG *subdiv_ccg = data->subdiv_ccg;
-  SubdivCCGFace *face = &subdiv_ccg->faces[face_index];
-  if (face->num_grids == 4) {
-    subdiv_ccg_eval_regular_grid(data, face_index);
+  if (subdiv->cache_.ccg_limit_stencils_grid_size != subdiv_ccg->grid_size) {
+    if (subdiv->cache_.ccg_limit_stencils != NULL) {
+      BKE_subdiv_eval_limit_stencils_free(subdiv->cache_.ccg_limit_stencils);
+      subdiv->cache_.ccg_limit_stencils = NULL;
+    }
+    subdiv->cache_.ccg_limit_stencils_grid_size = subdiv_ccg->grid_size;
+    subdiv->cache_.ccg_num_evaluations = 0;
   }
-  else {
-    subdiv_ccg_eval_special_grid(data, face_index);
+  subdiv->cache_.ccg_num_evaluations++;
+  /* Only try once, creation might fail for the topology. */
+  if (subdiv->cache_.ccg_num_evaluations == 2) {
+    subdiv->cache_.ccg_limit_stencils = subdiv_ccg_limit_stencils_create(
+        subdiv_ccg, subdiv, face_ptex_offset);
   }
+  return subdiv->cache_.ccg_limit_stencils;
 }
 
 static bool subdiv_ccg_evaluate_grids(SubdivCCG *subdiv_ccg,
@@ -321,17 +421,36 @@ static bool subdiv_ccg_evaluate_grids(SubdivCCG *subdiv_ccg,
   OpenSubdiv_TopologyRefiner *topology_refiner = subdiv->topology_refiner;
   const int num_faces = topology_refiner->getNumFaces(topology_refiner);
   /* Initialize data passed to all the tasks. */
-  CCGEvalGridsData data;
+  CCGEvalGridsData data = {NULL};
   data.subdiv_ccg = subdiv_ccg;
   data.subdiv = subdiv;
   data.face_ptex_offset = BKE_subdiv_face_ptex_offset_get(subdiv);
   data.mask_evaluator = mask_evaluator;
   data.material_flags_evaluator = material_flags_evaluator;
+  /* Batched evaluation of limit surface for all grid elements. */
+  const struct SubdivLimitStencils *limit_stencils = subdiv_ccg_limit_stencils_ensure(
+      subdiv_ccg, subdiv, data.face_ptex_offset);
+  if (limit_stencils != NULL) {
+    const size_t num_elements = (size_t)subdiv_ccg->num_grids * subdiv_ccg->grid_size *
+                                subdiv_ccg->grid_size;
+    const bool need_derivatives = (subdiv->displacement_evaluator != NULL) ||
+                                  subdiv_ccg->has_normal;
+    data.limit_P = MEM_malloc_arrayN(num_elements, sizeof(float[3]), "ccg limit P");
+    if (need_derivatives) {
+      data.limit_dPdu = MEM_malloc_arrayN(num_elements, sizeof(float[3]), "ccg limit dPdu");
+      data.limit_dPdv = MEM_malloc_arrayN(num_elements, sizeof(float[3]), "ccg limit dPdv");
+    }
+    BKE_subdiv_eval_limit_stencils(
+        subdiv, limit_stencils, data.limit_P, data.limit_dPdu, data.limit_dPdv);
+  }
   /* Threaded grids evaluation. */
   TaskParallelSettings parallel_range_settings;
   BLI_parallel_range_settings_defaults(&parallel_range_settings);
   BLI_task_parallel_range(
       0, num_faces, &data, subdiv_ccg_eval_grids_task, &parallel_range_settings);
+  MEM_SAFE_FREE(data.limit_P);
+  MEM_SAFE_FREE(data.limit_dPdu);
+  MEM_SAFE_FREE(data.limit_dPdv);
   /* If displacement is used, need to calculate normals after all final
    * coordinates are known. */
   if (subdiv->displacement_evaluator != NULL) {
@@ -27,7 +27,9 @@
 #include "DNA_meshdata_types.h"
 
 #include "BLI_bitmap.h"
+#include "BLI_math_base.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_customdata.h"
@@ -35,6 +37,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "opensubdiv_capi_type.h"
 #include "opensubdiv_evaluator_capi.h"
 #include "opensubdiv_topology_refiner_capi.h"
 
@@ -395,3 +398,112 @@ void BKE_subdiv_eval_limit_patch_resolution_point_and_short_normal(Subdiv *subdi
     }
   }
 }
+
+/* ============================= Limit stencils ============================= */
+
+typedef struct SubdivLimitStencils {
+  struct OpenSubdiv_LimitStencils *stencils;
+  /* Coordinates the stencils are created for, used for points with degenerate derivatives. */
+  OpenSubdiv_PatchCoord *patch_coords;
+  int num_patch_coords;
+} SubdivLimitStencils;
+
+/* Number of coordinates evaluated by a single task. */
+#define LIMIT_STENCILS_CHUNK_SIZE 1024
+
+SubdivLimitStencils *BKE_subdiv_eval_limit_stencils_create(Subdiv *subdiv,
+                                                           OpenSubdiv_PatchCoord *patch_coords,
+                                                           const int num_patch_coords)
+{
+  BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_LIMIT_STENCILS_CREATE);
+  struct OpenSubdiv_LimitStencils *stencils = openSubdiv_createLimitStencils(
+      subdiv->topology_refiner, patch_coords, num_patch_coords);
+  BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_LIMIT_STENCILS_CREATE);
+  if (stencils == NULL) {
+    MEM_freeN(patch_coords);
+    return NULL;
+  }
+  SubdivLimitStencils *limit_stencils = MEM_mallocN(sizeof(SubdivLimitStencils),
+                                                    "subdiv limit stencils");
+  limit_stencils->stencils = stencils;
+  limit_stencils->patch_coords = patch_coords;
+  limit_stencils->num_patch_coords = num_patch_coords;
+  return limit_stencils;
+}
+
+void BKE_subdiv_eval_limit_stencils_free(SubdivLimitStencils *limit_stencils)
+{
+  openSubdiv_deleteLimitStencils(limit_stencils->stencils);
+  MEM_freeN(limit_stencils->patch_coords);
+  MEM_freeN(limit_stencils);
+}
+
+typedef struct LimitStencilsEvalData {
+  Subdiv *subdiv;
+  const SubdivLimitStencils *limit_stencils;
+  float (*P)[3];
+  float (*dPdu)[3];
+  float (*dPdv)[3];
+} LimitStencilsEvalData;
+
+static void subdiv_eval_limit_stencils_task(void *__restrict userdata,
+                                            const int chunk_index,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  LimitStencilsEvalData *data = userdata;
+  Subdiv *subdiv = data->subdiv;
+  const SubdivLimitStencils *limit_stencils = data->limit_stencils;
+  const int start = chunk_index * LIMIT_STENCILS_CHUNK_SIZE;
+  const int num = min_ii(LIMIT_STENCILS_CHUNK_SIZE, limit_stencils->num_patch_coords - start);
+  const bool do_derivatives = (data->dPdu != NULL);
+  subdiv->evaluator->evaluateLimitStencils(subdiv->evaluator,
+                                           limit_stencils->stencils,
+                                           start,
+                                           num,
+                                           data->P[start],
+                                           do_derivatives ? data->dPdu[start] : NULL,
+                                           do_derivatives ? data->dPdv[start] : NULL);
+  if (!do_derivatives) {
+    return;
+  }
+  /* Stencils have no knowledge of coarse positions, so degenerate derivatives are handled the
+   * same way as #BKE_subdiv_eval_limit_point_and_derivatives does, for those points only. */
+  for (int i = start; i < start + num; i++) {
+    if (is_zero_v3(data->dPdu[i]) || is_zero_v3(data->dPdv[i]) ||
+        equals_v3v3(data->dPdu[i], data->dPdv[i])) {
+      const OpenSubdiv_PatchCoord *patch_coord = &limit_stencils->patch_coords[i];
+      BKE_subdiv_eval_limit_point_and_derivatives(subdiv,
+                                                  patch_coord->ptex_face,
+                                                  patch_coord->u,
+                                                  patch_coord->v,
+                                                  data->P[i],
+                                                  data->dPdu[i],
+                                                  data->dPdv[i]);
+    }
+  }
+}
+
+void BKE_subdiv_eval_limit_stencils(Subdiv *subdiv,
+                                    const SubdivLimitStencils *limit_stencils,
+                                    float (*r_P)[3],
+                                    float (*r_dPdu)[3],
+                                    float (*r_dPdv)[3])
+{
+  BLI_assert((r_dPdu == NULL) == (r_dPdv == NULL));
+  BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_LIMIT_STENCILS_EVALUATE);
+  LimitStencilsEvalData data = {
+      .subdiv = subdiv,
+      .limit_stencils = limit_stencils,
+      .P = r_P,
+      .dPdu = r_dPdu,
+      .dPdv = r_dPdv,
+  };
+  const int num_chunks = (limit_stencils->num_patch_coords + LIMIT_STENCILS_CHUNK_SIZE - 1) /
+                         LIMIT_STENCILS_CHUNK_SIZE;
+  TaskParallelSettings parallel_range_settings;
+  BLI_parallel_range_settings_defaults(&parallel_range_settings);
+  parallel_range_settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0, num_chunks, &data, subdiv_eval_limit_stencils_task, &parallel_range_settings);
+  BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_LIMIT_STENCILS_EVALUATE);
+}
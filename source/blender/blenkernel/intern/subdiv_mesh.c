@@ -31,6 +31,8 @@
 
 #include "BLI_alloca.h"
 #include "BLI_math_vector.h"
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
 
 #include "BKE_customdata.h"
 #include "BKE_key.h"
@@ -76,6 +78,12 @@ typedef struct SubdivMeshContext {
    * when it's not possible is when displacement is used. */
   bool can_evaluate_normals;
   bool have_displacement;
+  /* When edges, loops and polygons come from the topology cache, these reference the result
+   * layers which are not cached, see #subdiv_mesh_topology_info_from_cache. */
+  bool use_topology_cache;
+  CustomData edata_dst;
+  CustomData ldata_dst;
+  CustomData pdata_dst;
 } SubdivMeshContext;
 
 static void subdiv_mesh_ctx_cache_uv_layers(SubdivMeshContext *ctx)
@@ -117,6 +125,11 @@ static void subdiv_mesh_context_free(SubdivMeshContext *ctx)
 {
   MEM_SAFE_FREE(ctx->accumulated_normals);
   MEM_SAFE_FREE(ctx->accumulated_counters);
+  if (ctx->use_topology_cache) {
+    CustomData_free(&ctx->edata_dst, 0);
+    CustomData_free(&ctx->ldata_dst, 0);
+    CustomData_free(&ctx->pdata_dst, 0);
+  }
 }
 
 /** \} */
@@ -854,7 +867,7 @@ static void subdiv_mesh_edge(const SubdivForeachContext *foreach_context,
 /** \name Loops creation/interpolation
  * \{ */
 
-static void subdiv_interpolate_loop_data(const SubdivMeshContext *ctx,
+static void subdiv_interpolate_loop_data(SubdivMeshContext *ctx,
                                          MLoop *subdiv_loop,
                                          const LoopsForInterpolation *loop_interpolation,
                                          const float u,
@@ -863,7 +876,7 @@ static void subdiv_interpolate_loop_data(const SubdivMeshContext *ctx,
   const int subdiv_loop_index = subdiv_loop - ctx->subdiv_mesh->mloop;
   const float weights[4] = {(1.0f - u) * (1.0f - v), u * (1.0f - v), u * v, (1.0f - u) * v};
   CustomData_interp(loop_interpolation->loop_data,
-                    &ctx->subdiv_mesh->ldata,
+                    ctx->use_topology_cache ? &ctx->ldata_dst : &ctx->subdiv_mesh->ldata,
                     loop_interpolation->loop_indices,
                     weights,
                     NULL,
@@ -1156,16 +1169,367 @@ static void subdiv_mesh_vertex_of_loose_edge(const struct SubdivForeachContext *
 
 /** \} */
 
+/* -------------------------------------------------------------------- */
+/** \name Topology cache
+ *
+ * For an animated coarse mesh only vertex positions change between evaluations, so the edges,
+ * loops and polygons of the subdivided mesh are the same every time. They are copied from the
+ * cache, so only vertices and the remaining edge, loop and polygon layers (UV maps, colors,
+ * attributes) are evaluated.
+ *
+ * The result is only stored after two consecutive evaluations with the same coarse topology, so
+ * meshes which change their topology every evaluation don't store a subdivided copy of it.
+ * \{ */
+
+/* Layers of the subdivided mesh that only depend on the coarse topology and settings. */
+#define SUBDIV_MESH_TOPOLOGY_CD_MASK \
+  (CD_MASK_MEDGE | CD_MASK_MLOOP | CD_MASK_MPOLY | CD_MASK_ORIGINDEX)
+
+typedef struct SubdivMeshLayerLayout {
+  int type;
+  char name[MAX_CUSTOMDATA_LAYER_NAME];
+} SubdivMeshLayerLayout;
+
+typedef struct SubdivMeshTopologyCache {
+  /* Settings the cached result was created with. */
+  int resolution;
+  bool use_optimal_display;
+  /* Topology of the coarse mesh the cache was created for. */
+  int coarse_totvert;
+  int coarse_totedge;
+  int coarse_totloop;
+  int coarse_totpoly;
+  CustomData coarse_edata;
+  CustomData coarse_ldata;
+  CustomData coarse_pdata;
+  /* Layers of the coarse edges, loops and polygons, the result has the same layers. */
+  SubdivMeshLayerLayout *coarse_layout;
+  int coarse_layout_len;
+  /* Topology layers of the edges, loops and polygons of the result. */
+  bool has_result;
+  int num_vertices;
+  int num_edges;
+  int num_loops;
+  int num_polygons;
+  CustomData edata;
+  CustomData ldata;
+  CustomData pdata;
+} SubdivMeshTopologyCache;
+
+static bool custom_data_layer_is_topology(const CustomDataLayer *layer)
+{
+  return (CD_TYPE_AS_MASK(layer->type) & SUBDIV_MESH_TOPOLOGY_CD_MASK) &&
+         !(layer->flag & CD_FLAG_NOCOPY);
+}
+
+/* Whether there are layers to copy or interpolate besides the cached topology layers. */
+static bool custom_data_has_non_topology_layers(const CustomData *data)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if (!custom_data_layer_is_topology(layer) && !(layer->flag & CD_FLAG_NOCOPY)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Compare the topology layers of \a data with the ones copied into \a data_cached. */
+static bool custom_data_topology_equals(const CustomData *data_cached,
+                                        const CustomData *data,
+                                        int totelem)
+{
+  int index = 0;
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if (!custom_data_layer_is_topology(layer)) {
+      continue;
+    }
+    if (index == data_cached->totlayer) {
+      return false;
+    }
+    const CustomDataLayer *layer_cached = &data_cached->layers[index++];
+    if (layer_cached->type != layer->type) {
+      return false;
+    }
+    if (totelem == 0 || layer_cached->data == layer->data) {
+      continue;
+    }
+    if (layer_cached->data == NULL || layer->data == NULL ||
+        memcmp(layer_cached->data, layer->data, (size_t)CustomData_sizeof(layer->type) * totelem)) {
+      return false;
+    }
+  }
+  return index == data_cached->totlayer;
+}
+
+static int custom_data_layout_len(const CustomData *data)
+{
+  int len = 0;
+  for (int i = 0; i < data->totlayer; i++) {
+    if (!(data->layers[i].flag & CD_FLAG_NOCOPY)) {
+      len++;
+    }
+  }
+  return len;
+}
+
+static SubdivMeshLayerLayout *custom_data_layout_fill(SubdivMeshLayerLayout *layout,
+                                                      const CustomData *data)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if (!(layer->flag & CD_FLAG_NOCOPY)) {
+      layout->type = layer->type;
+      STRNCPY(layout->name, layer->name);
+      layout++;
+    }
+  }
+  return layout;
+}
+
+static const SubdivMeshLayerLayout *custom_data_layout_match(const SubdivMeshLayerLayout *layout,
+                                                             const SubdivMeshLayerLayout *end,
+                                                             const CustomData *data)
+{
+  for (int i = 0; i < data->totlayer; i++) {
+    const CustomDataLayer *layer = &data->layers[i];
+    if (layer->flag & CD_FLAG_NOCOPY) {
+      continue;
+    }
+    if (layout == end || layout->type != layer->type || !STREQ(layout->name, layer->name)) {
+      return NULL;
+    }
+    layout++;
+  }
+  return layout;
+}
+
+static bool subdiv_mesh_topology_cache_layout_matches(const SubdivMeshTopologyCache *cache,
+                                                      const Mesh *coarse_mesh)
+{
+  const SubdivMeshLayerLayout *layout = cache->coarse_layout;
+  const SubdivMeshLayerLayout *end = layout + cache->coarse_layout_len;
+  layout = custom_data_layout_match(layout, end, &coarse_mesh->edata);
+  if (layout != NULL) {
+    layout = custom_data_layout_match(layout, end, &coarse_mesh->ldata);
+  }
+  if (layout != NULL) {
+    layout = custom_data_layout_match(layout, end, &coarse_mesh->pdata);
+  }
+  return layout == end;
+}
+
+static void subdiv_mesh_topology_cache_free_result(SubdivMeshTopologyCache *cache)
+{
+  if (cache->has_result) {
+    CustomData_free(&cache->edata, cache->num_edges);
+    CustomData_free(&cache->ldata, cache->num_loops);
+    CustomData_free(&cache->pdata, cache->num_polygons);
+    cache->has_result = false;
+  }
+}
+
+void BKE_subdiv_mesh_topology_cache_free(Subdiv *subdiv)
+{
+  SubdivMeshTopologyCache *cache = subdiv->cache_.mesh_topology;
+  if (cache == NULL) {
+    return;
+  }
+  subdiv_mesh_topology_cache_free_result(cache);
+  CustomData_free(&cache->coarse_edata, cache->coarse_totedge);
+  CustomData_free(&cache->coarse_ldata, cache->coarse_totloop);
+  CustomData_free(&cache->coarse_pdata, cache->coarse_totpoly);
+  MEM_SAFE_FREE(cache->coarse_layout);
+  MEM_freeN(cache);
+  subdiv->cache_.mesh_topology = NULL;
+}
+
+static bool subdiv_mesh_topology_cache_matches(const SubdivMeshTopologyCache *cache,
+                                               const SubdivToMeshSettings *settings,
+                                               const Mesh *coarse_mesh)
+{
+  return cache->resolution == settings->resolution &&
+         cache->use_optimal_display == settings->use_optimal_display &&
+         cache->coarse_totvert == coarse_mesh->totvert &&
+         cache->coarse_totedge == coarse_mesh->totedge &&
+         cache->coarse_totloop == coarse_mesh->totloop &&
+         cache->coarse_totpoly == coarse_mesh->totpoly &&
+         subdiv_mesh_topology_cache_layout_matches(cache, coarse_mesh) &&
+         custom_data_topology_equals(
+             &cache->coarse_edata, &coarse_mesh->edata, coarse_mesh->totedge) &&
+         custom_data_topology_equals(
+             &cache->coarse_ldata, &coarse_mesh->ldata, coarse_mesh->totloop) &&
+         custom_data_topology_equals(
+             &cache->coarse_pdata, &coarse_mesh->pdata, coarse_mesh->totpoly);
+}
+
+/* Start over with a cache for the given coarse mesh, without any result stored yet. */
+static void subdiv_mesh_topology_cache_reset(Subdiv *subdiv,
+                                             const SubdivToMeshSettings *settings,
+                                             const Mesh *coarse_mesh)
+{
+  BKE_subdiv_mesh_topology_cache_free(subdiv);
+  SubdivMeshTopologyCache *cache = MEM_callocN(sizeof(*cache), "subdiv mesh topology cache");
+  cache->resolution = settings->resolution;
+  cache->use_optimal_display = settings->use_optimal_display;
+  cache->coarse_totvert = coarse_mesh->totvert;
+  cache->coarse_totedge = coarse_mesh->totedge;
+  cache->coarse_totloop = coarse_mesh->totloop;
+  cache->coarse_totpoly = coarse_mesh->totpoly;
+  CustomData_copy(&coarse_mesh->edata,
+                  &cache->coarse_edata,
+                  SUBDIV_MESH_TOPOLOGY_CD_MASK,
+                  CD_DUPLICATE,
+                  coarse_mesh->totedge);
+  CustomData_copy(&coarse_mesh->ldata,
+                  &cache->coarse_ldata,
+                  SUBDIV_MESH_TOPOLOGY_CD_MASK,
+                  CD_DUPLICATE,
+                  coarse_mesh->totloop);
+  CustomData_copy(&coarse_mesh->pdata,
+                  &cache->coarse_pdata,
+                  SUBDIV_MESH_TOPOLOGY_CD_MASK,
+                  CD_DUPLICATE,
+                  coarse_mesh->totpoly);
+  cache->coarse_layout_len = custom_data_layout_len(&coarse_mesh->edata) +
+                             custom_data_layout_len(&coarse_mesh->ldata) +
+                             custom_data_layout_len(&coarse_mesh->pdata);
+  if (cache->coarse_layout_len != 0) {
+    SubdivMeshLayerLayout *layout = MEM_malloc_arrayN(
+        cache->coarse_layout_len, sizeof(*layout), "subdiv mesh topology cache layout");
+    cache->coarse_layout = layout;
+    layout = custom_data_layout_fill(layout, &coarse_mesh->edata);
+    layout = custom_data_layout_fill(layout, &coarse_mesh->ldata);
+    custom_data_layout_fill(layout, &coarse_mesh->pdata);
+  }
+  subdiv->cache_.mesh_topology = cache;
+}
+
+static void subdiv_mesh_topology_cache_store_result(SubdivMeshTopologyCache *cache,
+                                                    const Mesh *subdiv_mesh)
+{
+  subdiv_mesh_topology_cache_free_result(cache);
+  cache->num_vertices = subdiv_mesh->totvert;
+  cache->num_edges = subdiv_mesh->totedge;
+  cache->num_loops = subdiv_mesh->totloop;
+  cache->num_polygons = subdiv_mesh->totpoly;
+  CustomData_copy(&subdiv_mesh->edata,
+                  &cache->edata,
+                  SUBDIV_MESH_TOPOLOGY_CD_MASK,
+                  CD_DUPLICATE,
+                  subdiv_mesh->totedge);
+  CustomData_copy(&subdiv_mesh->ldata,
+                  &cache->ldata,
+                  SUBDIV_MESH_TOPOLOGY_CD_MASK,
+                  CD_DUPLICATE,
+                  subdiv_mesh->totloop);
+  CustomData_copy(&subdiv_mesh->pdata,
+                  &cache->pdata,
+                  SUBDIV_MESH_TOPOLOGY_CD_MASK,
+                  CD_DUPLICATE,
+                  subdiv_mesh->totpoly);
+  cache->has_result = true;
+}
+
+/* Create the result mesh with topology layers of edges, loops and polygons copied from the
+ * cache. Vertices and the other layers are evaluated by the traversal. */
+static bool subdiv_mesh_topology_info_from_cache(const SubdivForeachContext *foreach_context,
+                                                 const int num_vertices,
+                                                 const int num_edges,
+                                                 const int num_loops,
+                                                 const int num_polygons)
+{
+  SubdivMeshContext *subdiv_context = foreach_context->user_data;
+  const SubdivMeshTopologyCache *cache = subdiv_context->subdiv->cache_.mesh_topology;
+  if (num_vertices != cache->num_vertices || num_edges != cache->num_edges ||
+      num_loops != cache->num_loops || num_polygons != cache->num_polygons) {
+    BLI_assert_msg(0, "Subdivision topology cache does not match the coarse mesh");
+    return false;
+  }
+  if (!subdiv_mesh_topology_info(
+          foreach_context, num_vertices, num_edges, num_loops, num_polygons)) {
+    return false;
+  }
+  Mesh *subdiv_mesh = subdiv_context->subdiv_mesh;
+  CustomData_copy_data(&cache->edata, &subdiv_mesh->edata, 0, 0, num_edges);
+  CustomData_copy_data(&cache->ldata, &subdiv_mesh->ldata, 0, 0, num_loops);
+  CustomData_copy_data(&cache->pdata, &subdiv_mesh->pdata, 0, 0, num_polygons);
+
+  /* Let the traversal only write the layers which are not cached. */
+  const CustomDataMask mask = ~SUBDIV_MESH_TOPOLOGY_CD_MASK;
+  CustomData_copy(&subdiv_mesh->edata, &subdiv_context->edata_dst, mask, CD_REFERENCE, num_edges);
+  CustomData_copy(&subdiv_mesh->ldata, &subdiv_context->ldata_dst, mask, CD_REFERENCE, num_loops);
+  CustomData_copy(
+      &subdiv_mesh->pdata, &subdiv_context->pdata_dst, mask, CD_REFERENCE, num_polygons);
+  subdiv_context->use_topology_cache = true;
+  return true;
+}
+
+/* Edge, loop and polygon callbacks for the cached topology, only the layers which aren't cached
+ * are copied or interpolated from the coarse mesh. */
+
+static void subdiv_mesh_edge_data(const SubdivForeachContext *foreach_context,
+                                  void *UNUSED(tls),
+                                  const int coarse_edge_index,
+                                  const int subdiv_edge_index,
+                                  const int UNUSED(subdiv_v1),
+                                  const int UNUSED(subdiv_v2))
+{
+  SubdivMeshContext *ctx = foreach_context->user_data;
+  if (coarse_edge_index != ORIGINDEX_NONE) {
+    CustomData_copy_data(
+        &ctx->coarse_mesh->edata, &ctx->edata_dst, coarse_edge_index, subdiv_edge_index, 1);
+  }
+}
+
+static void subdiv_mesh_loop_data(const SubdivForeachContext *foreach_context,
+                                  void *tls_v,
+                                  const int ptex_face_index,
+                                  const float u,
+                                  const float v,
+                                  const int UNUSED(coarse_loop_index),
+                                  const int coarse_poly_index,
+                                  const int coarse_corner,
+                                  const int subdiv_loop_index,
+                                  const int UNUSED(subdiv_vertex_index),
+                                  const int UNUSED(subdiv_edge_index))
+{
+  SubdivMeshContext *ctx = foreach_context->user_data;
+  SubdivMeshTLS *tls = tls_v;
+  const MPoly *coarse_poly = &ctx->coarse_mesh->mpoly[coarse_poly_index];
+  MLoop *subdiv_loop = &ctx->subdiv_mesh->mloop[subdiv_loop_index];
+  subdiv_mesh_ensure_loop_interpolation(ctx, tls, coarse_poly, coarse_corner);
+  subdiv_interpolate_loop_data(ctx, subdiv_loop, &tls->loop_interpolation, u, v);
+  subdiv_eval_uv_layer(ctx, subdiv_loop, ptex_face_index, u, v);
+}
+
+static void subdiv_mesh_poly_data(const SubdivForeachContext *foreach_context,
+                                  void *UNUSED(tls),
+                                  const int coarse_poly_index,
+                                  const int subdiv_poly_index,
+                                  const int UNUSED(start_loop_index),
+                                  const int UNUSED(num_loops))
+{
+  SubdivMeshContext *ctx = foreach_context->user_data;
+  CustomData_copy_data(
+      &ctx->coarse_mesh->pdata, &ctx->pdata_dst, coarse_poly_index, subdiv_poly_index, 1);
+}
+
+/** \} */
+
 /* -------------------------------------------------------------------- */
 /** \name Initialization
  * \{ */
 
 static void setup_foreach_callbacks(const SubdivMeshContext *subdiv_context,
-                                    SubdivForeachContext *foreach_context)
+                                    SubdivForeachContext *foreach_context,
+                                    const bool use_topology_cache)
 {
   memset(foreach_context, 0, sizeof(*foreach_context));
   /* General information. */
-  foreach_context->topology_info = subdiv_mesh_topology_info;
+  foreach_context->topology_info = use_topology_cache ? subdiv_mesh_topology_info_from_cache :
+                                                        subdiv_mesh_topology_info;
   /* Every boundary geometry. Used for displacement and normals averaging. */
   if (subdiv_context->can_evaluate_normals || subdiv_context->have_displacement) {
     foreach_context->vertex_every_corner = subdiv_mesh_vertex_every_corner;
@@ -1178,9 +1542,24 @@ static void setup_foreach_callbacks(const SubdivMeshContext *subdiv_context,
   foreach_context->vertex_corner = subdiv_mesh_vertex_corner;
   foreach_context->vertex_edge = subdiv_mesh_vertex_edge;
   foreach_context->vertex_inner = subdiv_mesh_vertex_inner;
-  foreach_context->edge = subdiv_mesh_edge;
-  foreach_context->loop = subdiv_mesh_loop;
-  foreach_context->poly = subdiv_mesh_poly;
+  if (!use_topology_cache) {
+    foreach_context->edge = subdiv_mesh_edge;
+    foreach_context->loop = subdiv_mesh_loop;
+    foreach_context->poly = subdiv_mesh_poly;
+  }
+  else {
+    /* Domains without any layers besides the cached ones aren't traversed at all. */
+    const Mesh *coarse_mesh = subdiv_context->coarse_mesh;
+    if (custom_data_has_non_topology_layers(&coarse_mesh->edata)) {
+      foreach_context->edge = subdiv_mesh_edge_data;
+    }
+    if (custom_data_has_non_topology_layers(&coarse_mesh->ldata)) {
+      foreach_context->loop = subdiv_mesh_loop_data;
+    }
+    if (custom_data_has_non_topology_layers(&coarse_mesh->pdata)) {
+      foreach_context->poly = subdiv_mesh_poly_data;
+    }
+  }
   foreach_context->vertex_loose = subdiv_mesh_vertex_loose;
   foreach_context->vertex_of_loose_edge = subdiv_mesh_vertex_of_loose_edge;
   foreach_context->user_data_tls_free = subdiv_mesh_tls_free;
@@ -1218,10 +1597,17 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   subdiv_context.have_displacement = (subdiv->displacement_evaluator != NULL);
   subdiv_context.can_evaluate_normals = !subdiv_context.have_displacement &&
                                         subdiv_context.subdiv->settings.is_adaptive;
+  /* Only vertices need to be evaluated when the coarse mesh only changed its vertices since the
+   * topology cache was filled. */
+  SubdivMeshTopologyCache *topology_cache = subdiv->cache_.mesh_topology;
+  const bool is_topology_cache_valid = topology_cache != NULL &&
+                                       subdiv_mesh_topology_cache_matches(
+                                           topology_cache, settings, coarse_mesh);
+  const bool use_topology_cache = is_topology_cache_valid && topology_cache->has_result;
   /* Multi-threaded traversal/evaluation. */
   BKE_subdiv_stats_begin(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   SubdivForeachContext foreach_context;
-  setup_foreach_callbacks(&subdiv_context, &foreach_context);
+  setup_foreach_callbacks(&subdiv_context, &foreach_context, use_topology_cache);
   SubdivMeshTLS tls = {0};
   foreach_context.user_data = &subdiv_context;
   foreach_context.user_data_tls_size = sizeof(SubdivMeshTLS);
@@ -1229,10 +1615,18 @@ Mesh *BKE_subdiv_to_mesh(Subdiv *subdiv,
   BKE_subdiv_foreach_subdiv_geometry(subdiv, &foreach_context, settings, coarse_mesh);
   BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH_GEOMETRY);
   Mesh *result = subdiv_context.subdiv_mesh;
+  if (!use_topology_cache) {
+    if (is_topology_cache_valid) {
+      subdiv_mesh_topology_cache_store_result(topology_cache, result);
+    }
+    else {
+      subdiv_mesh_topology_cache_reset(subdiv, settings, coarse_mesh);
+    }
+  }
   // BKE_mesh_validate(result, true, true);
   BKE_subdiv_stats_end(&subdiv->stats, SUBDIV_STATS_SUBDIV_TO_MESH);
   if (!subdiv_context.can_evaluate_normals) {
-    result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+    BKE_mesh_normals_tag_dirty(result);
   }
   /* Free used memory. */
   subdiv_mesh_context_free(&subdiv_context);
@@ -37,6 +37,8 @@ void BKE_subdiv_stats_init(SubdivStats *stats)
   stats->subdiv_to_ccg_time = 0.0;
   stats->subdiv_to_ccg_elements_time = 0.0;
   stats->topology_compare_time = 0.0;
+  stats->limit_stencils_creation_time = 0.0;
+  stats->limit_stencils_evaluation_time = 0.0;
 }
 
 void BKE_subdiv_stats_begin(SubdivStats *stats, eSubdivStatsValue value)
@@ -73,6 +75,8 @@ void BKE_subdiv_stats_print(const SubdivStats *stats)
   STATS_PRINT_TIME(stats, subdiv_to_ccg_time, "Subdivision to CCG time");
   STATS_PRINT_TIME(stats, subdiv_to_ccg_elements_time, "    Elements time");
   STATS_PRINT_TIME(stats, topology_compare_time, "Topology comparison time");
+  STATS_PRINT_TIME(stats, limit_stencils_creation_time, "Limit stencils creation time");
+  STATS_PRINT_TIME(stats, limit_stencils_evaluation_time, "Limit stencils evaluation time");
 
 #undef STATS_PRINT_TIME
 }
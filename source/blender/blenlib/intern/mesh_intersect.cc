@@ -1721,7 +1721,7 @@ static void prepare_need_tri(CDT_data &cd, const IMesh &tm, int t)
   cd.is_reversed.append(rev);
 }
 
-static CDT_data prepare_cdt_input(const IMesh &tm, int t, const Vector<ITT_value> itts)
+static CDT_data prepare_cdt_input(const IMesh &tm, int t, Span<ITT_value> itts)
 {
   CDT_data ans;
   BLI_assert(tm.face(t)->plane_populated());
@@ -1753,7 +1753,7 @@ static CDT_data prepare_cdt_input(const IMesh &tm, int t, const Vector<ITT_value
 static CDT_data prepare_cdt_input_for_cluster(const IMesh &tm,
                                               const CoplanarClusterInfo &clinfo,
                                               int c,
-                                              const Vector<ITT_value> itts)
+                                              Span<ITT_value> itts)
 {
   CDT_data ans;
   BLI_assert(c < clinfo.tot_cluster());
@@ -2598,20 +2598,20 @@ static void calc_subdivided_tri_range_func(void *__restrict userdata,
     std::cout << "calc_subdivided_tri_range_func\nt=" << t << " start=" << otr.overlap_start
               << " len=" << otr.len << "\n";
   }
+  /* Only reserve space: most overlapping pairs don't actually intersect, and
+   * a triangle without any real intersections doesn't need a CDT at all. */
   constexpr int inline_capacity = 100;
-  Vector<ITT_value, inline_capacity> itts(otr.len);
+  Vector<ITT_value, inline_capacity> itts;
+  itts.reserve(otr.len);
   for (int j = otr.overlap_start; j < otr.overlap_start + otr.len; ++j) {
     int t_other = data->overlap[j].indexB;
     std::pair<int, int> key = canon_int_pair(t, t_other);
-    ITT_value itt;
-    if (data->itt_map.contains(key)) {
-      itt = data->itt_map.lookup(key);
-    }
-    if (itt.kind != INONE) {
-      itts.append(itt);
+    const ITT_value *itt = data->itt_map.lookup_ptr(key);
+    if (itt != nullptr && itt->kind != INONE) {
+      itts.append(*itt);
     }
     if (dbg_level > 0) {
-      std::cout << "  tri t" << t_other << "; result = " << itt << "\n";
+      std::cout << "  tri t" << t_other << "; result = " << (itt ? *itt : ITT_value()) << "\n";
     }
   }
   if (itts.size() > 0) {
@@ -2686,6 +2686,41 @@ static void calc_subdivided_non_cluster_tris(Array<IMesh> &r_tri_subdivided,
   });
 }
 
+/**
+ * Extract the triangles of cluster cl that correspond to each original triangle t
+ * that is part of the cluster, and put the resulting triangles into an IMesh
+ * in tri_subdivided[t]. The CDT for the cluster has already been done, with result cd.
+ */
+static void calc_cluster_tris_single(Array<IMesh> &tri_subdivided,
+                                     const IMesh &tm,
+                                     const CoplanarCluster &cl,
+                                     const CDT_data &cd,
+                                     IMeshArena *arena)
+{
+  /* Each triangle in cluster c should be an input triangle in cd.input_faces.
+   * (See prepare_cdt_input_for_cluster.)
+   * So accumulate a Vector of Face* for each input face by going through the
+   * output faces and making a Face for each input face that it is part of.
+   * (The Boolean algorithm wants duplicates if a given output triangle is part
+   * of more than one input triangle.)
+   */
+  int n_cluster_tris = cl.tot_tri();
+  const CDT_result<mpq_class> &cdt_out = cd.cdt_out;
+  BLI_assert(cd.input_face.size() == n_cluster_tris);
+  Array<Vector<Face *>> face_vec(n_cluster_tris);
+  for (int cdt_out_t : cdt_out.face.index_range()) {
+    for (int cdt_in_t : cdt_out.face_orig[cdt_out_t]) {
+      Face *f = cdt_tri_as_imesh_face(cdt_out_t, cdt_in_t, cd, tm, arena);
+      face_vec[cdt_in_t].append(f);
+    }
+  }
+  for (int cdt_in_t : cd.input_face.index_range()) {
+    int tm_t = cd.input_face[cdt_in_t];
+    BLI_assert(tri_subdivided[tm_t].face_size() == 0);
+    tri_subdivided[tm_t] = IMesh(face_vec[cdt_in_t]);
+  }
+}
+
 /**
  * For each cluster in clinfo, extract the triangles from the cluster
  * that correspond to each original triangle t that is part of the cluster,
@@ -2699,31 +2734,19 @@ static void calc_cluster_tris(Array<IMesh> &tri_subdivided,
                               const Array<CDT_data> &cluster_subdivided,
                               IMeshArena *arena)
 {
-  for (int c : clinfo.index_range()) {
-    const CoplanarCluster &cl = clinfo.cluster(c);
-    const CDT_data &cd = cluster_subdivided[c];
-    /* Each triangle in cluster c should be an input triangle in cd.input_faces.
-     * (See prepare_cdt_input_for_cluster.)
-     * So accumulate a Vector of Face* for each input face by going through the
-     * output faces and making a Face for each input face that it is part of.
-     * (The Boolean algorithm wants duplicates if a given output triangle is part
-     * of more than one input triangle.)
-     */
-    int n_cluster_tris = cl.tot_tri();
-    const CDT_result<mpq_class> &cdt_out = cd.cdt_out;
-    BLI_assert(cd.input_face.size() == n_cluster_tris);
-    Array<Vector<Face *>> face_vec(n_cluster_tris);
-    for (int cdt_out_t : cdt_out.face.index_range()) {
-      for (int cdt_in_t : cdt_out.face_orig[cdt_out_t]) {
-        Face *f = cdt_tri_as_imesh_face(cdt_out_t, cdt_in_t, cd, tm, arena);
-        face_vec[cdt_in_t].append(f);
-      }
-    }
-    for (int cdt_in_t : cd.input_face.index_range()) {
-      int tm_t = cd.input_face[cdt_in_t];
-      BLI_assert(tri_subdivided[tm_t].face_size() == 0);
-      tri_subdivided[tm_t] = IMesh(face_vec[cdt_in_t]);
+  /* Clusters are disjoint sets of triangles, so each cluster only writes to its own
+   * slots of tri_subdivided and the clusters can be extracted in parallel. */
+  auto calc_cluster_tris_range = [&](IndexRange range) {
+    for (int c : range) {
+      calc_cluster_tris_single(
+          tri_subdivided, tm, clinfo.cluster(c), cluster_subdivided[c], arena);
     }
+  };
+  if (intersect_use_threading) {
+    threading::parallel_for(clinfo.index_range(), 1, calc_cluster_tris_range);
+  }
+  else {
+    calc_cluster_tris_range(clinfo.index_range());
   }
 }
 
@@ -3079,9 +3102,20 @@ IMesh trimesh_nary_intersect(const IMesh &tm_in,
   std::cout << "subdivided non-cluster tris found, time = " << subdivided_tris_time - itt_time
             << "\n";
 #  endif
+  /* The CDT of each cluster is independent of the others, and large clusters
+   * (e.g. big coplanar regions of CAD meshes) can be expensive, so do them in parallel. */
   Array<CDT_data> cluster_subdivided(clinfo.tot_cluster());
-  for (int c : clinfo.index_range()) {
-    cluster_subdivided[c] = calc_cluster_subdivided(clinfo, c, *tm_clean, tri_ov, itt_map, arena);
+  auto calc_cluster_subdivided_range = [&](IndexRange range) {
+    for (int c : range) {
+      cluster_subdivided[c] = calc_cluster_subdivided(
+          clinfo, c, *tm_clean, tri_ov, itt_map, arena);
+    }
+  };
+  if (intersect_use_threading) {
+    threading::parallel_for(clinfo.index_range(), 1, calc_cluster_subdivided_range);
+  }
+  else {
+    calc_cluster_subdivided_range(clinfo.index_range());
   }
 #  ifdef PERFDEBUG
   double cluster_subdivide_time = PIL_check_seconds_timer();
@@ -312,6 +312,12 @@ typedef struct BMesh {
    */
   char elem_table_dirty;
 
+  /**
+   * Set when elements are created, removed or re-ordered. Cleared by #BM_mesh_bm_from_me,
+   * so #BM_mesh_bm_to_me can update the mesh in-place while the topology is known to be unchanged.
+   */
+  char topology_dirty;
+
   /* element pools */
   struct BLI_mempool *vpool, *epool, *lpool, *fpool;
 
@@ -102,6 +102,7 @@ BMVert *BM_vert_create(BMesh *bm,
   bm->elem_index_dirty |= BM_VERT;
   bm->elem_table_dirty |= BM_VERT;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   bm->totvert++;
 
@@ -192,6 +193,7 @@ BMEdge *BM_edge_create(
   bm->elem_index_dirty |= BM_EDGE;
   bm->elem_table_dirty |= BM_EDGE;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   bm->totedge++;
 
@@ -262,6 +264,7 @@ static BMLoop *bm_loop_create(BMesh *bm,
   /* may add to middle of the pool */
   bm->elem_index_dirty |= BM_LOOP;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   bm->totloop++;
 
@@ -406,6 +409,7 @@ BLI_INLINE BMFace *bm_face_create__internal(BMesh *bm)
   bm->elem_index_dirty |= BM_FACE;
   bm->elem_table_dirty |= BM_FACE;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   bm->totface++;
 
@@ -753,6 +757,7 @@ static void bm_kill_only_vert(BMesh *bm, BMVert *v)
   bm->elem_index_dirty |= BM_VERT;
   bm->elem_table_dirty |= BM_VERT;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   BM_select_history_remove(bm, v);
 
@@ -776,6 +781,7 @@ static void bm_kill_only_edge(BMesh *bm, BMEdge *e)
   bm->elem_index_dirty |= BM_EDGE;
   bm->elem_table_dirty |= BM_EDGE;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   BM_select_history_remove(bm, (BMElem *)e);
 
@@ -803,6 +809,7 @@ static void bm_kill_only_face(BMesh *bm, BMFace *f)
   bm->elem_index_dirty |= BM_FACE;
   bm->elem_table_dirty |= BM_FACE;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   BM_select_history_remove(bm, (BMElem *)f);
 
@@ -825,6 +832,7 @@ static void bm_kill_only_loop(BMesh *bm, BMLoop *l)
   bm->totloop--;
   bm->elem_index_dirty |= BM_LOOP;
   bm->spacearr_dirty |= BM_SPACEARR_DIRTY_ALL;
+  bm->topology_dirty = true;
 
   if (l->head.data) {
     CustomData_bmesh_free_block(&bm->ldata, &l->head.data);
@@ -1108,6 +1116,7 @@ void bmesh_kernel_loop_reverse(BMesh *bm,
 
   /* Loop indices are no more valid! */
   bm->elem_index_dirty |= BM_LOOP;
+  bm->topology_dirty = true;
 }
 
 static void bm_elements_systag_enable(void *veles, int tot, const char api_flag)
@@ -2211,6 +2220,7 @@ BMFace *bmesh_kernel_join_face_kill_edge(BMesh *bm, BMFace *f1, BMFace *f2, BMEd
   bm->totface--;
   /* account for both above */
   bm->elem_index_dirty |= BM_EDGE | BM_LOOP | BM_FACE;
+  bm->topology_dirty = true;
 
   BM_CHECK_ELEMENT(f1);
 
@@ -81,6 +81,7 @@
 #include "BLI_alloca.h"
 #include "BLI_listbase.h"
 #include "BLI_math_vector.h"
+#include "BLI_task.h"
 
 #include "BKE_customdata.h"
 #include "BKE_mesh.h"
@@ -176,6 +177,70 @@ static BMFace *bm_face_create_from_mpoly(
   return BM_face_create(bm, verts, edges, mp->totloop, NULL, BM_CREATE_SKIP_CD);
 }
 
+/* Below this many elements per thread, the conversion loops are run single threaded. */
+#define BM_CONVERT_MIN_ITER_PER_THREAD 1024
+
+typedef struct BMFromMeshVertData {
+  const Mesh *me;
+  BMVert **vtable;
+  int cd_vert_bweight_offset;
+  int cd_shape_keyindex_offset;
+  int cd_shape_key_offset;
+  const float (**shape_key_table)[3];
+  int tot_shape_keys;
+} BMFromMeshVertData;
+
+/* Set vertex custom-data which isn't stored in #Mesh.vdata. */
+static void bm_from_me_vert_data_task(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshVertData *data = userdata;
+  BMVert *v = data->vtable[i];
+
+  if (data->cd_vert_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(
+        v, data->cd_vert_bweight_offset, (float)data->me->mvert[i].bweight / 255.0f);
+  }
+
+  /* Set shape key original index. */
+  if (data->cd_shape_keyindex_offset != -1) {
+    BM_ELEM_CD_SET_INT(v, data->cd_shape_keyindex_offset, i);
+  }
+
+  /* Set shape-key data. */
+  if (data->tot_shape_keys) {
+    float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, data->cd_shape_key_offset);
+    for (int j = 0; j < data->tot_shape_keys; j++, co_dst++) {
+      copy_v3_v3(*co_dst, data->shape_key_table[j][i]);
+    }
+  }
+}
+
+typedef struct BMFromMeshEdgeData {
+  const Mesh *me;
+  BMEdge **etable;
+  int cd_edge_bweight_offset;
+  int cd_edge_crease_offset;
+} BMFromMeshEdgeData;
+
+/* Set edge custom-data which isn't stored in #Mesh.edata. */
+static void bm_from_me_edge_data_task(void *__restrict userdata,
+                                      const int i,
+                                      const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const BMFromMeshEdgeData *data = userdata;
+  BMEdge *e = data->etable[i];
+  const MEdge *medge = &data->me->medge[i];
+
+  if (data->cd_edge_bweight_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
+  }
+  if (data->cd_edge_crease_offset != -1) {
+    BM_ELEM_CD_SET_FLOAT(e, data->cd_edge_crease_offset, (float)medge->crease / 255.0f);
+  }
+}
+
 /**
  * \brief Mesh -> BMesh
  * \param bm: The mesh to write into, while this is typically a newly created BMesh,
@@ -198,6 +263,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
   BMVert *v, **vtable = NULL;
   BMEdge *e, **etable = NULL;
   BMFace *f, **ftable = NULL;
+  BMLoop **ltable = NULL;
   float(*keyco)[3] = NULL;
   int totloops, i;
   CustomData_MeshMasks mask = CD_MASK_BMESH;
@@ -345,31 +411,30 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
     }
 
     normal_short_to_float_v3(v->no, mvert->no);
-
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->vdata, &bm->vdata, i, &v->head.data, true);
-
-    if (cd_vert_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(v, cd_vert_bweight_offset, (float)mvert->bweight / 255.0f);
-    }
-
-    /* Set shape key original index. */
-    if (cd_shape_keyindex_offset != -1) {
-      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
-    }
-
-    /* Set shape-key data. */
-    if (tot_shape_keys) {
-      float(*co_dst)[3] = BM_ELEM_CD_GET_VOID_P(v, cd_shape_key_offset);
-      for (int j = 0; j < tot_shape_keys; j++, co_dst++) {
-        copy_v3_v3(*co_dst, shape_key_table[j][i]);
-      }
-    }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_VERT; /* Added in order, clear dirty flag. */
   }
 
+  /* Copy Custom Data */
+  CustomData_to_bmesh_elems(&me->vdata, &bm->vdata, 0, (BMHeader **)vtable, me->totvert);
+
+  if ((cd_vert_bweight_offset != -1) || (cd_shape_keyindex_offset != -1) || tot_shape_keys) {
+    BMFromMeshVertData data = {
+        .me = me,
+        .vtable = vtable,
+        .cd_vert_bweight_offset = cd_vert_bweight_offset,
+        .cd_shape_keyindex_offset = cd_shape_keyindex_offset,
+        .cd_shape_key_offset = cd_shape_key_offset,
+        .shape_key_table = shape_key_table,
+        .tot_shape_keys = tot_shape_keys,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = BM_CONVERT_MIN_ITER_PER_THREAD;
+    BLI_task_parallel_range(0, me->totvert, &data, bm_from_me_vert_data_task, &settings);
+  }
+
   etable = MEM_mallocN(sizeof(BMEdge **) * me->totedge, __func__);
 
   medge = me->medge;
@@ -386,25 +451,32 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
       BM_edge_select_set(bm, e, true);
     }
 
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->edata, &bm->edata, i, &e->head.data, true);
-
-    if (cd_edge_bweight_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_bweight_offset, (float)medge->bweight / 255.0f);
-    }
-    if (cd_edge_crease_offset != -1) {
-      BM_ELEM_CD_SET_FLOAT(e, cd_edge_crease_offset, (float)medge->crease / 255.0f);
-    }
   }
   if (is_new) {
     bm->elem_index_dirty &= ~BM_EDGE; /* Added in order, clear dirty flag. */
   }
 
-  /* Only needed for selection. */
-  if (me->mselect && me->totselect != 0) {
-    ftable = MEM_mallocN(sizeof(BMFace **) * me->totpoly, __func__);
+  /* Copy Custom Data */
+  CustomData_to_bmesh_elems(&me->edata, &bm->edata, 0, (BMHeader **)etable, me->totedge);
+
+  if ((cd_edge_bweight_offset != -1) || (cd_edge_crease_offset != -1)) {
+    BMFromMeshEdgeData data = {
+        .me = me,
+        .etable = etable,
+        .cd_edge_bweight_offset = cd_edge_bweight_offset,
+        .cd_edge_crease_offset = cd_edge_crease_offset,
+    };
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = BM_CONVERT_MIN_ITER_PER_THREAD;
+    BLI_task_parallel_range(0, me->totedge, &data, bm_from_me_edge_data_task, &settings);
   }
 
+  /* Faces and loops of faces which failed to be created are left as NULL,
+   * so their custom-data is skipped. */
+  ftable = MEM_callocN(sizeof(BMFace **) * me->totpoly, __func__);
+  ltable = MEM_callocN(sizeof(BMLoop **) * me->totloop, __func__);
+
   mloop = me->mloop;
   mp = me->mpoly;
   for (i = 0, totloops = 0; i < me->totpoly; i++, mp++) {
@@ -412,9 +484,7 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
     BMLoop *l_first;
 
     f = bm_face_create_from_mpoly(mp, mloop + mp->loopstart, bm, vtable, etable);
-    if (ftable != NULL) {
-      ftable[i] = f;
-    }
+    ftable[i] = f;
 
     if (UNLIKELY(f == NULL)) {
       printf(
@@ -448,13 +518,10 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
       /* Don't use 'j' since we may have skipped some faces, hence some loops. */
       BM_elem_index_set(l_iter, totloops++); /* set_ok */
 
-      /* Save index of corresponding #MLoop. */
-      CustomData_to_bmesh_block(&me->ldata, &bm->ldata, j++, &l_iter->head.data, true);
+      /* Save corresponding #MLoop. */
+      ltable[j++] = l_iter;
     } while ((l_iter = l_iter->next) != l_first);
 
-    /* Copy Custom Data */
-    CustomData_to_bmesh_block(&me->pdata, &bm->pdata, i, &f->head.data, true);
-
     if (params->calc_face_normal) {
       BM_face_normal_update(f);
     }
@@ -463,6 +530,11 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
     bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP); /* Added in order, clear dirty flag. */
   }
 
+  /* Copy Custom Data */
+  CustomData_to_bmesh_elems(&me->ldata, &bm->ldata, 0, (BMHeader **)ltable, me->totloop);
+  CustomData_to_bmesh_elems(&me->pdata, &bm->pdata, 0, (BMHeader **)ftable, me->totpoly);
+  MEM_freeN(ltable);
+
   /* -------------------------------------------------------------------- */
   /* MSelect clears the array elements (avoid adding multiple times).
    *
@@ -499,8 +571,10 @@ void BM_mesh_bm_from_me(BMesh *bm, const Mesh *me, const struct BMeshFromMeshPar
 
   MEM_freeN(vtable);
   MEM_freeN(etable);
-  if (ftable) {
-    MEM_freeN(ftable);
+  MEM_freeN(ftable);
+
+  if (is_new) {
+    bm->topology_dirty = false;
   }
 }
 
@@ -582,6 +656,290 @@ BLI_INLINE void bmesh_quick_edgedraw_flag(MEdge *med, BMEdge *e)
   }
 }
 
+/**
+ * Find the layer in \a bm_data that each layer of \a me_data is copied from by
+ * #BM_mesh_bm_to_me, (-1 for the \a base_type layer holding the mesh elements).
+ *
+ * \return false when the layers differ from the ones a full conversion would create.
+ */
+static bool bm_to_me_customdata_layers_match(const CustomData *bm_data,
+                                             const CustomData *me_data,
+                                             const CustomDataMask mask,
+                                             const int base_type,
+                                             int *r_bm_layers)
+{
+  int bm_i = 0;
+  for (int me_i = 0; me_i < me_data->totlayer; me_i++) {
+    const CustomDataLayer *me_layer = &me_data->layers[me_i];
+    /* Layers referencing data owned elsewhere can't be written to. */
+    if (me_layer->flag & CD_FLAG_NOFREE) {
+      return false;
+    }
+    if (me_layer->type == base_type) {
+      r_bm_layers[me_i] = -1;
+      continue;
+    }
+    while (bm_i < bm_data->totlayer &&
+           !(CD_TYPE_AS_MASK(bm_data->layers[bm_i].type) & mask)) {
+      bm_i++;
+    }
+    if (bm_i == bm_data->totlayer) {
+      return false;
+    }
+    const CustomDataLayer *bm_layer = &bm_data->layers[bm_i];
+    if ((bm_layer->type != me_layer->type) || (bm_layer->flag & CD_FLAG_NOCOPY) ||
+        !STREQ(bm_layer->name, me_layer->name)) {
+      return false;
+    }
+    r_bm_layers[me_i] = bm_i++;
+  }
+  for (; bm_i < bm_data->totlayer; bm_i++) {
+    if (CD_TYPE_AS_MASK(bm_data->layers[bm_i].type) & mask) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void bm_to_me_customdata_active_update(const CustomData *bm_data,
+                                              CustomData *me_data,
+                                              const int *bm_layers)
+{
+  for (int me_i = 0; me_i < me_data->totlayer; me_i++) {
+    if (bm_layers[me_i] == -1) {
+      continue;
+    }
+    const CustomDataLayer *bm_layer = &bm_data->layers[bm_layers[me_i]];
+    CustomDataLayer *me_layer = &me_data->layers[me_i];
+    me_layer->active = bm_layer->active;
+    me_layer->active_rnd = bm_layer->active_rnd;
+    me_layer->active_clone = bm_layer->active_clone;
+    me_layer->active_mask = bm_layer->active_mask;
+  }
+}
+
+/**
+ * Check the edges, faces and loops of \a bm are the ones stored in \a me.
+ *
+ * \param check_keyindex: Also check the original index of every vertex is unchanged,
+ * so remapping hooks and vertex parents can be skipped.
+ */
+static bool bm_to_me_topology_matches(BMesh *bm, const Mesh *me, const bool check_keyindex)
+{
+  if ((me->totvert != bm->totvert) || (me->totedge != bm->totedge) ||
+      (me->totloop != bm->totloop) || (me->totpoly != bm->totface)) {
+    return false;
+  }
+
+  BMIter iter;
+  int i;
+
+  const int cd_shape_keyindex_offset = CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX);
+  if (check_keyindex && (cd_shape_keyindex_offset != -1)) {
+    BMVert *v;
+    BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+      if (BM_ELEM_CD_GET_INT(v, cd_shape_keyindex_offset) != i) {
+        return false;
+      }
+    }
+  }
+
+  BM_mesh_elem_index_ensure(bm, BM_VERT | BM_EDGE);
+
+  const MEdge *med = me->medge;
+  BMEdge *e;
+  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
+    if ((med->v1 != BM_elem_index_get(e->v1)) || (med->v2 != BM_elem_index_get(e->v2))) {
+      return false;
+    }
+    med++;
+  }
+
+  const MPoly *mp = me->mpoly;
+  const MLoop *ml = me->mloop;
+  int j = 0;
+  BMFace *f;
+  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+    if ((mp->loopstart != j) || (mp->totloop != f->len)) {
+      return false;
+    }
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      if ((ml->v != BM_elem_index_get(l_iter->v)) || (ml->e != BM_elem_index_get(l_iter->e))) {
+        return false;
+      }
+      j++;
+      ml++;
+    } while ((l_iter = l_iter->next) != l_first);
+    mp++;
+  }
+
+  return true;
+}
+
+static void bm_to_me_select_history_update(BMesh *bm, Mesh *me)
+{
+  BMEditSelection *selected;
+  int i;
+  me->totselect = BLI_listbase_count(&(bm->selected));
+
+  MEM_SAFE_FREE(me->mselect);
+  if (me->totselect != 0) {
+    me->mselect = MEM_mallocN(sizeof(MSelect) * me->totselect, "Mesh selection history");
+  }
+
+  for (i = 0, selected = bm->selected.first; selected; i++, selected = selected->next) {
+    if (selected->htype == BM_VERT) {
+      me->mselect[i].type = ME_VSEL;
+    }
+    else if (selected->htype == BM_EDGE) {
+      me->mselect[i].type = ME_ESEL;
+    }
+    else if (selected->htype == BM_FACE) {
+      me->mselect[i].type = ME_FSEL;
+    }
+
+    me->mselect[i].index = BM_elem_index_get(selected->ele);
+  }
+}
+
+/**
+ * When the topology of \a bm is unchanged from \a me (typically leaving edit-mode after only
+ * moving vertices or editing attributes), write the data into the existing arrays and layers
+ * of the mesh instead of re-creating them.
+ *
+ * \return false when the mesh must be fully re-created, in that case \a me is left unchanged.
+ */
+static bool bm_to_me_update_in_place(BMesh *bm,
+                                     Mesh *me,
+                                     const struct BMeshToMeshParams *params)
+{
+  /* Shape-keys are rebuilt from the original vertex indices, leave them to the full conversion.
+   * The topology may also be unchanged relative to a different mesh (when it was loaded from an
+   * undo step for example), so it's always checked against the mesh too. */
+  if (bm->topology_dirty || (me->key != NULL)) {
+    return false;
+  }
+
+  CustomData_MeshMasks mask = CD_MASK_MESH;
+  CustomData_MeshMasks_update(&mask, &params->cd_mask_extra);
+
+  int *vlayers = BLI_array_alloca(vlayers, me->vdata.totlayer);
+  int *elayers = BLI_array_alloca(elayers, me->edata.totlayer);
+  int *llayers = BLI_array_alloca(llayers, me->ldata.totlayer);
+  int *players = BLI_array_alloca(players, me->pdata.totlayer);
+  if (!bm_to_me_customdata_layers_match(&bm->vdata, &me->vdata, mask.vmask, CD_MVERT, vlayers) ||
+      !bm_to_me_customdata_layers_match(&bm->edata, &me->edata, mask.emask, CD_MEDGE, elayers) ||
+      !bm_to_me_customdata_layers_match(&bm->ldata, &me->ldata, mask.lmask, CD_MLOOP, llayers) ||
+      !bm_to_me_customdata_layers_match(&bm->pdata, &me->pdata, mask.pmask, CD_MPOLY, players)) {
+    return false;
+  }
+
+  if (!bm_to_me_topology_matches(bm, me, params->calc_object_remap)) {
+    return false;
+  }
+
+  const int cd_vert_bweight_offset = CustomData_get_offset(&bm->vdata, CD_BWEIGHT);
+  const int cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
+  const int cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
+  const int cd_shape_keyindex_offset = CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX);
+
+  /* Free the element data that is overwritten (deform-weights, multi-resolution grids... ). */
+  CustomData_free_elem(&me->vdata, 0, me->totvert);
+  CustomData_free_elem(&me->edata, 0, me->totedge);
+  CustomData_free_elem(&me->ldata, 0, me->totloop);
+  CustomData_free_elem(&me->pdata, 0, me->totpoly);
+
+  CustomData_free(&me->fdata, me->totface);
+  me->totface = 0;
+  me->act_face = -1;
+  me->cd_flag = BM_mesh_cd_flag_from_bmesh(bm);
+  BKE_mesh_update_customdata_pointers(me, false);
+
+  BMHeader **elems = MEM_mallocN(sizeof(*elems) * max_iii(me->totvert, me->totedge, me->totpoly),
+                                 __func__);
+  BMHeader **loop_elems = MEM_mallocN(sizeof(*loop_elems) * me->totloop, __func__);
+  BMIter iter;
+  int i, j;
+
+  MVert *mvert = me->mvert;
+  BMVert *v;
+  BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+    copy_v3_v3(mvert->co, v->co);
+    normal_float_to_short_v3(mvert->no, v->no);
+    mvert->flag = BM_vert_flag_to_mflag(v);
+    mvert->bweight = (cd_vert_bweight_offset != -1) ?
+                         BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, cd_vert_bweight_offset) :
+                         0;
+    elems[i] = &v->head;
+    mvert++;
+  }
+  CustomData_from_bmesh_elems(&bm->vdata, &me->vdata, elems, 0, me->totvert);
+
+  MEdge *med = me->medge;
+  BMEdge *e;
+  BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+    med->flag = BM_edge_flag_to_mflag(e);
+    bmesh_quick_edgedraw_flag(med, e);
+    med->crease = (cd_edge_crease_offset != -1) ?
+                      BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_crease_offset) :
+                      0;
+    med->bweight = (cd_edge_bweight_offset != -1) ?
+                       BM_ELEM_CD_GET_FLOAT_AS_UCHAR(e, cd_edge_bweight_offset) :
+                       0;
+    elems[i] = &e->head;
+    med++;
+  }
+  CustomData_from_bmesh_elems(&bm->edata, &me->edata, elems, 0, me->totedge);
+
+  MPoly *mp = me->mpoly;
+  BMFace *f;
+  j = 0;
+  BM_ITER_MESH_INDEX (f, &iter, bm, BM_FACES_OF_MESH, i) {
+    mp->mat_nr = f->mat_nr;
+    mp->flag = BM_face_flag_to_mflag(f);
+    if (f == bm->act_face) {
+      me->act_face = i;
+    }
+
+    BMLoop *l_iter, *l_first;
+    l_iter = l_first = BM_FACE_FIRST_LOOP(f);
+    do {
+      BM_elem_index_set(l_iter, j); /* set_inline */
+      loop_elems[j++] = &l_iter->head;
+    } while ((l_iter = l_iter->next) != l_first);
+
+    BM_elem_index_set(f, i); /* set_inline */
+    elems[i] = &f->head;
+    mp++;
+  }
+  bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP);
+  CustomData_from_bmesh_elems(&bm->ldata, &me->ldata, loop_elems, 0, me->totloop);
+  CustomData_from_bmesh_elems(&bm->pdata, &me->pdata, elems, 0, me->totpoly);
+
+  MEM_freeN(elems);
+  MEM_freeN(loop_elems);
+
+  bm_to_me_customdata_active_update(&bm->vdata, &me->vdata, vlayers);
+  bm_to_me_customdata_active_update(&bm->edata, &me->edata, elayers);
+  bm_to_me_customdata_active_update(&bm->ldata, &me->ldata, llayers);
+  bm_to_me_customdata_active_update(&bm->pdata, &me->pdata, players);
+
+  bm_to_me_select_history_update(bm, me);
+
+  if (params->update_shapekey_indices && (cd_shape_keyindex_offset != -1)) {
+    BM_ITER_MESH_INDEX (v, &iter, bm, BM_VERTS_OF_MESH, i) {
+      BM_ELEM_CD_SET_INT(v, cd_shape_keyindex_offset, i);
+    }
+  }
+
+  /* To be removed as soon as COW is enabled by default. */
+  BKE_mesh_runtime_clear_geometry(me);
+
+  return true;
+}
+
 /**
  *
  * \param bmain: May be NULL in case \a calc_object_remap parameter option is not set.
@@ -600,6 +958,10 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   const int cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
   const int cd_shape_keyindex_offset = CustomData_get_offset(&bm->vdata, CD_SHAPE_KEYINDEX);
 
+  if (bm_to_me_update_in_place(bm, me, params)) {
+    return;
+  }
+
   MVert *oldverts = NULL;
   const int ototvert = me->totvert;
 
@@ -658,6 +1020,11 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   /* This is called again, 'dotess' arg is used there. */
   BKE_mesh_update_customdata_pointers(me, 0);
 
+  /* Elements are gathered while iterating, their custom-data is copied afterwards in bulk. */
+  BMHeader **elems = MEM_mallocN(sizeof(*elems) * max_iii(me->totvert, me->totedge, me->totpoly),
+                                 __func__);
+  BMHeader **loop_elems = MEM_mallocN(sizeof(*loop_elems) * me->totloop, __func__);
+
   i = 0;
   BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
     copy_v3_v3(mvert->co, v->co);
@@ -667,8 +1034,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 
     BM_elem_index_set(v, i); /* set_inline */
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, v->head.data, i);
+    elems[i] = &v->head;
 
     if (cd_vert_bweight_offset != -1) {
       mvert->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(v, cd_vert_bweight_offset);
@@ -681,6 +1047,9 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   }
   bm->elem_index_dirty &= ~BM_VERT;
 
+  /* Copy over custom-data. */
+  CustomData_from_bmesh_elems(&bm->vdata, &me->vdata, elems, 0, me->totvert);
+
   med = medge;
   i = 0;
   BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
@@ -691,8 +1060,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 
     BM_elem_index_set(e, i); /* set_inline */
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, e->head.data, i);
+    elems[i] = &e->head;
 
     bmesh_quick_edgedraw_flag(med, e);
 
@@ -709,6 +1077,8 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
   }
   bm->elem_index_dirty &= ~BM_EDGE;
 
+  CustomData_from_bmesh_elems(&bm->edata, &me->edata, elems, 0, me->totedge);
+
   i = 0;
   j = 0;
   BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
@@ -723,8 +1093,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
       mloop->e = BM_elem_index_get(l_iter->e);
       mloop->v = BM_elem_index_get(l_iter->v);
 
-      /* Copy over custom-data. */
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
+      loop_elems[j] = &l_iter->head;
 
       j++;
       mloop++;
@@ -737,14 +1106,18 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
       me->act_face = i;
     }
 
-    /* Copy over custom-data. */
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, f->head.data, i);
+    elems[i] = &f->head;
 
     i++;
     mpoly++;
     BM_CHECK_ELEMENT(f);
   }
 
+  CustomData_from_bmesh_elems(&bm->ldata, &me->ldata, loop_elems, 0, me->totloop);
+  CustomData_from_bmesh_elems(&bm->pdata, &me->pdata, elems, 0, me->totpoly);
+  MEM_freeN(elems);
+  MEM_freeN(loop_elems);
+
   /* Patch hook indices and vertex parents. */
   if (params->calc_object_remap && (ototvert > 0)) {
     BLI_assert(bmain != NULL);
@@ -813,29 +1186,7 @@ void BM_mesh_bm_to_me(Main *bmain, BMesh *bm, Mesh *me, const struct BMeshToMesh
 
   BKE_mesh_update_customdata_pointers(me, false);
 
-  {
-    BMEditSelection *selected;
-    me->totselect = BLI_listbase_count(&(bm->selected));
-
-    MEM_SAFE_FREE(me->mselect);
-    if (me->totselect != 0) {
-      me->mselect = MEM_mallocN(sizeof(MSelect) * me->totselect, "Mesh selection history");
-    }
-
-    for (i = 0, selected = bm->selected.first; selected; i++, selected = selected->next) {
-      if (selected->htype == BM_VERT) {
-        me->mselect[i].type = ME_VSEL;
-      }
-      else if (selected->htype == BM_EDGE) {
-        me->mselect[i].type = ME_ESEL;
-      }
-      else if (selected->htype == BM_FACE) {
-        me->mselect[i].type = ME_FSEL;
-      }
-
-      me->mselect[i].index = BM_elem_index_get(selected->ele);
-    }
-  }
+  bm_to_me_select_history_update(bm, me);
 
   /* See comment below, this logic is in twice. */
 
@@ -1072,6 +1423,11 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
   const int cd_edge_bweight_offset = CustomData_get_offset(&bm->edata, CD_BWEIGHT);
   const int cd_edge_crease_offset = CustomData_get_offset(&bm->edata, CD_CREASE);
 
+  /* Elements are gathered while iterating, their custom-data is copied afterwards in bulk. */
+  BMHeader **elems = MEM_mallocN(sizeof(*elems) * max_iii(me->totvert, me->totedge, me->totpoly),
+                                 __func__);
+  BMHeader **loop_elems = MEM_mallocN(sizeof(*loop_elems) * me->totloop, __func__);
+
   me->runtime.deformed_only = true;
 
   /* Don't add origindex layer if one already exists. */
@@ -1098,11 +1454,12 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
       *index++ = i;
     }
 
-    CustomData_from_bmesh_block(&bm->vdata, &me->vdata, eve->head.data, i);
+    elems[i] = &eve->head;
   }
   bm->elem_index_dirty &= ~BM_VERT;
 
-  index = CustomData_get_layer(&me->edata, CD_ORIGINDEX);
+  CustomData_from_bmesh_elems(&bm->vdata, &me->vdata, elems, 0, me->totvert);
+
   BM_ITER_MESH_INDEX (eed, &iter, bm, BM_EDGES_OF_MESH, i) {
     MEdge *med = &medge[i];
 
@@ -1128,14 +1485,18 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
       med->bweight = BM_ELEM_CD_GET_FLOAT_AS_UCHAR(eed, cd_edge_bweight_offset);
     }
 
-    CustomData_from_bmesh_block(&bm->edata, &me->edata, eed->head.data, i);
-    if (add_orig) {
-      *index++ = i;
-    }
+    elems[i] = &eed->head;
   }
   bm->elem_index_dirty &= ~BM_EDGE;
 
-  index = CustomData_get_layer(&me->pdata, CD_ORIGINDEX);
+  CustomData_from_bmesh_elems(&bm->edata, &me->edata, elems, 0, me->totedge);
+  if (add_orig) {
+    index = CustomData_get_layer(&me->edata, CD_ORIGINDEX);
+    for (i = 0; i < me->totedge; i++) {
+      index[i] = i;
+    }
+  }
+
   j = 0;
   BM_ITER_MESH_INDEX (efa, &iter, bm, BM_FACES_OF_MESH, i) {
     BMLoop *l_iter;
@@ -1153,7 +1514,7 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
     do {
       mloop->v = BM_elem_index_get(l_iter->v);
       mloop->e = BM_elem_index_get(l_iter->e);
-      CustomData_from_bmesh_block(&bm->ldata, &me->ldata, l_iter->head.data, j);
+      loop_elems[j] = &l_iter->head;
 
       BM_elem_index_set(l_iter, j); /* set_inline */
 
@@ -1161,13 +1522,20 @@ void BM_mesh_bm_to_me_for_eval(BMesh *bm, Mesh *me, const CustomData_MeshMasks *
       mloop++;
     } while ((l_iter = l_iter->next) != l_first);
 
-    CustomData_from_bmesh_block(&bm->pdata, &me->pdata, efa->head.data, i);
+    elems[i] = &efa->head;
+  }
+  bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP);
 
-    if (add_orig) {
-      *index++ = i;
+  CustomData_from_bmesh_elems(&bm->ldata, &me->ldata, loop_elems, 0, me->totloop);
+  CustomData_from_bmesh_elems(&bm->pdata, &me->pdata, elems, 0, me->totpoly);
+  if (add_orig) {
+    index = CustomData_get_layer(&me->pdata, CD_ORIGINDEX);
+    for (i = 0; i < me->totpoly; i++) {
+      index[i] = i;
     }
   }
-  bm->elem_index_dirty &= ~(BM_FACE | BM_LOOP);
+  MEM_freeN(elems);
+  MEM_freeN(loop_elems);
 
   me->cd_flag = BM_mesh_cd_flag_from_bmesh(bm);
 }
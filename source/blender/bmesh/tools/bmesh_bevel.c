@@ -31,6 +31,7 @@
 #include "BLI_array.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_curveprofile.h"
@@ -2119,6 +2120,24 @@ static void calculate_profile_segments(const Profile *profile,
  * the coordinate values for the power of 2 >= bp->seg, because the ADJ pattern needs power-of-2
  * boundaries during construction.
  */
+/**
+ * Allocate the arrays for the profile points, if they aren't already.
+ */
+static void profile_points_ensure(BevelParams *bp, Profile *pro)
+{
+  if (pro->prof_co != NULL) {
+    return;
+  }
+  pro->prof_co = (float *)BLI_memarena_alloc(bp->mem_arena, sizeof(float[3]) * (bp->seg + 1));
+  if (bp->seg != bp->pro_spacing.seg_2) {
+    pro->prof_co_2 = (float *)BLI_memarena_alloc(bp->mem_arena,
+                                                 sizeof(float[3]) * (bp->pro_spacing.seg_2 + 1));
+  }
+  else {
+    pro->prof_co_2 = pro->prof_co;
+  }
+}
+
 static void calculate_profile(BevelParams *bp, BoundVert *bndv, bool reversed, bool miter)
 {
   Profile *pro = &bndv->profile;
@@ -2129,16 +2148,7 @@ static void calculate_profile(BevelParams *bp, BoundVert *bndv, bool reversed, b
   }
 
   bool need_2 = bp->seg != bp->pro_spacing.seg_2;
-  if (pro->prof_co == NULL) {
-    pro->prof_co = (float *)BLI_memarena_alloc(bp->mem_arena, sizeof(float[3]) * (bp->seg + 1));
-    if (need_2) {
-      pro->prof_co_2 = (float *)BLI_memarena_alloc(bp->mem_arena,
-                                                   sizeof(float[3]) * (bp->pro_spacing.seg_2 + 1));
-    }
-    else {
-      pro->prof_co_2 = pro->prof_co;
-    }
-  }
+  profile_points_ensure(bp, pro);
 
   bool use_map;
   float map[4][4];
@@ -5686,6 +5696,88 @@ static void bevel_vert_two_edges(BevelParams *bp, BMesh *bm, BevVert *bv)
   }
 }
 
+/* Find the two beveled BoundVerts of a BevVert where two beveled edges are welded together. */
+static void find_weld_bound_verts(BevVert *bv, BoundVert **r_weld1, BoundVert **r_weld2)
+{
+  *r_weld1 = NULL;
+  *r_weld2 = NULL;
+  BoundVert *bndv = bv->vmesh->boundstart;
+  do {
+    if (bndv->ebev) {
+      if (!*r_weld1) {
+        *r_weld1 = bndv;
+      }
+      else { /* Get the last of the two BoundVerts. */
+        *r_weld2 = bndv;
+      }
+    }
+  } while ((bndv = bndv->next) != bv->vmesh->boundstart);
+}
+
+typedef struct BevelProfilesData {
+  BevelParams *bp;
+  BevVert **bevverts;
+} BevelProfilesData;
+
+static void bevel_calculate_profiles_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BevelProfilesData *data = userdata;
+  BevelParams *bp = data->bp;
+  BevVert *bv = data->bevverts[i];
+  VMesh *vm = bv->vmesh;
+
+  if (vm->boundstart == NULL) {
+    return;
+  }
+
+  /* Move profile planes if this is a weld case. */
+  if ((bv->selcount == 2) && (vm->count == 2)) {
+    BoundVert *weld1, *weld2;
+    find_weld_bound_verts(bv, &weld1, &weld2);
+    if (weld2) {
+      set_profile_params(bp, bv, weld1);
+      set_profile_params(bp, bv, weld2);
+      move_weld_profile_planes(bv, weld1, weld2);
+    }
+  }
+
+  calculate_vm_profiles(bp, bv, vm);
+}
+
+/**
+ * Calculate the profiles of all the BoundVerts, which only depend on the final boundary of their
+ * own BevVert, so it's done in parallel before any of the vertex meshes are built.
+ * It's simpler to calculate all profiles only once at a single moment, the last point before
+ * actual mesh verts are created.
+ */
+static void bevel_calculate_profiles(BevelParams *bp, BevVert **bevverts, const int bevverts_len)
+{
+  /* The memory arena isn't thread-safe, allocate the profile points up front. */
+  if (bp->seg > 1) {
+    for (int i = 0; i < bevverts_len; i++) {
+      VMesh *vm = bevverts[i]->vmesh;
+      if (vm->boundstart == NULL) {
+        continue;
+      }
+      BoundVert *bndv = vm->boundstart;
+      do {
+        profile_points_ensure(bp, &bndv->profile);
+      } while ((bndv = bndv->next) != vm->boundstart);
+    }
+  }
+
+  BevelProfilesData data = {
+      .bp = bp,
+      .bevverts = bevverts,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  BLI_task_parallel_range(0, bevverts_len, &data, bevel_calculate_profiles_cb, &settings);
+}
+
 /* Given that the boundary is built, now make the actual BMVerts
  * for the boundary and the interior of the vertex mesh. */
 static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
@@ -5712,24 +5804,12 @@ static void build_vmesh(BevelParams *bp, BMesh *bm, BevVert *bv)
     copy_v3_v3(mesh_vert(vm, i, 0, 0)->co, bndv->nv.co); /* Mesh NewVert to boundary NewVert. */
     create_mesh_bmvert(bm, vm, i, 0, 0, bv->v);          /* Create BMVert for that NewVert. */
     bndv->nv.v = mesh_vert(vm, i, 0, 0)->v; /* Use the BMVert for the BoundVert's NewVert. */
-
-    /* Find boundverts and move profile planes if this is a weld case. */
-    if (weld && bndv->ebev) {
-      if (!weld1) {
-        weld1 = bndv;
-      }
-      else { /* Get the last of the two BoundVerts. */
-        weld2 = bndv;
-        set_profile_params(bp, bv, weld1);
-        set_profile_params(bp, bv, weld2);
-        move_weld_profile_planes(bv, weld1, weld2);
-      }
-    }
   } while ((bndv = bndv->next) != vm->boundstart);
 
-  /* It's simpler to calculate all profiles only once at a single moment, so keep just a single
-   * profile calculation here, the last point before actual mesh verts are created. */
-  calculate_vm_profiles(bp, bv, vm);
+  /* The profiles were already calculated by #bevel_calculate_profiles. */
+  if (weld) {
+    find_weld_bound_verts(bv, &weld1, &weld2);
+  }
 
   /* Create new vertices and place them based on the profiles. */
   /* Copy other ends to (i, 0, ns) for all i, and fill in profiles for edges. */
@@ -7383,35 +7463,83 @@ static float vertex_collide_offset(BevelParams *bp, EdgeHalf *ea)
  * before geometry collisions happen. If the offset changes as a result of this, adjust the current
  * edge offset specs to reflect this clamping, and store the new offset in bp.offset.
  */
-static void bevel_limit_offset(BevelParams *bp, BMesh *bm)
+typedef struct BevelLimitOffsetData {
+  BevelParams *bp;
+  BevVert **bevverts;
+  float offset_factor;
+} BevelLimitOffsetData;
+
+static void bevel_limit_offset_cb(void *__restrict userdata,
+                                  const int i,
+                                  const TaskParallelTLS *__restrict tls)
 {
-  float limited_offset = bp->offset;
-  BMIter iter;
-  BMVert *bmv;
-  BM_ITER_MESH (bmv, &iter, bm, BM_VERTS_OF_MESH) {
-    if (!BM_elem_flag_test(bmv, BM_ELEM_TAG)) {
-      continue;
-    }
-    BevVert *bv = find_bevvert(bp, bmv);
-    if (!bv) {
-      continue;
-    }
-    for (int i = 0; i < bv->edgecount; i++) {
-      EdgeHalf *eh = &bv->edges[i];
-      if (bp->affect_type == BEVEL_AFFECT_VERTICES) {
-        float collision_offset = vertex_collide_offset(bp, eh);
-        if (collision_offset < limited_offset) {
-          limited_offset = collision_offset;
-        }
+  BevelLimitOffsetData *data = userdata;
+  BevelParams *bp = data->bp;
+  BevVert *bv = data->bevverts[i];
+  float *limited_offset = tls->userdata_chunk;
+
+  for (int j = 0; j < bv->edgecount; j++) {
+    EdgeHalf *eh = &bv->edges[j];
+    if (bp->affect_type == BEVEL_AFFECT_VERTICES) {
+      float collision_offset = vertex_collide_offset(bp, eh);
+      if (collision_offset < *limited_offset) {
+        *limited_offset = collision_offset;
       }
-      else {
-        float collision_offset = geometry_collide_offset(bp, eh);
-        if (collision_offset < limited_offset) {
-          limited_offset = collision_offset;
-        }
+    }
+    else {
+      float collision_offset = geometry_collide_offset(bp, eh);
+      if (collision_offset < *limited_offset) {
+        *limited_offset = collision_offset;
       }
     }
   }
+}
+
+static void bevel_limit_offset_reduce(const void *__restrict UNUSED(userdata),
+                                      void *__restrict chunk_join,
+                                      void *__restrict chunk)
+{
+  float *limited_offset_join = chunk_join;
+  const float *limited_offset = chunk;
+  *limited_offset_join = min_ff(*limited_offset_join, *limited_offset);
+}
+
+static void bevel_limit_offset_apply_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BevelLimitOffsetData *data = userdata;
+  BevVert *bv = data->bevverts[i];
+  const float offset_factor = data->offset_factor;
+
+  for (int j = 0; j < bv->edgecount; j++) {
+    EdgeHalf *eh = &bv->edges[j];
+    eh->offset_l_spec *= offset_factor;
+    eh->offset_r_spec *= offset_factor;
+    eh->offset_l *= offset_factor;
+    eh->offset_r *= offset_factor;
+  }
+}
+
+/**
+ * Clamp the offset to avoid geometry collisions. The limit only depends on the initial
+ * boundaries, it's the minimum over all the BevVerts so the threaded result is deterministic.
+ */
+static void bevel_limit_offset(BevelParams *bp, BevVert **bevverts, const int bevverts_len)
+{
+  float limited_offset = bp->offset;
+  BevelLimitOffsetData data = {
+      .bp = bp,
+      .bevverts = bevverts,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 64;
+  settings.userdata_chunk = &limited_offset;
+  settings.userdata_chunk_size = sizeof(limited_offset);
+  settings.func_reduce = bevel_limit_offset_reduce;
+  BLI_task_parallel_range(0, bevverts_len, &data, bevel_limit_offset_cb, &settings);
 
   if (limited_offset < bp->offset) {
     /* All current offset specs have some number times bp->offset,
@@ -7419,23 +7547,10 @@ static void bevel_limit_offset(BevelParams *bp, BMesh *bm)
      * of the offset to have the effect of recalculating the specs
      * with the new limited_offset.
      */
-    float offset_factor = limited_offset / bp->offset;
-    BM_ITER_MESH (bmv, &iter, bm, BM_VERTS_OF_MESH) {
-      if (!BM_elem_flag_test(bmv, BM_ELEM_TAG)) {
-        continue;
-      }
-      BevVert *bv = find_bevvert(bp, bmv);
-      if (!bv) {
-        continue;
-      }
-      for (int i = 0; i < bv->edgecount; i++) {
-        EdgeHalf *eh = &bv->edges[i];
-        eh->offset_l_spec *= offset_factor;
-        eh->offset_r_spec *= offset_factor;
-        eh->offset_l *= offset_factor;
-        eh->offset_r *= offset_factor;
-      }
-    }
+    data.offset_factor = limited_offset / bp->offset;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 1024;
+    BLI_task_parallel_range(0, bevverts_len, &data, bevel_limit_offset_apply_cb, &settings);
     bp->offset = limited_offset;
   }
 }
@@ -7563,28 +7678,30 @@ void BM_mesh_bevel(BMesh *bm,
 
   math_layer_info_init(&bp, bm);
 
+  /* Beveled vertices in the order they're constructed in, to iterate over them in parallel. */
+  BevVert **bevverts = MEM_mallocN(sizeof(*bevverts) * bm->totvert, __func__);
+  int bevverts_len = 0;
+
   /* Analyze input vertices, sorting edges and assigning initial new vertex positions. */
   BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
     if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
       bv = bevel_vert_construct(bm, &bp, v);
-      if (!limit_offset && bv) {
-        build_boundary(&bp, bv, true);
+      if (bv) {
+        bevverts[bevverts_len++] = bv;
+        if (!limit_offset) {
+          build_boundary(&bp, bv, true);
+        }
       }
     }
   }
 
   /* Perhaps clamp offset to avoid geometry collisions. */
   if (limit_offset) {
-    bevel_limit_offset(&bp, bm);
+    bevel_limit_offset(&bp, bevverts, bevverts_len);
 
     /* Assign initial new vertex positions. */
-    BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-      if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
-        bv = find_bevvert(&bp, v);
-        if (bv) {
-          build_boundary(&bp, bv, true);
-        }
-      }
+    for (int i = 0; i < bevverts_len; i++) {
+      build_boundary(&bp, bevverts[i], true);
     }
   }
 
@@ -7603,14 +7720,11 @@ void BM_mesh_bevel(BMesh *bm,
   }
 
   /* Build the meshes around vertices, now that positions are final. */
-  BM_ITER_MESH (v, &iter, bm, BM_VERTS_OF_MESH) {
-    if (BM_elem_flag_test(v, BM_ELEM_TAG)) {
-      bv = find_bevvert(&bp, v);
-      if (bv) {
-        build_vmesh(&bp, bm, bv);
-      }
-    }
+  bevel_calculate_profiles(&bp, bevverts, bevverts_len);
+  for (int i = 0; i < bevverts_len; i++) {
+    build_vmesh(&bp, bm, bevverts[i]);
   }
+  MEM_freeN(bevverts);
 
   /* Build polygons for edges. */
   if (bp.affect_type != BEVEL_AFFECT_VERTICES) {
@@ -32,6 +32,7 @@
 #include "BLI_polyfill_2d.h"
 #include "BLI_polyfill_2d_beautify.h"
 #include "BLI_quadric.h"
+#include "BLI_task.h"
 #include "BLI_utildefines_stack.h"
 
 #include "BKE_customdata.h"
@@ -67,6 +68,9 @@
 #define OPTIMIZE_EPS 1e-8
 #define COST_INVALID FLT_MAX
 
+/* Below this many faces or edges per thread, building the initial data isn't threaded. */
+#define DECIM_MIN_ITER_PER_THREAD 1024
+
 typedef enum CD_UseFlag {
   CD_DO_VERT = (1 << 0),
   CD_DO_EDGE = (1 << 1),
@@ -76,62 +80,110 @@ typedef enum CD_UseFlag {
 /* BMesh Helper Functions
  * ********************** */
 
+typedef struct BuildQuadricsData {
+  BMesh *bm;
+  /* Face and edge index aligned quadrics, edges only have a quadric when on the boundary. */
+  Quadric *fquadrics;
+  Quadric *equadrics;
+  bool *equadrics_valid;
+} BuildQuadricsData;
+
+static void bm_decim_build_quadrics_face_cb(void *__restrict userdata,
+                                            const int i,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BuildQuadricsData *data = userdata;
+  BMFace *f = BM_face_at_index(data->bm, i);
+
+  float center[3];
+  double plane_db[4];
+
+  BM_face_calc_center_median(f, center);
+  copy_v3db_v3fl(plane_db, f->no);
+  plane_db[3] = -dot_v3db_v3fl(plane_db, center);
+
+  BLI_quadric_from_plane(&data->fquadrics[i], plane_db);
+}
+
+static void bm_decim_build_quadrics_edge_cb(void *__restrict userdata,
+                                            const int i,
+                                            const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BuildQuadricsData *data = userdata;
+  BMEdge *e = BM_edge_at_index(data->bm, i);
+
+  data->equadrics_valid[i] = false;
+
+  /* boundary edges */
+  if (UNLIKELY(BM_edge_is_boundary(e))) {
+    float edge_vector[3];
+    float edge_plane[3];
+    double edge_plane_db[4];
+    sub_v3_v3v3(edge_vector, e->v2->co, e->v1->co);
+    BMFace *f = e->l->f;
+
+    cross_v3_v3v3(edge_plane, edge_vector, f->no);
+    copy_v3db_v3fl(edge_plane_db, edge_plane);
+
+    if (normalize_v3_db(edge_plane_db) > (double)FLT_EPSILON) {
+      Quadric *q = &data->equadrics[i];
+      float center[3];
+
+      mid_v3_v3v3(center, e->v1->co, e->v2->co);
+
+      edge_plane_db[3] = -dot_v3db_v3fl(edge_plane_db, center);
+      BLI_quadric_from_plane(q, edge_plane_db);
+      BLI_quadric_mul(q, BOUNDARY_PRESERVE_WEIGHT);
+      data->equadrics_valid[i] = true;
+    }
+  }
+}
+
 /**
  * \param vquadrics: must be calloc'd
+ *
+ * The quadrics of faces and boundary edges are calculated in parallel,
+ * then accumulated into the vertices in order, so the result doesn't depend on threading.
  */
 static void bm_decim_build_quadrics(BMesh *bm, Quadric *vquadrics)
 {
-  BMIter iter;
-  BMFace *f;
-  BMEdge *e;
-
-  BM_ITER_MESH (f, &iter, bm, BM_FACES_OF_MESH) {
+  BuildQuadricsData data = {
+      .bm = bm,
+      .fquadrics = MEM_mallocN(sizeof(Quadric) * bm->totface, __func__),
+      .equadrics = MEM_mallocN(sizeof(Quadric) * bm->totedge, __func__),
+      .equadrics_valid = MEM_mallocN(sizeof(bool) * bm->totedge, __func__),
+  };
+
+  BM_mesh_elem_table_ensure(bm, BM_EDGE | BM_FACE);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = DECIM_MIN_ITER_PER_THREAD;
+  BLI_task_parallel_range(0, bm->totface, &data, bm_decim_build_quadrics_face_cb, &settings);
+  BLI_task_parallel_range(0, bm->totedge, &data, bm_decim_build_quadrics_edge_cb, &settings);
+
+  for (int i = 0; i < bm->totface; i++) {
+    BMFace *f = BM_face_at_index(bm, i);
     BMLoop *l_first;
     BMLoop *l_iter;
 
-    float center[3];
-    double plane_db[4];
-    Quadric q;
-
-    BM_face_calc_center_median(f, center);
-    copy_v3db_v3fl(plane_db, f->no);
-    plane_db[3] = -dot_v3db_v3fl(plane_db, center);
-
-    BLI_quadric_from_plane(&q, plane_db);
-
     l_iter = l_first = BM_FACE_FIRST_LOOP(f);
     do {
-      BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(l_iter->v)], &q);
+      BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(l_iter->v)], &data.fquadrics[i]);
     } while ((l_iter = l_iter->next) != l_first);
   }
 
-  /* boundary edges */
-  BM_ITER_MESH (e, &iter, bm, BM_EDGES_OF_MESH) {
-    if (UNLIKELY(BM_edge_is_boundary(e))) {
-      float edge_vector[3];
-      float edge_plane[3];
-      double edge_plane_db[4];
-      sub_v3_v3v3(edge_vector, e->v2->co, e->v1->co);
-      f = e->l->f;
-
-      cross_v3_v3v3(edge_plane, edge_vector, f->no);
-      copy_v3db_v3fl(edge_plane_db, edge_plane);
-
-      if (normalize_v3_db(edge_plane_db) > (double)FLT_EPSILON) {
-        Quadric q;
-        float center[3];
-
-        mid_v3_v3v3(center, e->v1->co, e->v2->co);
-
-        edge_plane_db[3] = -dot_v3db_v3fl(edge_plane_db, center);
-        BLI_quadric_from_plane(&q, edge_plane_db);
-        BLI_quadric_mul(&q, BOUNDARY_PRESERVE_WEIGHT);
-
-        BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(e->v1)], &q);
-        BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(e->v2)], &q);
-      }
+  for (int i = 0; i < bm->totedge; i++) {
+    if (data.equadrics_valid[i]) {
+      BMEdge *e = BM_edge_at_index(bm, i);
+      BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(e->v1)], &data.equadrics[i]);
+      BLI_quadric_add_qu_qu(&vquadrics[BM_elem_index_get(e->v2)], &data.equadrics[i]);
     }
   }
+
+  MEM_freeN(data.fquadrics);
+  MEM_freeN(data.equadrics);
+  MEM_freeN(data.equadrics_valid);
 }
 
 static void bm_decim_calc_target_co_db(BMEdge *e, double optimize_co[3], const Quadric *vquadrics)
@@ -236,12 +288,16 @@ static float bm_decim_build_edge_cost_single__topology(BMEdge *e)
 
 #endif /* USE_TOPOLOGY_FALLBACK */
 
-static void bm_decim_build_edge_cost_single(BMEdge *e,
-                                            const Quadric *vquadrics,
-                                            const float *vweights,
-                                            const float vweight_factor,
-                                            Heap *eheap,
-                                            HeapNode **eheap_table)
+/**
+ * Calculate the cost of collapsing \a e.
+ *
+ * \return false when the edge shouldn't be collapsed.
+ */
+static bool bm_decim_calc_edge_cost(BMEdge *e,
+                                    const Quadric *vquadrics,
+                                    const float *vweights,
+                                    const float vweight_factor,
+                                    float *r_cost)
 {
   float cost;
 
@@ -322,10 +378,27 @@ static void bm_decim_build_edge_cost_single(BMEdge *e,
     }
   }
 
-  BLI_heap_insert_or_update(eheap, &eheap_table[BM_elem_index_get(e)], cost, e);
-  return;
+  *r_cost = cost;
+  return true;
 
 clear:
+  return false;
+}
+
+static void bm_decim_build_edge_cost_single(BMEdge *e,
+                                            const Quadric *vquadrics,
+                                            const float *vweights,
+                                            const float vweight_factor,
+                                            Heap *eheap,
+                                            HeapNode **eheap_table)
+{
+  float cost;
+
+  if (bm_decim_calc_edge_cost(e, vquadrics, vweights, vweight_factor, &cost)) {
+    BLI_heap_insert_or_update(eheap, &eheap_table[BM_elem_index_get(e)], cost, e);
+    return;
+  }
+
   if (eheap_table[BM_elem_index_get(e)]) {
     BLI_heap_remove(eheap, eheap_table[BM_elem_index_get(e)]);
   }
@@ -340,6 +413,29 @@ static void bm_decim_invalid_edge_cost_single(BMEdge *e, Heap *eheap, HeapNode *
   eheap_table[BM_elem_index_get(e)] = BLI_heap_insert(eheap, COST_INVALID, e);
 }
 
+typedef struct BuildEdgeCostData {
+  BMesh *bm;
+  const Quadric *vquadrics;
+  const float *vweights;
+  float vweight_factor;
+  float *costs;
+  bool *costs_valid;
+} BuildEdgeCostData;
+
+static void bm_decim_build_edge_cost_cb(void *__restrict userdata,
+                                        const int i,
+                                        const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  BuildEdgeCostData *data = userdata;
+  BMEdge *e = BM_edge_at_index(data->bm, i);
+  data->costs_valid[i] = bm_decim_calc_edge_cost(
+      e, data->vquadrics, data->vweights, data->vweight_factor, &data->costs[i]);
+}
+
+/**
+ * Costs are calculated in parallel, edges are then inserted into the heap in order,
+ * so the collapse order doesn't depend on threading.
+ */
 static void bm_decim_build_edge_cost(BMesh *bm,
                                      const Quadric *vquadrics,
                                      const float *vweights,
@@ -347,15 +443,32 @@ static void bm_decim_build_edge_cost(BMesh *bm,
                                      Heap *eheap,
                                      HeapNode **eheap_table)
 {
-  BMIter iter;
-  BMEdge *e;
-  uint i;
-
-  BM_ITER_MESH_INDEX (e, &iter, bm, BM_EDGES_OF_MESH, i) {
+  BuildEdgeCostData data = {
+      .bm = bm,
+      .vquadrics = vquadrics,
+      .vweights = vweights,
+      .vweight_factor = vweight_factor,
+      .costs = MEM_mallocN(sizeof(float) * bm->totedge, __func__),
+      .costs_valid = MEM_mallocN(sizeof(bool) * bm->totedge, __func__),
+  };
+
+  BM_mesh_elem_table_ensure(bm, BM_EDGE);
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = DECIM_MIN_ITER_PER_THREAD;
+  BLI_task_parallel_range(0, bm->totedge, &data, bm_decim_build_edge_cost_cb, &settings);
+
+  for (int i = 0; i < bm->totedge; i++) {
     /* keep sanity check happy */
     eheap_table[i] = NULL;
-    bm_decim_build_edge_cost_single(e, vquadrics, vweights, vweight_factor, eheap, eheap_table);
+    if (data.costs_valid[i]) {
+      BLI_heap_insert_or_update(eheap, &eheap_table[i], data.costs[i], BM_edge_at_index(bm, i));
+    }
   }
+
+  MEM_freeN(data.costs);
+  MEM_freeN(data.costs_valid);
 }
 
 #ifdef USE_SYMMETRY
@@ -27,6 +27,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_scene_types.h"
@@ -201,7 +202,13 @@ static PTCacheBaker *ptcache_baker_create(bContext *C, wmOperator *op, bool all)
   baker->anim_init = 0;
   baker->quick_step = 1;
 
-  if (!all) {
+  if (all) {
+    baker->concurrent_bakes = RNA_int_get(op->ptr, "concurrent_bakes");
+    if (baker->concurrent_bakes == 0) {
+      baker->concurrent_bakes = BLI_system_thread_count();
+    }
+  }
+  else {
     PointerRNA ptr = CTX_data_pointer_get_type(C, "point_cache", &RNA_PointCache);
     Object *ob = (Object *)ptr.owner_id;
     PointCache *cache = ptr.data;
@@ -318,6 +325,16 @@ void PTCACHE_OT_bake_all(wmOperatorType *ot)
   ot->flag = OPTYPE_REGISTER | OPTYPE_UNDO;
 
   RNA_def_boolean(ot->srna, "bake", 1, "Bake", "");
+  RNA_def_int(ot->srna,
+              "concurrent_bakes",
+              1,
+              0,
+              INT_MAX,
+              "Concurrent Bakes",
+              "Number of independent caches to bake at the same time, each on its own thread "
+              "(0 for the number of system threads)",
+              0,
+              64);
 }
 void PTCACHE_OT_free_bake_all(wmOperatorType *ot)
 {
@@ -55,6 +55,8 @@
 
 #include "IMB_imbuf_types.h"
 
+#include "CLG_log.h"
+
 #include "paint_intern.h"
 #include "sculpt_intern.h"
 
@@ -67,6 +69,11 @@
 #  include "PIL_time_utildefines.h"
 #endif
 
+/* Level 1 logs the time of every dab and of the whole stroke, level 2 also logs the stroke
+ * samples as JSON, which can be passed to the `stroke` property of the operator to replay the
+ * stroke (see `tests/performance/tests/sculpt.py`). */
+static CLG_LogRef LOG = {"ed.paint.stroke"};
+
 typedef struct PaintSample {
   float mouse[2];
   float pressure;
@@ -131,6 +138,10 @@ typedef struct PaintStroke {
   bool constrain_line;
   float constrained_pos[2];
 
+  /* Number of dabs and the time spent in their update step, for logging. */
+  int tot_dabs;
+  double dabs_time;
+
   StrokeGetLocation get_location;
   StrokeTestStart test_start;
   StrokeUpdateStep update_step;
@@ -520,6 +531,55 @@ static bool paint_stroke_use_jitter(ePaintMode mode, Brush *brush, bool invert)
   return use_jitter;
 }
 
+/* Log a stroke sample in a form that can be replayed by the sculpt performance tests. */
+static void paint_stroke_log_sample(PointerRNA *itemptr)
+{
+  float location[3], mouse[2], mouse_event[2];
+  RNA_float_get_array(itemptr, "location", location);
+  RNA_float_get_array(itemptr, "mouse", mouse);
+  RNA_float_get_array(itemptr, "mouse_event", mouse_event);
+
+  CLOG_INFO(&LOG,
+            2,
+            "sample {\"location\": [%.9g, %.9g, %.9g], \"mouse\": [%.9g, %.9g], "
+            "\"mouse_event\": [%.9g, %.9g], \"size\": %.9g, \"pressure\": %.9g, "
+            "\"pen_flip\": %s, \"x_tilt\": %.9g, \"y_tilt\": %.9g, \"time\": %.9g, "
+            "\"is_start\": %s}",
+            location[0],
+            location[1],
+            location[2],
+            mouse[0],
+            mouse[1],
+            mouse_event[0],
+            mouse_event[1],
+            RNA_float_get(itemptr, "size"),
+            RNA_float_get(itemptr, "pressure"),
+            RNA_boolean_get(itemptr, "pen_flip") ? "true" : "false",
+            RNA_float_get(itemptr, "x_tilt"),
+            RNA_float_get(itemptr, "y_tilt"),
+            RNA_float_get(itemptr, "time"),
+            RNA_boolean_get(itemptr, "is_start") ? "true" : "false");
+}
+
+/* Apply a single dab of the stroke, timing it when stroke logging is enabled. */
+static void paint_stroke_update_step(bContext *C, PaintStroke *stroke, PointerRNA *itemptr)
+{
+  if (!CLOG_CHECK(&LOG, 1)) {
+    stroke->update_step(C, stroke, itemptr);
+    return;
+  }
+
+  paint_stroke_log_sample(itemptr);
+
+  const double start_time = PIL_check_seconds_timer();
+  stroke->update_step(C, stroke, itemptr);
+  const double dab_time = PIL_check_seconds_timer() - start_time;
+
+  CLOG_INFO(&LOG, 1, "dab %d: %f s", stroke->tot_dabs, dab_time);
+  stroke->tot_dabs++;
+  stroke->dabs_time += dab_time;
+}
+
 /* Put the location of the next stroke dot into the stroke RNA and apply it to the mesh */
 static void paint_brush_stroke_add_step(bContext *C,
                                         wmOperator *op,
@@ -630,7 +690,7 @@ static void paint_brush_stroke_add_step(bContext *C,
     RNA_float_set(&itemptr, "x_tilt", stroke->x_tilt);
     RNA_float_set(&itemptr, "y_tilt", stroke->y_tilt);
 
-    stroke->update_step(C, stroke, &itemptr);
+    paint_stroke_update_step(C, stroke, &itemptr);
 
     /* don't record this for now, it takes up a lot of memory when doing long
      * strokes with small brush size, and operators have register disabled */
@@ -994,6 +1054,15 @@ static void stroke_done(bContext *C, wmOperator *op)
     ups->brush_rotation_sec = 0.0f;
   }
 
+  if (stroke->tot_dabs) {
+    CLOG_INFO(&LOG,
+              1,
+              "stroke: %d dabs in %f s (%f s per dab)",
+              stroke->tot_dabs,
+              stroke->dabs_time,
+              stroke->dabs_time / stroke->tot_dabs);
+  }
+
   if (stroke->stroke_started) {
     if (stroke->redraw) {
       stroke->redraw(C, stroke, true);
@@ -1612,7 +1681,7 @@ int paint_stroke_exec(bContext *C, wmOperator *op)
 
   if (stroke->stroke_started) {
     RNA_BEGIN (op->ptr, itemptr, "stroke") {
-      stroke->update_step(C, stroke, &itemptr);
+      paint_stroke_update_step(C, stroke, &itemptr);
     }
     RNA_END;
   }
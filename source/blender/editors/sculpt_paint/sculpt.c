@@ -1787,6 +1787,153 @@ SculptBrushTestFn SCULPT_brush_test_init_with_falloff_shape(SculptSession *ss,
   return sculpt_brush_test_sq_fn;
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Brush Node Vertices
+ *
+ * Fast path for brushes on #PBVH_FACES and #PBVH_GRIDS. Instead of testing every vertex of a node
+ * through #BKE_pbvh_vertex_iter_begin, which branches on the PBVH type for every vertex, the
+ * distances to the brush are computed in a tight loop over a contiguous array of positions. Only
+ * the vertices inside of the brush are visited afterwards, in the same order and with the same
+ * distances as #SCULPT_brush_test_init_with_falloff_shape gives.
+ * \{ */
+
+static void sculpt_brush_node_verts_tls_ensure(SculptBrushNodeVertsTLS *tls, const int totvert)
+{
+  if (tls->size >= totvert) {
+    return;
+  }
+  MEM_SAFE_FREE(tls->co);
+  MEM_SAFE_FREE(tls->dist_sq);
+  MEM_SAFE_FREE(tls->node_index);
+  MEM_SAFE_FREE(tls->vert_index);
+  tls->co = MEM_malloc_arrayN(totvert, sizeof(float[3]), __func__);
+  tls->dist_sq = MEM_malloc_arrayN(totvert, sizeof(float), __func__);
+  tls->node_index = MEM_malloc_arrayN(totvert, sizeof(int), __func__);
+  tls->vert_index = MEM_malloc_arrayN(totvert, sizeof(int), __func__);
+  tls->size = totvert;
+}
+
+static void sculpt_brush_node_verts_tls_free(const void *__restrict UNUSED(userdata),
+                                             void *__restrict tls_v)
+{
+  SculptBrushNodeVertsTLS *tls = tls_v;
+  MEM_SAFE_FREE(tls->co);
+  MEM_SAFE_FREE(tls->dist_sq);
+  MEM_SAFE_FREE(tls->node_index);
+  MEM_SAFE_FREE(tls->vert_index);
+}
+
+void SCULPT_brush_node_verts_parallel_range_settings(TaskParallelSettings *settings,
+                                                     SculptBrushNodeVertsTLS *tls)
+{
+  memset(tls, 0, sizeof(*tls));
+  settings->userdata_chunk = tls;
+  settings->userdata_chunk_size = sizeof(*tls);
+  settings->func_free = sculpt_brush_node_verts_tls_free;
+}
+
+/**
+ * Find the vertices of the node inside of the brush.
+ *
+ * \param orig_co: Positions to test instead of the current ones (the original coordinates of
+ * the node), NULL to use the current positions.
+ * \param tls: Scratch arrays the result points into, valid until the next node of the thread.
+ * \return false when the fast path is not supported for the PBVH type.
+ */
+bool SCULPT_brush_node_verts_init(SculptSession *ss,
+                                  PBVHNode *node,
+                                  const SculptBrushTest *test,
+                                  const char falloff_shape,
+                                  const float (*orig_co)[3],
+                                  SculptBrushNodeVertsTLS *tls,
+                                  SculptBrushNodeVerts *r_verts)
+{
+  if (BKE_pbvh_type(ss->pbvh) == PBVH_BMESH) {
+    return false;
+  }
+
+  PBVHVertexIter *vi = &r_verts->iter;
+  pbvh_vertex_iter_init(ss->pbvh, node, vi, PBVH_ITER_UNIQUE);
+  const int grid_area = vi->key.grid_area;
+  const int totvert = vi->grids ? vi->totgrid * grid_area : vi->totvert;
+  sculpt_brush_node_verts_tls_ensure(tls, totvert);
+
+  if (orig_co) {
+    r_verts->co = orig_co;
+  }
+  else {
+    if (vi->grids) {
+      for (int g = 0; g < vi->totgrid; g++) {
+        CCGElem *grid = vi->grids[vi->grid_indices[g]];
+        for (int i = 0; i < grid_area; i++) {
+          copy_v3_v3(tls->co[g * grid_area + i], CCG_elem_offset_co(&vi->key, grid, i));
+        }
+      }
+    }
+    else {
+      for (int i = 0; i < totvert; i++) {
+        copy_v3_v3(tls->co[i], vi->mverts[vi->vert_indices[i]].co);
+      }
+    }
+    r_verts->co = (const float(*)[3])tls->co;
+  }
+
+  const float(*co)[3] = r_verts->co;
+  float *dist_sq = tls->dist_sq;
+  if (falloff_shape == PAINT_FALLOFF_SHAPE_SPHERE) {
+    for (int i = 0; i < totvert; i++) {
+      dist_sq[i] = len_squared_v3v3(co[i], test->location);
+    }
+  }
+  else {
+    for (int i = 0; i < totvert; i++) {
+      float co_proj[3];
+      closest_to_plane_normalized_v3(co_proj, test->plane_view, co[i]);
+      dist_sq[i] = len_squared_v3v3(co_proj, test->location);
+    }
+  }
+
+  /* Keep the vertices inside of the brush, compacting the arrays in place. */
+  int *node_index = tls->node_index;
+  int *vert_index = tls->vert_index;
+  int tot = 0;
+  for (int i = 0; i < totvert; i++) {
+    if (dist_sq[i] > test->radius_squared) {
+      continue;
+    }
+    int index;
+    if (vi->grids) {
+      const int g = i / grid_area;
+      const BLI_bitmap *gh = vi->grid_hidden[vi->grid_indices[g]];
+      if (gh && BLI_BITMAP_TEST(gh, i - g * grid_area)) {
+        continue;
+      }
+      index = vi->grid_indices[g] * grid_area + (i - g * grid_area);
+    }
+    else {
+      index = vi->vert_indices[i];
+      if (vi->respect_hide && (vi->mverts[index].flag & ME_HIDE)) {
+        continue;
+      }
+    }
+    if (sculpt_brush_test_clipping(test, co[i])) {
+      continue;
+    }
+    node_index[tot] = i;
+    vert_index[tot] = index;
+    dist_sq[tot] = dist_sq[i];
+    tot++;
+  }
+
+  r_verts->totvert = tot;
+  r_verts->node_index = node_index;
+  r_verts->vert_index = vert_index;
+  r_verts->dist_sq = dist_sq;
+  return true;
+}
+
+/** \} */
+
 const float *SCULPT_brush_frontface_normal_from_falloff_shape(SculptSession *ss,
                                                               char falloff_shape)
 {
@@ -3278,6 +3425,37 @@ static void do_draw_brush_task_cb_ex(void *__restrict userdata,
       ss, &test, data->brush->falloff_shape);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
+  SculptBrushNodeVerts verts;
+  if (SCULPT_brush_node_verts_init(ss,
+                                   data->nodes[n],
+                                   &test,
+                                   data->brush->falloff_shape,
+                                   NULL,
+                                   tls->userdata_chunk,
+                                   &verts)) {
+    for (int i = 0; i < verts.totvert; i++) {
+      const int node_index = verts.node_index[i];
+      const short *no;
+      const float *fno;
+      SCULPT_brush_node_vert_normal_get(&verts, i, &no, &fno);
+
+      /* Offset vertex. */
+      const float fade = SCULPT_brush_strength_factor(ss,
+                                                      brush,
+                                                      verts.co[node_index],
+                                                      sqrtf(verts.dist_sq[i]),
+                                                      no,
+                                                      fno,
+                                                      SCULPT_brush_node_vert_mask_get(&verts, i),
+                                                      verts.vert_index[i],
+                                                      thread_id);
+
+      mul_v3_v3fl(proxy[node_index], offset, fade);
+      SCULPT_brush_node_vert_tag_update(&verts, i);
+    }
+    return;
+  }
+
   BKE_pbvh_vertex_iter_begin (ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE) {
     if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
       continue;
@@ -3329,8 +3507,10 @@ static void do_draw_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
       .offset = offset,
   };
 
+  SculptBrushNodeVertsTLS tls;
   TaskParallelSettings settings;
   BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+  SCULPT_brush_node_verts_parallel_range_settings(&settings, &tls);
   BLI_task_parallel_range(0, totnode, &data, do_draw_brush_task_cb_ex, &settings);
 }
 
@@ -3991,6 +4171,47 @@ static void do_grab_brush_task_cb_ex(void *__restrict userdata,
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
   const bool grab_silhouette = brush->flag2 & BRUSH_GRAB_SILHOUETTE;
+  float silhouette_test_dir[3];
+  if (grab_silhouette) {
+    normalize_v3_v3(silhouette_test_dir, grab_delta);
+    if (dot_v3v3(ss->cache->initial_normal, ss->cache->grab_delta_symmetry) < 0.0f) {
+      mul_v3_fl(silhouette_test_dir, -1.0f);
+    }
+  }
+
+  SculptBrushNodeVerts verts;
+  if (SCULPT_brush_node_verts_init(ss,
+                                   data->nodes[n],
+                                   &test,
+                                   data->brush->falloff_shape,
+                                   (const float(*)[3])orig_data.coords,
+                                   tls->userdata_chunk,
+                                   &verts)) {
+    for (int i = 0; i < verts.totvert; i++) {
+      const int node_index = verts.node_index[i];
+      const short *orig_no = orig_data.normals[node_index];
+      const float mask = SCULPT_brush_node_vert_mask_get(&verts, i);
+      float fade = bstrength * SCULPT_brush_strength_factor(ss,
+                                                            brush,
+                                                            verts.co[node_index],
+                                                            sqrtf(verts.dist_sq[i]),
+                                                            orig_no,
+                                                            NULL,
+                                                            mask,
+                                                            verts.vert_index[i],
+                                                            thread_id);
+
+      if (grab_silhouette) {
+        float vno[3];
+        normal_short_to_float_v3(vno, orig_no);
+        fade *= max_ff(dot_v3v3(vno, silhouette_test_dir), 0.0f);
+      }
+
+      mul_v3_v3fl(proxy[node_index], grab_delta, fade);
+      SCULPT_brush_node_vert_tag_update(&verts, i);
+    }
+    return;
+  }
 
   BKE_pbvh_vertex_iter_begin (ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE) {
     SCULPT_orig_vert_data_update(&orig_data, &vd);
@@ -4009,11 +4230,6 @@ static void do_grab_brush_task_cb_ex(void *__restrict userdata,
                                                           thread_id);
 
     if (grab_silhouette) {
-      float silhouette_test_dir[3];
-      normalize_v3_v3(silhouette_test_dir, grab_delta);
-      if (dot_v3v3(ss->cache->initial_normal, ss->cache->grab_delta_symmetry) < 0.0f) {
-        mul_v3_fl(silhouette_test_dir, -1.0f);
-      }
       float vno[3];
       normal_short_to_float_v3(vno, orig_data.no);
       fade *= max_ff(dot_v3v3(vno, silhouette_test_dir), 0.0f);
@@ -4048,8 +4264,10 @@ static void do_grab_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
       .grab_delta = grab_delta,
   };
 
+  SculptBrushNodeVertsTLS tls;
   TaskParallelSettings settings;
   BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+  SCULPT_brush_node_verts_parallel_range_settings(&settings, &tls);
   BLI_task_parallel_range(0, totnode, &data, do_grab_brush_task_cb_ex, &settings);
 }
 
@@ -40,6 +40,7 @@ struct AutomaskingCache;
 struct KeyBlock;
 struct Object;
 struct SculptUndoNode;
+struct TaskParallelSettings;
 struct bContext;
 
 enum ePaintSymmetryFlags;
@@ -869,6 +870,108 @@ float SCULPT_brush_strength_factor(struct SculptSession *ss,
                                    const int vertex_index,
                                    const int thread_id);
 
+/* Brush node vertices, a fast path to find the vertices of a node inside of the brush on
+ * #PBVH_FACES and #PBVH_GRIDS, see #SCULPT_brush_node_verts_init. */
+
+/**
+ * Per thread scratch arrays of #SculptBrushNodeVerts, grown to the largest node. Passed as
+ * #TaskParallelSettings.userdata_chunk, so that nodes don't allocate on every dab.
+ */
+typedef struct SculptBrushNodeVertsTLS {
+  float (*co)[3];
+  float *dist_sq;
+  int *node_index;
+  int *vert_index;
+  int size;
+} SculptBrushNodeVertsTLS;
+
+typedef struct SculptBrushNodeVerts {
+  PBVHVertexIter iter;
+
+  /* Positions of all vertices of the node, indexed by #PBVHVertexIter.i. */
+  const float (*co)[3];
+
+  /* Vertices inside of the brush. */
+  int totvert;
+  /* Index in the node, as #PBVHVertexIter.i (used for proxies and original data). */
+  int *node_index;
+  /* Index in the mesh or the grids, as #PBVHVertexIter.index. */
+  int *vert_index;
+  /* Squared distance to the brush, as #SculptBrushTest.dist. */
+  float *dist_sq;
+} SculptBrushNodeVerts;
+
+/* Use #SculptBrushNodeVertsTLS as thread local data of the parallel range over brush nodes. */
+void SCULPT_brush_node_verts_parallel_range_settings(struct TaskParallelSettings *settings,
+                                                     SculptBrushNodeVertsTLS *tls);
+bool SCULPT_brush_node_verts_init(SculptSession *ss,
+                                  PBVHNode *node,
+                                  const SculptBrushTest *test,
+                                  const char falloff_shape,
+                                  const float (*orig_co)[3],
+                                  SculptBrushNodeVertsTLS *tls,
+                                  SculptBrushNodeVerts *r_verts);
+
+BLI_INLINE struct CCGElem *SCULPT_brush_node_vert_grid_elem(const SculptBrushNodeVerts *verts,
+                                                            const int index)
+{
+  const CCGKey *key = &verts->iter.key;
+  const int g = verts->vert_index[index] / key->grid_area;
+  return CCG_elem_offset(key, verts->iter.grids[g], verts->vert_index[index] - g * key->grid_area);
+}
+
+/* Current position of a vertex inside of the brush, as #PBVHVertexIter.co. */
+BLI_INLINE float *SCULPT_brush_node_vert_co(const SculptBrushNodeVerts *verts, const int index)
+{
+  if (verts->iter.grids) {
+    return CCG_elem_co(&verts->iter.key, SCULPT_brush_node_vert_grid_elem(verts, index));
+  }
+  return verts->iter.mverts[verts->vert_index[index]].co;
+}
+
+/* Current normal of a vertex inside of the brush, as #PBVHVertexIter.no and fno. */
+BLI_INLINE void SCULPT_brush_node_vert_normal_get(const SculptBrushNodeVerts *verts,
+                                                  const int index,
+                                                  const short **r_no,
+                                                  const float **r_fno)
+{
+  if (verts->iter.grids) {
+    *r_no = NULL;
+    *r_fno = CCG_elem_no(&verts->iter.key, SCULPT_brush_node_vert_grid_elem(verts, index));
+  }
+  else {
+    *r_no = verts->iter.mverts[verts->vert_index[index]].no;
+    *r_fno = NULL;
+  }
+}
+
+/* Mask of a vertex inside of the brush, as #PBVHVertexIter.mask (NULL without a mask). */
+BLI_INLINE float *SCULPT_brush_node_vert_mask(const SculptBrushNodeVerts *verts, const int index)
+{
+  if (verts->iter.grids) {
+    if (!verts->iter.key.has_mask) {
+      return NULL;
+    }
+    return CCG_elem_mask(&verts->iter.key, SCULPT_brush_node_vert_grid_elem(verts, index));
+  }
+  return verts->iter.vmask ? &verts->iter.vmask[verts->vert_index[index]] : NULL;
+}
+
+BLI_INLINE float SCULPT_brush_node_vert_mask_get(const SculptBrushNodeVerts *verts,
+                                                 const int index)
+{
+  const float *mask = SCULPT_brush_node_vert_mask(verts, index);
+  return mask ? *mask : 0.0f;
+}
+
+BLI_INLINE void SCULPT_brush_node_vert_tag_update(const SculptBrushNodeVerts *verts,
+                                                  const int index)
+{
+  if (!verts->iter.grids) {
+    verts->iter.mverts[verts->vert_index[index]].flag |= ME_VERT_PBVH_UPDATE;
+  }
+}
+
 /* Tilts a normal by the x and y tilt values using the view axis. */
 void SCULPT_tilt_apply_to_normal(float r_normal[3],
                                  struct StrokeCache *cache,
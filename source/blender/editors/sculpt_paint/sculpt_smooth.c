@@ -311,6 +311,50 @@ static void do_smooth_brush_task_cb_ex(void *__restrict userdata,
 
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
+  SculptBrushNodeVerts verts;
+  if (SCULPT_brush_node_verts_init(ss,
+                                   data->nodes[n],
+                                   &test,
+                                   data->brush->falloff_shape,
+                                   NULL,
+                                   tls->userdata_chunk,
+                                   &verts)) {
+    for (int i = 0; i < verts.totvert; i++) {
+      const int vert_index = verts.vert_index[i];
+      float *co = SCULPT_brush_node_vert_co(&verts, i);
+      float *mask = SCULPT_brush_node_vert_mask(&verts, i);
+      const short *no;
+      const float *fno;
+      SCULPT_brush_node_vert_normal_get(&verts, i, &no, &fno);
+
+      const float fade = bstrength * SCULPT_brush_strength_factor(
+                                         ss,
+                                         brush,
+                                         co,
+                                         sqrtf(verts.dist_sq[i]),
+                                         no,
+                                         fno,
+                                         smooth_mask ? 0.0f : (mask ? *mask : 0.0f),
+                                         vert_index,
+                                         thread_id);
+      if (smooth_mask) {
+        float val = SCULPT_neighbor_mask_average(ss, vert_index) - *mask;
+        val *= fade * bstrength;
+        *mask += val;
+        CLAMP(*mask, 0.0f, 1.0f);
+      }
+      else {
+        float avg[3], val[3];
+        SCULPT_neighbor_coords_average_interior(ss, avg, vert_index);
+        sub_v3_v3v3(val, avg, co);
+        madd_v3_v3v3fl(val, co, val, fade);
+        SCULPT_clip(sd, ss, co, val);
+      }
+      SCULPT_brush_node_vert_tag_update(&verts, i);
+    }
+    return;
+  }
+
   BKE_pbvh_vertex_iter_begin (ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE) {
     if (!sculpt_brush_test_sq_fn(&test, vd.co)) {
       continue;
@@ -386,8 +430,10 @@ void SCULPT_smooth(Sculpt *sd,
         .strength = strength,
     };
 
+    SculptBrushNodeVertsTLS tls;
     TaskParallelSettings settings;
     BKE_pbvh_parallel_range_settings(&settings, true, totnode);
+    SCULPT_brush_node_verts_parallel_range_settings(&settings, &tls);
     BLI_task_parallel_range(0, totnode, &data, do_smooth_brush_task_cb_ex, &settings);
   }
 }
@@ -113,6 +113,9 @@ typedef struct UndoSculpt {
   ListBase nodes;
 
   size_t undo_size;
+
+  /* Object the nodes are pushed for, only during push, not valid afterwards! */
+  struct Object *object;
 } UndoSculpt;
 
 static UndoSculpt *sculpt_undo_get_nodes(void);
@@ -985,6 +988,7 @@ static SculptUndoNode *sculpt_undo_alloc_node_type(Object *object, SculptUndoTyp
   UndoSculpt *usculpt = sculpt_undo_get_nodes();
   BLI_addtail(&usculpt->nodes, unode);
   usculpt->undo_size += alloc_size;
+  usculpt->object = object;
 
   return unode;
 }
@@ -1400,6 +1404,281 @@ void SCULPT_undo_push_end(void)
   SCULPT_undo_push_end_ex(false);
 }
 
+/* -------------------------------------------------------------------- */
+/** \name Undo Node Compaction
+ *
+ * Nodes are pushed before the first modification of a PBVH node and store all of its vertices,
+ * while a stroke often only changes a few of them. Once the push is done, the vertices (or grids
+ * for multires) which still match the current state are removed from the nodes: swapping them on
+ * undo or redo wouldn't change anything.
+ * \{ */
+
+/* Stored array element size for the vertex data of the node type. */
+static size_t sculpt_undo_node_elem_size(const SculptUndoNode *unode)
+{
+  switch (unode->type) {
+    case SCULPT_UNDO_COORDS:
+      return sizeof(*unode->co);
+    case SCULPT_UNDO_MASK:
+      return sizeof(*unode->mask);
+    case SCULPT_UNDO_COLOR:
+      return sizeof(*unode->col);
+    default:
+      return 0;
+  }
+}
+
+static void *sculpt_undo_node_elem_data(SculptUndoNode *unode)
+{
+  switch (unode->type) {
+    case SCULPT_UNDO_COORDS:
+      return unode->co;
+    case SCULPT_UNDO_MASK:
+      return unode->mask;
+    case SCULPT_UNDO_COLOR:
+      return unode->col;
+    default:
+      return NULL;
+  }
+}
+
+static void sculpt_undo_node_elem_data_set(SculptUndoNode *unode, void *data)
+{
+  switch (unode->type) {
+    case SCULPT_UNDO_COORDS:
+      unode->co = data;
+      break;
+    case SCULPT_UNDO_MASK:
+      unode->mask = data;
+      break;
+    case SCULPT_UNDO_COLOR:
+      unode->col = data;
+      break;
+    default:
+      break;
+  }
+}
+
+/* Current value of a mesh vertex. */
+static const void *sculpt_undo_mesh_elem_current(const SculptSession *ss,
+                                                 const MVert *mvert,
+                                                 const SculptUndoNode *unode,
+                                                 const int vert)
+{
+  switch (unode->type) {
+    case SCULPT_UNDO_COORDS:
+      return mvert[vert].co;
+    case SCULPT_UNDO_MASK:
+      return &ss->vmask[vert];
+    case SCULPT_UNDO_COLOR:
+      return ss->vcol[vert].color;
+    default:
+      BLI_assert_unreachable();
+      return NULL;
+  }
+}
+
+static bool sculpt_undo_node_can_compact(const SculptSession *ss, const SculptUndoNode *unode)
+{
+  if (sculpt_undo_node_elem_data((SculptUndoNode *)unode) == NULL) {
+    return false;
+  }
+  /* Both the deformed and original coordinates are swapped, keep them in sync. */
+  if (unode->orig_co) {
+    return false;
+  }
+  if (unode->maxvert) {
+    if ((unode->type == SCULPT_UNDO_MASK && ss->vmask == NULL) ||
+        (unode->type == SCULPT_UNDO_COLOR && ss->vcol == NULL)) {
+      return false;
+    }
+    return ss->pbvh && BKE_pbvh_type(ss->pbvh) == PBVH_FACES && ss->totvert == unode->maxvert;
+  }
+  if (unode->maxgrid) {
+    /* Colors are not stored for grids. */
+    return ss->subdiv_ccg && unode->type != SCULPT_UNDO_COLOR &&
+           ss->subdiv_ccg->num_grids == unode->maxgrid &&
+           ss->subdiv_ccg->grid_size == unode->gridsize;
+  }
+  return false;
+}
+
+/* Returns the amount of bytes freed. */
+static size_t sculpt_undo_mesh_node_compact(const SculptSession *ss, SculptUndoNode *unode)
+{
+  const MVert *mvert = BKE_pbvh_get_verts(ss->pbvh);
+  const size_t elem_size = sculpt_undo_node_elem_size(unode);
+  char *data = sculpt_undo_node_elem_data(unode);
+  int totvert = 0;
+
+  for (int i = 0; i < unode->totvert; i++) {
+    const void *current = sculpt_undo_mesh_elem_current(ss, mvert, unode, unode->index[i]);
+    /* No need for float comparison here (memory is exactly equal or not). */
+    if (memcmp(data + elem_size * i, current, elem_size) == 0) {
+      continue;
+    }
+    if (totvert != i) {
+      memcpy(data + elem_size * totvert, data + elem_size * i, elem_size);
+      unode->index[totvert] = unode->index[i];
+    }
+    totvert++;
+  }
+
+  if (totvert == unode->totvert) {
+    return 0;
+  }
+
+  const size_t size_old = MEM_allocN_len(data) + MEM_allocN_len(unode->index);
+  if (totvert == 0) {
+    MEM_freeN(data);
+    MEM_freeN(unode->index);
+    sculpt_undo_node_elem_data_set(unode, NULL);
+    unode->index = NULL;
+    unode->totvert = 0;
+    return size_old;
+  }
+
+  data = MEM_reallocN(data, elem_size * (size_t)totvert);
+  sculpt_undo_node_elem_data_set(unode, data);
+  unode->index = MEM_reallocN(unode->index, sizeof(*unode->index) * (size_t)totvert);
+  unode->totvert = totvert;
+  return size_old - MEM_allocN_len(data) - MEM_allocN_len(unode->index);
+}
+
+static size_t sculpt_undo_grids_node_compact(const SculptSession *ss, SculptUndoNode *unode)
+{
+  const SubdivCCG *subdiv_ccg = ss->subdiv_ccg;
+  CCGKey key;
+  BKE_subdiv_ccg_key_top_level(&key, subdiv_ccg);
+
+  const size_t elem_size = sculpt_undo_node_elem_size(unode);
+  const size_t grid_data_size = elem_size * (size_t)key.grid_area;
+  char *data = sculpt_undo_node_elem_data(unode);
+  int totgrid = 0;
+
+  for (int j = 0; j < unode->totgrid; j++) {
+    CCGElem *grid = subdiv_ccg->grids[unode->grids[j]];
+    const char *grid_data = data + grid_data_size * j;
+    bool changed = false;
+
+    for (int i = 0; i < key.grid_area && !changed; i++) {
+      const void *current = (unode->type == SCULPT_UNDO_COORDS) ?
+                                (const void *)CCG_elem_offset_co(&key, grid, i) :
+                                (const void *)CCG_elem_offset_mask(&key, grid, i);
+      changed = memcmp(grid_data + elem_size * i, current, elem_size) != 0;
+    }
+
+    if (!changed) {
+      continue;
+    }
+    if (totgrid != j) {
+      memcpy(data + grid_data_size * totgrid, grid_data, grid_data_size);
+      unode->grids[totgrid] = unode->grids[j];
+    }
+    totgrid++;
+  }
+
+  if (totgrid == unode->totgrid) {
+    return 0;
+  }
+
+  const size_t size_old = MEM_allocN_len(data) + MEM_allocN_len(unode->grids);
+  if (totgrid == 0) {
+    MEM_freeN(data);
+    MEM_freeN(unode->grids);
+    sculpt_undo_node_elem_data_set(unode, NULL);
+    unode->grids = NULL;
+    unode->totgrid = 0;
+    return size_old;
+  }
+
+  data = MEM_reallocN(data, grid_data_size * (size_t)totgrid);
+  sculpt_undo_node_elem_data_set(unode, data);
+  unode->grids = MEM_reallocN(unode->grids, sizeof(*unode->grids) * (size_t)totgrid);
+  unode->totgrid = totgrid;
+  return size_old - MEM_allocN_len(data) - MEM_allocN_len(unode->grids);
+}
+
+typedef struct SculptUndoCompactData {
+  const SculptSession *ss;
+  SculptUndoNode **nodes;
+} SculptUndoCompactData;
+
+static void sculpt_undo_compact_task_cb(void *__restrict userdata,
+                                        const int n,
+                                        const TaskParallelTLS *__restrict tls)
+{
+  SculptUndoCompactData *data = userdata;
+  SculptUndoNode *unode = data->nodes[n];
+  size_t *freed_size = tls->userdata_chunk;
+
+  if (unode->maxvert) {
+    *freed_size += sculpt_undo_mesh_node_compact(data->ss, unode);
+  }
+  else {
+    *freed_size += sculpt_undo_grids_node_compact(data->ss, unode);
+  }
+}
+
+static void sculpt_undo_compact_reduce(const void *__restrict UNUSED(userdata),
+                                       void *__restrict chunk_join,
+                                       void *__restrict chunk)
+{
+  *(size_t *)chunk_join += *(size_t *)chunk;
+}
+
+static void sculpt_undo_compact_nodes(UndoSculpt *usculpt)
+{
+  Object *ob = usculpt->object;
+  if (ob == NULL || ob->sculpt == NULL || ob->sculpt->bm) {
+    return;
+  }
+  const SculptSession *ss = ob->sculpt;
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    /* Vertex data is pushed for the geometry before its modification, it is not comparable to
+     * the current state. */
+    if (unode->type == SCULPT_UNDO_GEOMETRY) {
+      return;
+    }
+  }
+
+  const int nodes_num = BLI_listbase_count(&usculpt->nodes);
+  SculptUndoNode **nodes = MEM_malloc_arrayN(nodes_num, sizeof(*nodes), __func__);
+  int totnode = 0;
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    if (STREQ(unode->idname, ob->id.name) && sculpt_undo_node_can_compact(ss, unode)) {
+      nodes[totnode++] = unode;
+    }
+  }
+
+  SculptUndoCompactData data = {
+      .ss = ss,
+      .nodes = nodes,
+  };
+  size_t freed_size = 0;
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.userdata_chunk = &freed_size;
+  settings.userdata_chunk_size = sizeof(freed_size);
+  settings.func_reduce = sculpt_undo_compact_reduce;
+  BLI_task_parallel_range(0, totnode, &data, sculpt_undo_compact_task_cb, &settings);
+
+  MEM_freeN(nodes);
+
+  if (G.debug & G_DEBUG) {
+    printf("Sculpt undo: %d nodes compacted, %zu of %zu bytes freed\n",
+           totnode,
+           freed_size,
+           usculpt->undo_size);
+  }
+
+  usculpt->undo_size -= freed_size;
+}
+
+/** \} */
+
 void SCULPT_undo_push_end_ex(const bool use_nested_undo)
 {
   UndoSculpt *usculpt = sculpt_undo_get_nodes();
@@ -1414,6 +1693,10 @@ void SCULPT_undo_push_end_ex(const bool use_nested_undo)
     }
   }
 
+  /* Only keep what the push changed, the step size is used for the undo memory limit. */
+  sculpt_undo_compact_nodes(usculpt);
+  usculpt->object = NULL;
+
   /* We could remove this and enforce all callers run in an operator using 'OPTYPE_UNDO'. */
   wmWindowManager *wm = G_MAIN->wm.first;
   if (wm->op_undo_depth == 0 || use_nested_undo) {
@@ -137,7 +137,7 @@ typedef struct ClothSimSettings {
   int preroll DNA_DEPRECATED;
   /** In percent!; if tearing enabled, a spring will get cut. */
   int maxspringlen;
-  /** Which solver should be used? txold. */
+  /** Linear solver for the implicit step, see #CLOTH_SOLVER_TYPE. */
   short solver_type;
   /** Vertex group for scaling bending stiffness. */
   short vgroup_bend;
@@ -219,6 +219,13 @@ typedef enum {
   CLOTH_BENDING_ANGULAR = 1,
 } CLOTH_BENDING_MODEL;
 
+/* ClothSimSettings.solver_type. */
+typedef enum {
+  CLOTH_SOLVER_CG = 0,
+  CLOTH_SOLVER_PARALLEL_JACOBI = 1,
+  CLOTH_SOLVER_PARALLEL_BLOCK_JACOBI = 2,
+} CLOTH_SOLVER_TYPE;
+
 typedef struct ClothCollSettings {
   /** E.g. pointer to temp memory for collisions. */
   struct LinkNode *collision_list;
@@ -247,7 +254,9 @@ typedef struct ClothCollSettings {
   short vgroup_selfcol;
   /** Vgroup to paint which vertices are not used for object collisions. */
   short vgroup_objcol;
-  char _pad2[4];
+  /** Broadphase used to find self collision candidates, see #CLOTH_SELF_BROADPHASE. */
+  short self_broadphase;
+  char _pad2[2];
   /** Impulse clamp for object collisions. */
   float clamp;
   /** Impulse clamp for self collisions. */
@@ -260,6 +269,12 @@ typedef enum {
   CLOTH_COLLSETTINGS_FLAG_SELF = (1 << 2),    /* enables selfcollisions */
 } CLOTH_COLLISIONSETTINGS_FLAGS;
 
+/* ClothCollSettings.self_broadphase. */
+typedef enum {
+  CLOTH_SELF_BROADPHASE_BVH = 0,
+  CLOTH_SELF_BROADPHASE_HASH = 1,
+} CLOTH_SELF_BROADPHASE;
+
 #ifdef __cplusplus
 }
 #endif
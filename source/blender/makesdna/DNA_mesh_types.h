@@ -103,6 +103,14 @@ typedef struct Mesh_Runtime {
   /** Non-manifold boundary data for Shrinkwrap Target Project. */
   struct ShrinkwrapBoundaryData *shrinkwrap_data;
 
+  /**
+   * Bitmap (#BLI_bitmap) of the vertices moved since vertex normals were last valid.
+   * Only meaningful while vertex normals are tagged dirty in #cd_dirty_vert,
+   * allows to only recompute the normals around moved vertices, see #BKE_mesh_ensure_normals.
+   * When null and normals are dirty, all normals have to be recomputed.
+   */
+  unsigned int *vert_normals_dirty_map;
+
   /** Set by modifier stack if only deformed from original. */
   char deformed_only;
   /**
@@ -122,7 +130,8 @@ typedef struct Mesh_Runtime {
    */
   char wrapper_type_finalize;
 
-  char _pad[4];
+  /** Number of vertices enabled in #vert_normals_dirty_map. */
+  int vert_normals_dirty_len;
 
   /** Needed in case we need to lazily initialize the mesh. */
   CustomData_MeshMasks cd_mask_extra;
@@ -163,6 +163,8 @@ enum {
 #define PTCACHE_COMPRESS_NO 0
 #define PTCACHE_COMPRESS_LZO 1
 #define PTCACHE_COMPRESS_LZMA 2
+/** LZO of the change between points, stored per byte position. */
+#define PTCACHE_COMPRESS_DELTA 3
 
 #ifdef __cplusplus
 }
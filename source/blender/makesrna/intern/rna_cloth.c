@@ -579,6 +579,22 @@ static void rna_def_cloth_sim_settings(BlenderRNA *brna)
       {0, NULL, 0, NULL, NULL},
   };
 
+  static const EnumPropertyItem prop_solver_type_items[] = {
+      {CLOTH_SOLVER_CG, "CG", 0, "Conjugate Gradient", "Single threaded conjugate gradient"},
+      {CLOTH_SOLVER_PARALLEL_JACOBI,
+       "PARALLEL_JACOBI",
+       0,
+       "Parallel Jacobi",
+       "Multi-threaded conjugate gradient with a Jacobi pre-conditioner"},
+      {CLOTH_SOLVER_PARALLEL_BLOCK_JACOBI,
+       "PARALLEL_BLOCK_JACOBI",
+       0,
+       "Parallel Block Jacobi",
+       "Multi-threaded conjugate gradient with a block Jacobi pre-conditioner, "
+       "usually converges in fewer iterations on stiff cloth"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "ClothSettings", NULL);
   RNA_def_struct_ui_text(srna, "Cloth Settings", "Cloth simulation settings for an object");
   RNA_def_struct_sdna(srna, "ClothSimSettings");
@@ -695,6 +711,14 @@ static void rna_def_cloth_sim_settings(BlenderRNA *brna)
       "Quality of the simulation in steps per frame (higher is better quality but slower)");
   RNA_def_property_update(prop, 0, "rna_cloth_update");
 
+  prop = RNA_def_property(srna, "solver_type", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, NULL, "solver_type");
+  RNA_def_property_enum_items(prop, prop_solver_type_items);
+  RNA_def_property_ui_text(
+      prop, "Solver", "Linear solver used to calculate the velocities of each step");
+  RNA_def_property_update(prop, 0, "rna_cloth_update");
+  RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
+
   prop = RNA_def_property(srna, "time_scale", PROP_FLOAT, PROP_NONE);
   RNA_def_property_float_sdna(prop, NULL, "time_scale");
   RNA_def_property_range(prop, 0.0f, FLT_MAX);
@@ -1089,6 +1113,20 @@ static void rna_def_cloth_collision_settings(BlenderRNA *brna)
   StructRNA *srna;
   PropertyRNA *prop;
 
+  static const EnumPropertyItem prop_self_broadphase_items[] = {
+      {CLOTH_SELF_BROADPHASE_BVH,
+       "BVH",
+       0,
+       "BVH",
+       "Overlap a bounding volume hierarchy of the faces with itself"},
+      {CLOTH_SELF_BROADPHASE_HASH,
+       "SPATIAL_HASH",
+       0,
+       "Spatial Hash",
+       "Hash faces into a uniform grid, faster for dense cloth with faces of similar size"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "ClothCollisionSettings", NULL);
   RNA_def_struct_ui_text(
       srna,
@@ -1166,6 +1204,14 @@ static void rna_def_cloth_collision_settings(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Self Friction", "Friction with self contact");
   RNA_def_property_update(prop, 0, "rna_cloth_update");
 
+  prop = RNA_def_property(srna, "self_collision_broadphase", PROP_ENUM, PROP_NONE);
+  RNA_def_property_enum_sdna(prop, NULL, "self_broadphase");
+  RNA_def_property_enum_items(prop, prop_self_broadphase_items);
+  RNA_def_property_ui_text(
+      prop, "Self Collision Broadphase", "Method to find faces that may collide with each other");
+  RNA_def_property_update(prop, 0, "rna_cloth_update");
+  RNA_def_property_clear_flag(prop, PROP_ANIMATABLE);
+
   prop = RNA_def_property(srna, "collection", PROP_POINTER, PROP_NONE);
   RNA_def_property_pointer_sdna(prop, NULL, "group");
   RNA_def_property_flag(prop, PROP_EDITABLE);
@@ -946,6 +946,11 @@ static void rna_def_pointcache_common(StructRNA *srna)
       {PTCACHE_COMPRESS_NO, "NO", 0, "None", "No compression"},
       {PTCACHE_COMPRESS_LZO, "LIGHT", 0, "Lite", "Fast but not so effective compression"},
       {PTCACHE_COMPRESS_LZMA, "HEAVY", 0, "Heavy", "Effective but slow compression"},
+      {PTCACHE_COMPRESS_DELTA,
+       "DELTA",
+       0,
+       "Delta",
+       "Fast compression of the change between points, effective for large caches"},
       {0, NULL, 0, NULL, NULL},
   };
 
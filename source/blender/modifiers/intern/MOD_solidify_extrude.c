@@ -395,28 +395,33 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
   }
   else {
     int i, j;
+    int *src_indices = MEM_malloc_arrayN(
+        MAX2(numVerts, numEdges), sizeof(*src_indices), "solid_mod src_indices");
+
     CustomData_copy_data(&mesh->vdata, &result->vdata, 0, 0, (int)numVerts);
-    for (i = 0, j = (int)numVerts; i < numVerts; i++) {
+    for (i = 0, j = 0; i < numVerts; i++) {
       if (old_vert_arr[i] != INVALID_UNUSED) {
-        CustomData_copy_data(&mesh->vdata, &result->vdata, i, j, 1);
-        j++;
+        src_indices[j++] = i;
       }
     }
+    CustomData_copy_data_indices(&mesh->vdata, &result->vdata, src_indices, (int)numVerts, j);
 
     CustomData_copy_data(&mesh->edata, &result->edata, 0, 0, (int)numEdges);
-
-    for (i = 0, j = (int)numEdges; i < numEdges; i++) {
+    for (i = 0, j = 0; i < numEdges; i++) {
       if (!ELEM(edge_users[i], INVALID_UNUSED, INVALID_PAIR)) {
-        MEdge *ed_src, *ed_dst;
-        CustomData_copy_data(&mesh->edata, &result->edata, i, j, 1);
-
-        ed_src = &medge[i];
-        ed_dst = &medge[j];
-        ed_dst->v1 = old_vert_arr[ed_src->v1] + numVerts;
-        ed_dst->v2 = old_vert_arr[ed_src->v2] + numVerts;
-        j++;
+        src_indices[j++] = i;
       }
     }
+    CustomData_copy_data_indices(&mesh->edata, &result->edata, src_indices, (int)numEdges, j);
+
+    for (i = 0; i < j; i++) {
+      const MEdge *ed_src = &medge[src_indices[i]];
+      MEdge *ed_dst = &medge[numEdges + (uint)i];
+      ed_dst->v1 = old_vert_arr[ed_src->v1] + numVerts;
+      ed_dst->v2 = old_vert_arr[ed_src->v2] + numVerts;
+    }
+
+    MEM_freeN(src_indices);
 
     /* will be created later */
     CustomData_copy_data(&mesh->ldata, &result->ldata, 0, 0, (int)numLoops);
@@ -448,6 +453,25 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
   if (do_shell) {
     uint i;
 
+    /* reverses the loop direction of the custom-data,
+     * keeping the first vertex the same for the copy,
+     * ensures the diagonals in the new face match the original. */
+    {
+      int *loop_src_indices = MEM_malloc_arrayN(
+          numLoops, sizeof(*loop_src_indices), "solid_mod loop_src_indices");
+      mp = mpoly + numPolys;
+      for (i = 0; i < numPolys; i++, mp++) {
+        int *src_indices = &loop_src_indices[mp->loopstart];
+        src_indices[0] = mp->loopstart;
+        for (int j = 1; j < mp->totloop; j++) {
+          src_indices[mp->totloop - j] = mp->loopstart + j;
+        }
+      }
+      CustomData_copy_data_indices(
+          &mesh->ldata, &result->ldata, loop_src_indices, (int)numLoops, (int)numLoops);
+      MEM_freeN(loop_src_indices);
+    }
+
     mp = mpoly + numPolys;
     for (i = 0; i < mesh->totpoly; i++, mp++) {
       const int loop_end = mp->totloop - 1;
@@ -455,29 +479,9 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
       uint e;
       int j;
 
-      /* reverses the loop direction (MLoop.v as well as custom-data)
+      /* the loop direction (MLoop.v as well as custom-data) is reversed above,
        * MLoop.e also needs to be corrected too, done in a separate loop below. */
       ml2 = mloop + mp->loopstart + mesh->totloop;
-#if 0
-      for (j = 0; j < mp->totloop; j++) {
-        CustomData_copy_data(&mesh->ldata,
-                             &result->ldata,
-                             mp->loopstart + j,
-                             mp->loopstart + (loop_end - j) + mesh->totloop,
-                             1);
-      }
-#else
-      /* slightly more involved, keep the first vertex the same for the copy,
-       * ensures the diagonals in the new face match the original. */
-      j = 0;
-      for (int j_prev = loop_end; j < mp->totloop; j_prev = j++) {
-        CustomData_copy_data(&mesh->ldata,
-                             &result->ldata,
-                             mp->loopstart + j,
-                             mp->loopstart + (loop_end - j_prev) + mesh->totloop,
-                             1);
-      }
-#endif
 
       if (mat_ofs) {
         mp->mat_nr += mat_ofs;
@@ -983,7 +987,7 @@ Mesh *MOD_solidify_extrude_modifyMesh(ModifierData *md, const ModifierEvalContex
 
   /* must recalculate normals with vgroups since they can displace unevenly T26888. */
   if ((mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL) || do_rim || dvert) {
-    result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+    BKE_mesh_normals_tag_dirty(result);
   }
   else if (do_shell) {
     uint i;
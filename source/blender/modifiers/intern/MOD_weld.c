@@ -1977,7 +1977,7 @@ static Mesh *weldModifier_doWeld(WeldModifierData *wmd,
 
     /* is this needed? */
     /* recalculate normals */
-    result->runtime.cd_dirty_vert |= CD_MASK_NORMAL;
+    BKE_mesh_normals_tag_dirty(result);
 
     weld_mesh_context_free(&weld_mesh);
   }
@@ -1311,6 +1311,8 @@ int SIM_cloth_solve(
     zero_v3(cloth->average_acceleration);
   }
 
+  SIM_mass_spring_set_solver_type(id, clmd->sim_parms->solver_type);
+
   while (step < tf) {
     ImplicitSolverResult result;
 
@@ -100,6 +100,8 @@ void SIM_mass_spring_add_constraint_ndof2(struct Implicit_Data *data,
                                           const float c1[3],
                                           const float dV[3]);
 
+/* Linear solver used by #SIM_mass_spring_solve_velocities, see #CLOTH_SOLVER_TYPE. */
+void SIM_mass_spring_set_solver_type(struct Implicit_Data *data, int solver_type);
 bool SIM_mass_spring_solve_velocities(struct Implicit_Data *data,
                                       float dt,
                                       struct ImplicitSolverResult *result);
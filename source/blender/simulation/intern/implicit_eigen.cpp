@@ -511,6 +511,11 @@ BLI_INLINE void root_to_world_m3(Implicit_Data *data, int index, float r[3][3],
 
 /* ================================ */
 
+void SIM_mass_spring_set_solver_type(Implicit_Data *UNUSED(data), int UNUSED(solver_type))
+{
+  /* Only the Eigen conjugate gradient solver is supported. */
+}
+
 bool SIM_mass_spring_solve_velocities(Implicit_Data *data, float dt, ImplicitSolverResult *result)
 {
 #  ifdef USE_EIGEN_CORE
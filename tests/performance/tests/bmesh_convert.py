@@ -0,0 +1,77 @@
+# Apache License, Version 2.0
+
+# Mesh to BMesh conversion.
+#
+# Times the conversion of a generated grid with a number of attribute layers, through the bmesh
+# module and through toggling edit mode, which converts in both directions.
+
+import api
+
+
+def _run(args):
+    import bmesh
+    import bpy
+    import time
+
+    bpy.ops.object.select_all(action='DESELECT')
+    subdivisions = args['subdivisions']
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=subdivisions, y_subdivisions=subdivisions)
+    ob = bpy.context.view_layer.objects.active
+    me = ob.data
+
+    # Layers of every domain, so custom-data copying is part of the timing.
+    for i in range(args['num_layers']):
+        me.uv_layers.new(name=f"UV{i}")
+        me.vertex_colors.new(name=f"Col{i}")
+        me.attributes.new(f"vert_float{i}", 'FLOAT', 'POINT')
+        me.attributes.new(f"edge_float{i}", 'FLOAT', 'EDGE')
+        me.attributes.new(f"face_int{i}", 'INT', 'FACE')
+
+    result = {'num_polys': len(me.polygons)}
+
+    bm = bmesh.new()
+    start_time = time.time()
+    bm.from_mesh(me)
+    result['from_mesh_time'] = time.time() - start_time
+
+    start_time = time.time()
+    bm.to_mesh(me)
+    result['to_mesh_time'] = time.time() - start_time
+    bm.free()
+
+    start_time = time.time()
+    bpy.ops.object.mode_set(mode='EDIT')
+    bpy.ops.object.mode_set(mode='OBJECT')
+    result['edit_mode_toggle_time'] = time.time() - start_time
+
+    result['time'] = (result['from_mesh_time'] + result['to_mesh_time'] +
+                      result['edit_mode_toggle_time'])
+    return result
+
+
+class BMeshConvertTest(api.Test):
+    def __init__(self, subdivisions, num_layers):
+        self.subdivisions = subdivisions
+        self.num_layers = num_layers
+
+    def name(self):
+        return f'grid_{self.subdivisions}_layers_{self.num_layers}'
+
+    def category(self):
+        return "bmesh_convert"
+
+    def run(self, env, device_id):
+        args = {
+            'subdivisions': self.subdivisions,
+            'num_layers': self.num_layers,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    return [
+        BMeshConvertTest(1000, 0),
+        BMeshConvertTest(1000, 4),
+        BMeshConvertTest(2000, 1),
+    ]
@@ -0,0 +1,83 @@
+# Apache License, Version 2.0
+
+# BMesh tools through their modifiers.
+#
+# Times the evaluation of Bevel and Decimate modifiers on generated dense meshes: a regular sphere
+# and a subdivided monkey with irregular topology.
+
+import api
+
+_MESHES = ('sphere', 'monkey')
+
+
+def _run(args):
+    import bpy
+    import time
+
+    bpy.ops.object.select_all(action='DESELECT')
+    if args['mesh'] == 'sphere':
+        bpy.ops.mesh.primitive_uv_sphere_add(segments=args['segments'],
+                                             ring_count=args['segments'] // 2)
+    else:
+        bpy.ops.mesh.primitive_monkey_add()
+        md = bpy.context.view_layer.objects.active.modifiers.new("Subdivision", 'SUBSURF')
+        md.levels = args['subdivision_levels']
+        bpy.ops.object.modifier_apply(modifier=md.name)
+
+    ob = bpy.context.view_layer.objects.active
+    md = ob.modifiers.new("Benchmark", args['modifier'])
+    if args['modifier'] == 'BEVEL':
+        md.affect = args['affect']
+        md.width = 0.001
+        md.segments = 3
+        md.use_clamp_overlap = True
+    elif args['modifier'] == 'DECIMATE':
+        md.decimate_type = 'COLLAPSE'
+        md.ratio = 0.25
+
+    # Modifiers are evaluated by the dependency graph update.
+    start_time = time.time()
+    depsgraph = bpy.context.evaluated_depsgraph_get()
+    ob_eval = ob.evaluated_get(depsgraph)
+    me_eval = ob_eval.to_mesh()
+    result = {
+        'time': time.time() - start_time,
+        'num_polys': len(me_eval.polygons),
+    }
+    ob_eval.to_mesh_clear()
+    return result
+
+
+class BMeshToolsTest(api.Test):
+    def __init__(self, mesh, modifier, affect='EDGES'):
+        self.mesh = mesh
+        self.modifier = modifier
+        self.affect = affect
+
+    def name(self):
+        if self.modifier == 'BEVEL':
+            return f'{self.mesh}_bevel_{self.affect.lower()}'
+        return f'{self.mesh}_{self.modifier.lower()}'
+
+    def category(self):
+        return "bmesh_tools"
+
+    def run(self, env, device_id):
+        args = {
+            'mesh': self.mesh,
+            'segments': 1024,
+            'subdivision_levels': 5,
+            'modifier': self.modifier,
+            'affect': self.affect,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    tests = []
+    for mesh in _MESHES:
+        tests.append(BMeshToolsTest(mesh, 'BEVEL'))
+        tests.append(BMeshToolsTest(mesh, 'BEVEL', 'VERTICES'))
+        tests.append(BMeshToolsTest(mesh, 'DECIMATE'))
+    return tests
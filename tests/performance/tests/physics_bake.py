@@ -0,0 +1,69 @@
+# Apache License, Version 2.0
+
+# Baking all physics caches.
+#
+# Times baking a generated scene of independent cloth grids, each falling onto its own plane, with
+# all caches baked serially and with independent caches baked concurrently. Every cloth only
+# collides with the plane in its own collection, colliders shared by several cloths would put them
+# in the same concurrently baked group.
+
+import api
+
+_CONCURRENT_BAKES = (1, 0)
+
+
+def _run(args):
+    import bpy
+    import time
+
+    bpy.ops.object.select_all(action='DESELECT')
+    for i in range(args['num_objects']):
+        collection = bpy.data.collections.new(f"Collider {i}")
+        bpy.context.scene.collection.children.link(collection)
+
+        location = (i * 3.0, 0.0, 0.0)
+        bpy.ops.mesh.primitive_plane_add(size=2.5, location=location)
+        bpy.ops.object.modifier_add(type='COLLISION')
+        plane = bpy.context.view_layer.objects.active
+        for users_collection in list(plane.users_collection):
+            users_collection.objects.unlink(plane)
+        collection.objects.link(plane)
+
+        subdivisions = args['subdivisions']
+        bpy.ops.mesh.primitive_grid_add(x_subdivisions=subdivisions,
+                                        y_subdivisions=subdivisions,
+                                        location=(location[0], 0.0, 1.0))
+        bpy.ops.object.modifier_add(type='CLOTH')
+        md = bpy.context.view_layer.objects.active.modifiers[-1]
+        md.point_cache.frame_end = args['num_frames']
+        md.collision_settings.collection = collection
+
+    start_time = time.time()
+    bpy.ops.ptcache.bake_all(bake=True, concurrent_bakes=args['concurrent_bakes'])
+    return {'time': time.time() - start_time}
+
+
+class PhysicsBakeTest(api.Test):
+    def __init__(self, concurrent_bakes):
+        self.concurrent_bakes = concurrent_bakes
+
+    def name(self):
+        concurrent = self.concurrent_bakes if self.concurrent_bakes else 'all'
+        return f'cloth_grids_concurrent_{concurrent}'
+
+    def category(self):
+        return "physics_bake"
+
+    def run(self, env, device_id):
+        args = {
+            'num_objects': 8,
+            'subdivisions': 32,
+            'num_frames': 50,
+            'concurrent_bakes': self.concurrent_bakes,
+        }
+        result, _ = env.run_in_blender(_run, args)
+        return result
+
+
+def generate(env):
+    return [PhysicsBakeTest(concurrent_bakes) for concurrent_bakes in _CONCURRENT_BAKES]
@@ -0,0 +1,167 @@
+# Apache License, Version 2.0
+
+# Sculpt stroke replay.
+#
+# Strokes are replayed with the exec of the sculpt brush stroke operator, the time of every dab
+# is read from the "ed.paint.stroke" log.
+#
+# Strokes can be recorded in the UI by running Blender with:
+#
+#   blender --log "ed.paint.stroke" --log-level 2 --log-file sculpt/<name>.stroke <name>.blend
+#
+# A `.stroke` file next to a `.blend` file in the `sculpt` benchmarks directory is replayed on the
+# active object of that file. Without benchmark files a generated stroke across the front of a
+# sphere is used.
+
+import api
+import json
+import math
+import re
+
+_MODES = ('brush', 'dyntopo', 'multires')
+
+
+def _read_stroke(filepath):
+    # Samples of the last recorded stroke in the log file.
+    stroke = []
+    with open(filepath) as f:
+        for line in f:
+            index = line.find('sample {')
+            if index == -1:
+                continue
+            sample = json.loads(line[index + len('sample '):])
+            if sample['is_start'] and stroke:
+                stroke = []
+            stroke.append(sample)
+    return stroke
+
+
+def _run(args):
+    import bpy
+    from bpy_extras import view3d_utils
+    from mathutils import Vector
+
+    if args['filepath']:
+        bpy.ops.wm.open_mainfile(filepath=args['filepath'])
+    else:
+        bpy.ops.object.select_all(action='DESELECT')
+        bpy.ops.mesh.primitive_uv_sphere_add(segments=512, ring_count=256, radius=1.0)
+
+    # The stroke operator projects the brush with the 3D view of the screen, the view itself is not
+    # used to generate the stroke.
+    screen = bpy.context.screen
+    area = next(area for area in screen.areas if area.type == 'VIEW_3D')
+    region = next(region for region in area.regions if region.type == 'WINDOW')
+    override = {
+        'window': bpy.context.window,
+        'screen': screen,
+        'area': area,
+        'region': region,
+        'scene': bpy.context.scene,
+        'view_layer': bpy.context.view_layer,
+    }
+
+    ob = bpy.context.view_layer.objects.active
+    mode = args['mode']
+    if mode == 'multires':
+        ob.modifiers.new("Multires", 'MULTIRES')
+        for _ in range(args['multires_levels']):
+            bpy.ops.object.multires_subdivide(override, modifier="Multires", mode='CATMULL_CLARK')
+
+    bpy.ops.object.mode_set(override, mode='SCULPT')
+    sculpt = bpy.context.tool_settings.sculpt
+    if mode == 'dyntopo':
+        bpy.ops.sculpt.dynamic_topology_toggle(override)
+        # Fill both the long and the short edge queue on every dab, at a detail finer than the
+        # generated sphere so that edges are split.
+        sculpt.detail_refine_method = 'SUBDIVIDE_COLLAPSE'
+        sculpt.detail_type_method = 'CONSTANT'
+        sculpt.constant_detail_resolution = args['dyntopo_resolution']
+
+    sculpt.brush = next(brush for brush in bpy.data.brushes
+                        if brush.use_paint_sculpt and brush.sculpt_tool == args['brush'])
+
+    stroke = args['stroke']
+    if not stroke:
+        # Arc across the front of the generated unit sphere, as seen from the view. Locations are
+        # explicit, mouse positions are their projection into the view.
+        rv3d = area.spaces.active.region_3d
+        right = rv3d.view_rotation @ Vector((1.0, 0.0, 0.0))
+        front = rv3d.view_rotation @ Vector((0.0, 0.0, 1.0))
+        num_samples = 64
+        for i in range(num_samples):
+            x = -0.6 + 1.2 * i / (num_samples - 1)
+            location = ob.matrix_world @ (right * x + front * math.sqrt(1.0 - x * x))
+            mouse = view3d_utils.location_3d_to_region_2d(region, rv3d, location)
+            stroke.append({
+                "location": location[:],
+                "mouse": mouse[:],
+                "mouse_event": mouse[:],
+                "size": 50.0,
+                "pressure": 1.0,
+                "pen_flip": False,
+                "x_tilt": 0.0,
+                "y_tilt": 0.0,
+                "time": float(i),
+                "is_start": i == 0,
+            })
+
+    bpy.ops.sculpt.brush_stroke(override, stroke=stroke, mode='NORMAL')
+
+    return {'num_samples': len(stroke)}
+
+
+class SculptTest(api.Test):
+    def __init__(self, filepath, mode, brush='DRAW'):
+        self.filepath = filepath
+        self.mode = mode
+        self.brush = brush
+
+    def name(self):
+        name = self.filepath.stem if self.filepath else 'sphere'
+        return f'{name}_{self.mode}_{self.brush.lower()}'
+
+    def category(self):
+        return "sculpt"
+
+    def run(self, env, device_id):
+        stroke = []
+        if self.filepath:
+            stroke = _read_stroke(self.filepath.with_suffix('.stroke'))
+
+        args = {
+            'filepath': str(self.filepath) if self.filepath else '',
+            'mode': self.mode,
+            'brush': self.brush,
+            'stroke': stroke,
+            'multires_levels': 3,
+            'dyntopo_resolution': 200.0,
+        }
+        blender_args = ['--log', 'ed.paint.stroke', '--log-level', '1']
+        result, lines = env.run_in_blender(_run, args, blender_args)
+
+        # Per dab timings from the log.
+        dab_times = []
+        for line in lines:
+            match = re.search(r'dab [0-9]+: ([0-9.]+) s', line)
+            if match:
+                dab_times.append(float(match.group(1)))
+
+        if not dab_times:
+            return {}
+
+        result['time'] = sum(dab_times)
+        result['dab_time_max'] = max(dab_times)
+        result['dab_time_average'] = sum(dab_times) / len(dab_times)
+        return result
+
+
+def generate(env):
+    tests = []
+    for mode in _MODES:
+        tests.append(SculptTest(None, mode))
+        tests.append(SculptTest(None, mode, 'CLAY_STRIPS'))
+    for filepath in env.find_blend_files('sculpt'):
+        if filepath.with_suffix('.stroke').exists():
+            tests.append(SculptTest(filepath, 'brush'))
+    return tests
@@ -0,0 +1,70 @@
+# Apache License, Version 2.0
+
+# Soft body simulation.
+#
+# Times the simulation of a generated dense grid falling onto a plane, with edges and self
+# collision, using a different number of threads to show how force evaluation scales.
+
+import api
+
+_THREADS = (1, 4, 0)
+
+
+def _run(args):
+    import bpy
+    import time
+
+    bpy.ops.object.select_all(action='DESELECT')
+    bpy.ops.mesh.primitive_plane_add(size=4.0)
+    bpy.ops.object.modifier_add(type='COLLISION')
+
+    subdivisions = args['subdivisions']
+    bpy.ops.mesh.primitive_grid_add(x_subdivisions=subdivisions,
+                                    y_subdivisions=subdivisions,
+                                    location=(0.0, 0.0, 1.0))
+    bpy.ops.object.modifier_add(type='SOFT_BODY')
+    ob = bpy.context.view_layer.objects.active
+    settings = ob.modifiers[-1].settings
+    settings.use_goal = False
+    settings.use_edges = True
+    settings.use_self_collision = True
+    settings.use_edge_collision = True
+
+    scene = bpy.context.scene
+    num_frames = args['num_frames']
+
+    start_time = time.time()
+    for frame in range(scene.frame_start, scene.frame_start + num_frames):
+        scene.frame_set(frame)
+    elapsed_time = time.time() - start_time
+
+    return {
+        'time': elapsed_time,
+        'frame_time_average': elapsed_time / num_frames,
+        'num_points': len(ob.data.vertices),
+    }
+
+
+class SoftbodyTest(api.Test):
+    def __init__(self, threads):
+        self.threads = threads
+
+    def name(self):
+        threads = self.threads if self.threads else 'all'
+        return f'grid_threads_{threads}'
+
+    def category(self):
+        return "softbody"
+
+    def run(self, env, device_id):
+        args = {
+            'subdivisions': 64,
+            'num_frames': 25,
+        }
+        blender_args = ['--threads', str(self.threads)]
+        result, _ = env.run_in_blender(_run, args, blender_args)
+        return result
+
+
+def generate(env):
+    return [SoftbodyTest(threads) for threads in _THREADS]
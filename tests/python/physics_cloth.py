@@ -19,6 +19,7 @@
 # <pep8 compliant>
 
 import os
+import subprocess
 import sys
 
 import bpy
@@ -27,12 +28,75 @@ sys.path.append(os.path.dirname(os.path.realpath(__file__)))
 from modules.mesh_test import RunTest, ModifierSpec, MeshTest
 
 
+# Simulates a grid pinned at one side in a separate Blender with the given number of threads, and
+# prints the exact coordinates of the result. The grid has several solver chunks of vertices, so
+# the solver actually runs in parallel.
+THREAD_COUNT_SCRIPT = '''
+import bpy
+bpy.ops.mesh.primitive_grid_add(x_subdivisions=80, y_subdivisions=80, size=2.0)
+ob = bpy.context.view_layer.objects.active
+group = ob.vertex_groups.new(name="Pin")
+group.add([v.index for v in ob.data.vertices if v.co.x < -0.99], 1.0, 'REPLACE')
+md = ob.modifiers.new("Cloth", 'CLOTH')
+md.settings.quality = 5
+md.settings.solver_type = "{solver_type}"
+md.settings.vertex_group_mass = "Pin"
+scene = bpy.context.scene
+for frame in range(scene.frame_start, scene.frame_start + 15):
+    scene.frame_set(frame)
+mesh = ob.evaluated_get(bpy.context.evaluated_depsgraph_get()).data
+print("COORDS", " ".join(co.hex() for v in mesh.vertices for co in v.co))
+'''
+
+
+def simulate_with_threads(solver_type, threads):
+    command = [
+        bpy.app.binary_path,
+        "--background",
+        "--factory-startup",
+        "--threads", str(threads),
+        "--python-expr", THREAD_COUNT_SCRIPT.format(solver_type=solver_type),
+    ]
+    output = subprocess.check_output(command, universal_newlines=True)
+    for line in output.splitlines():
+        if line.startswith("COORDS "):
+            return line
+    raise Exception("No coordinates in the output of: " + " ".join(command))
+
+
+def run_thread_count_tests():
+    # Parallel solvers sum in a fixed order, so the result must not depend on the number of threads.
+    failed = []
+    for solver_type in ('PARALLEL_JACOBI', 'PARALLEL_BLOCK_JACOBI'):
+        results = {threads: simulate_with_threads(solver_type, threads) for threads in (1, 2, 4)}
+        if len(set(results.values())) != 1:
+            failed.append(solver_type)
+            print("FAILED: {} gives different results for thread counts".format(solver_type))
+        else:
+            print("Success: {} gives the same result for thread counts".format(solver_type))
+    if failed:
+        raise Exception("Thread count tests failed: {}".format(", ".join(failed)))
+
+
 def main():
     test = [
 
         MeshTest("ClothSimple", "testClothPlane", "expectedClothPlane",
                  [ModifierSpec('Cloth', 'CLOTH', {'settings': {'quality': 5}}, 15)], threshold=1e-3),
 
+        # Parallel solvers, compared to the result of the single threaded solver. All solvers stop
+        # at a residual of 1% of the right hand side, the pre-conditioned iterations stop at a
+        # different approximation of the solution than the existing solver and the difference
+        # accumulates over the steps, so the threshold is larger. Results are exact across thread
+        # counts, see `run_thread_count_tests`.
+        MeshTest("ClothSimpleParallelJacobi", "testClothPlane", "expectedClothPlane",
+                 [ModifierSpec('Cloth', 'CLOTH', {'settings': {'quality': 5, 'solver_type': 'PARALLEL_JACOBI'}},
+                               15)], threshold=1e-2),
+
+        MeshTest("ClothSimpleParallelBlockJacobi", "testClothPlane", "expectedClothPlane",
+                 [ModifierSpec('Cloth', 'CLOTH', {'settings': {'quality': 5, 'solver_type': 'PARALLEL_BLOCK_JACOBI'}},
+                               15)], threshold=1e-2),
+
         # Not reproducible
         # MeshTest("ClothPressure", "testObjClothPressure", "expObjClothPressure",
         #           [ModifierSpec('Cloth2', 'CLOTH', {'settings': {'use_pressure': True,
@@ -54,6 +118,7 @@ def main():
             cloth_test.apply_modifiers = True
             cloth_test.do_compare = True
             cloth_test.run_all_tests()
+            run_thread_count_tests()
             break
         elif cmd == "--run-test":
             cloth_test.apply_modifiers = False